@@ -3,16 +3,16 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "ItkBinaryWatershedLabeled.h"
 
-//thresholding filter
-#include "itkSignedMaurerDistanceMapImageFilter.h"
-#include "itkInvertIntensityImageFilter.h"
-#include "itkMorphologicalWatershedFromMarkersImageFilter.h"
-#include "itkMaskImageFilter.h"
-#include "itkBinaryThresholdImageFilter.h"
+#include <algorithm>
+#include <vector>
+
+#include <QtCore/QStringList>
 
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/FloatFilterParameter.h"
+#include "SIMPLib/FilterParameters/IntFilterParameter.h"
+#include "SIMPLib/FilterParameters/LinkedBooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/LinkedPathCreationFilterParameter.h"
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
@@ -54,6 +54,14 @@ void ItkBinaryWatershedLabeled::setupFilterParameters()
     parameters.push_back(SIMPL_NEW_DA_SELECTION_FP("Attribute Array to Watershed", SelectedCellArrayPath, FilterParameter::Category::RequiredArray, ItkBinaryWatershedLabeled, req));
   }
   parameters.push_back(SIMPL_NEW_FLOAT_FP("Peak Noise Tolerance", PeakTolerance, FilterParameter::Category::Parameter, ItkBinaryWatershedLabeled));
+  {
+    QStringList linkedProps;
+    linkedProps << "BlockSize"
+                << "BlockHalo";
+    parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Process in Parallel Blocks", UseBlocks, FilterParameter::Category::Parameter, ItkBinaryWatershedLabeled, linkedProps));
+  }
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Block Size (Voxels)", BlockSize, FilterParameter::Category::Parameter, ItkBinaryWatershedLabeled));
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Block Halo (Voxels)", BlockHalo, FilterParameter::Category::Parameter, ItkBinaryWatershedLabeled));
   parameters.push_back(SeparatorFilterParameter::Create("Cell Data", FilterParameter::Category::CreatedArray));
   parameters.push_back(
       SIMPL_NEW_DA_WITH_LINKED_AM_FP("Watershed Array", NewCellArrayName, SelectedCellArrayPath, SelectedCellArrayPath, FilterParameter::Category::CreatedArray, ItkBinaryWatershedLabeled));
@@ -69,6 +77,9 @@ void ItkBinaryWatershedLabeled::readFilterParameters(AbstractFilterParametersRea
   setSelectedCellArrayPath( reader->readDataArrayPath( "SelectedCellArrayPath", getSelectedCellArrayPath() ) );
   setPeakTolerance( reader->readValue( "PeakTolerance", getPeakTolerance() ) );
   setNewCellArrayName( reader->readString( "NewCellArrayName", getNewCellArrayName() ) );
+  setUseBlocks( reader->readValue( "UseBlocks", getUseBlocks() ) );
+  setBlockSize( reader->readValue( "BlockSize", getBlockSize() ) );
+  setBlockHalo( reader->readValue( "BlockHalo", getBlockHalo() ) );
   reader->closeFilterGroup();
 }
 
@@ -103,6 +114,13 @@ void ItkBinaryWatershedLabeled::dataCheck()
     return;
   }
 
+  if(m_UseBlocks && (m_BlockSize < 1 || m_BlockHalo < 0))
+  {
+    QString ss = QObject::tr("The block size must be positive and the block halo can't be negative");
+    setErrorCondition(-5563, ss);
+    return;
+  }
+
   tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getSelectedCellArrayPath().getAttributeMatrixName(), getNewCellArrayName() );
   m_NewCellArrayPtr =
       getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<uint32_t>>(this, tempPath, 0, dims, "", DataArrayID31);
@@ -127,83 +145,67 @@ void ItkBinaryWatershedLabeled::execute()
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getSelectedCellArrayPath().getDataContainerName());
   QString attrMatName = getSelectedCellArrayPath().getAttributeMatrixName();
 
-  //get utilities
-  typedef ItkBridge<bool> BoolBridgeType;
-  typedef ItkBridge<float> FloatBridgeType;
-  typedef ItkBridge<uint32_t> LabelBridgeType;
-
-  //wrap input
-  BoolBridgeType::ScalarImageType::Pointer inputImage = BoolBridgeType::CreateItkWrapperForDataPointer(m, attrMatName, m_SelectedCellArray);
+  ImageGeom::Pointer image = m->getGeometryAs<ImageGeom>();
+  SizeVec3Type udims = image->getDimensions();
+  FloatVec3Type res = image->getSpacing();
+  const size_t dims[3] = {udims[0], udims[1], udims[2]};
+  const float spacing[3] = {res[0], res[1], res[2]};
+  const size_t totalPoints = m_SelectedCellArrayPtr.lock()->getNumberOfTuples();
 
-  //compute distance map
-  typedef itk::SignedMaurerDistanceMapImageFilter<BoolBridgeType::ScalarImageType, FloatBridgeType::ScalarImageType> DistanceMapType;
-  DistanceMapType::Pointer distanceMap = DistanceMapType::New();
-  distanceMap->SetInsideIsPositive(true);
-  distanceMap->SetInput(inputImage);
-  try
+  ImageProcessing::BinaryWatershed watershed(m_SelectedCellArray, dims, spacing);
+  if(m_UseBlocks)
   {
-    distanceMap->Update();
+    notifyStatusMessage("Watershedding Blocks");
+    try
+    {
+      watershed.floodBlocks(m_PeakTolerance, static_cast<size_t>(m_BlockSize), static_cast<size_t>(m_BlockHalo), m_NewCellArray);
+    }
+    catch( itk::ExceptionObject& err )
+    {
+      QString ss = QObject::tr("Failed to find distance map maxima. Error Message returned from ITK:\n   %1").arg(err.GetDescription());
+      setErrorCondition(-5, ss);
+    }
+    return;
   }
-  catch( itk::ExceptionObject& err )
+
+  //compute distance map (the only buffer besides the output)
+  notifyStatusMessage("Calculating Distance Map");
+  std::vector<float> distance(totalPoints);
+  watershed.distanceMap(distance.data());
+  if(getCancel())
   {
-    QString ss = QObject::tr("Failed to execute itk::KMeans filter. Error Message returned from ITK:\n   %1").arg(err.GetDescription());
-    setErrorCondition(-5, ss);
+    return;
   }
 
   //find maxima in distance map (ultimate points)
-  std::vector<FloatBridgeType::ScalarImageType::IndexType> peakLocations = ImageProcessing::LocalMaxima<FloatBridgeType::ScalarImageType>::Find(distanceMap->GetOutput(), m_PeakTolerance, true);
-
-  //create labeled image from peaks
-  typedef itk::Image<uint32_t, FloatBridgeType::ScalarImageType::ImageDimension> LabelImageType;
-  LabelImageType::Pointer seedLabels = LabelImageType::New();
-  LabelImageType::RegionType region = inputImage->GetLargestPossibleRegion();
-  seedLabels->SetRegions(region);
-  seedLabels->Allocate();
-  seedLabels->FillBuffer(0);
-  for(size_t i = 0; i < peakLocations.size(); i++)
-  {
-    seedLabels->SetPixel(peakLocations[i], i + 1);
-  }
-  seedLabels->CopyInformation(inputImage);
-
-  //invert distance map as gradient for watershed
-  typedef itk::InvertIntensityImageFilter< FloatBridgeType::ScalarImageType, FloatBridgeType::ScalarImageType > InvertType;
-  InvertType::Pointer invert = InvertType::New();
-  invert->SetInput(distanceMap->GetOutput());
-  invert->SetMaximum(0);
-
-  //set up seeded watershed
-  typedef itk::MorphologicalWatershedFromMarkersImageFilter< FloatBridgeType::ScalarImageType, LabelImageType > WatershedType;
-  WatershedType::Pointer watershed = WatershedType::New();
-  watershed->SetInput1(invert->GetOutput());
-  watershed->SetInput2(seedLabels);
-  watershed->SetMarkWatershedLine(false);
-
-  //mask watershed output (we only want things that were originally in the)
-  typedef itk::MaskImageFilter<LabelImageType, BoolBridgeType::ScalarImageType, LabelBridgeType::ScalarImageType> MaskType;
-  MaskType::Pointer mask = MaskType::New();
-  mask->SetInput(watershed->GetOutput());
-  mask->SetMaskImage(inputImage);
-
-//  //threshold all labels into boolean array
-//  typedef itk::BinaryThresholdImageFilter< LabelImageType, BoolBridgeType::ScalarImageType > ThresholdType;
-//  ThresholdType::Pointer threshold = ThresholdType::New();
-//  threshold->SetInput(mask->GetOutput());
-//  threshold->SetLowerThreshold(1);
-//  threshold->SetInsideValue(true);
-//  threshold->SetOutsideValue(false);
-
-  //wrap output
-  LabelBridgeType::SetITKFilterOutput(mask->GetOutput(), m_NewCellArrayPtr.lock());
+  typedef ItkBridge<float> FloatBridgeType;
+  typedef FloatBridgeType::ScalarImageType::IndexType IndexType;
+  std::vector<IndexType> peakLocations;
   try
   {
-    mask->Update();
+    FloatBridgeType::ScalarImageType::Pointer distanceImage = FloatBridgeType::CreateItkWrapperForDataPointer(m, attrMatName, distance.data());
+    peakLocations = ImageProcessing::LocalMaxima<FloatBridgeType::ScalarImageType>::Find(distanceImage, m_PeakTolerance, true);
   }
   catch( itk::ExceptionObject& err )
   {
-    QString ss = QObject::tr("Failed to execute itk::KMeans filter. Error Message returned from ITK:\n   %1").arg(err.GetDescription());
+    QString ss = QObject::tr("Failed to find distance map maxima. Error Message returned from ITK:\n   %1").arg(err.GetDescription());
     setErrorCondition(-5, ss);
+    return;
+  }
+
+  //write seeds straight into the output and flood from them
+  notifyStatusMessage("Watershedding");
+  std::fill(m_NewCellArray, m_NewCellArray + totalPoints, 0);
+  for(size_t i = 0; i < peakLocations.size(); i++)
+  {
+    size_t index = 0;
+    for(int d = static_cast<int>(FloatBridgeType::ScalarImageType::ImageDimension) - 1; d >= 0; d--)
+    {
+      index = index * dims[d] + static_cast<size_t>(peakLocations[i][d]);
+    }
+    m_NewCellArray[index] = static_cast<uint32_t>(i + 1);
   }
+  watershed.flood(distance.data(), m_NewCellArray);
 }
 
 // -----------------------------------------------------------------------------
@@ -319,3 +321,39 @@ QString ItkBinaryWatershedLabeled::getNewCellArrayName() const
 {
   return m_NewCellArrayName;
 }
+
+// -----------------------------------------------------------------------------
+void ItkBinaryWatershedLabeled::setUseBlocks(bool value)
+{
+  m_UseBlocks = value;
+}
+
+// -----------------------------------------------------------------------------
+bool ItkBinaryWatershedLabeled::getUseBlocks() const
+{
+  return m_UseBlocks;
+}
+
+// -----------------------------------------------------------------------------
+void ItkBinaryWatershedLabeled::setBlockSize(int value)
+{
+  m_BlockSize = value;
+}
+
+// -----------------------------------------------------------------------------
+int ItkBinaryWatershedLabeled::getBlockSize() const
+{
+  return m_BlockSize;
+}
+
+// -----------------------------------------------------------------------------
+void ItkBinaryWatershedLabeled::setBlockHalo(int value)
+{
+  m_BlockHalo = value;
+}
+
+// -----------------------------------------------------------------------------
+int ItkBinaryWatershedLabeled::getBlockHalo() const
+{
+  return m_BlockHalo;
+}
@@ -67,6 +67,9 @@ class ImageProcessing_EXPORT ItkBinaryWatershedLabeled : public AbstractFilter
     PYB11_PROPERTY(DataArrayPath SelectedCellArrayPath READ getSelectedCellArrayPath WRITE setSelectedCellArrayPath)
     PYB11_PROPERTY(float PeakTolerance READ getPeakTolerance WRITE setPeakTolerance)
     PYB11_PROPERTY(QString NewCellArrayName READ getNewCellArrayName WRITE setNewCellArrayName)
+    PYB11_PROPERTY(bool UseBlocks READ getUseBlocks WRITE setUseBlocks)
+    PYB11_PROPERTY(int BlockSize READ getBlockSize WRITE setBlockSize)
+    PYB11_PROPERTY(int BlockHalo READ getBlockHalo WRITE setBlockHalo)
     PYB11_END_BINDINGS()
     // End Python bindings declarations
 
@@ -127,6 +130,42 @@ class ImageProcessing_EXPORT ItkBinaryWatershedLabeled : public AbstractFilter
 
     Q_PROPERTY(QString NewCellArrayName READ getNewCellArrayName WRITE setNewCellArrayName)
 
+    /**
+     * @brief Setter property for UseBlocks
+     */
+    void setUseBlocks(bool value);
+    /**
+     * @brief Getter property for UseBlocks
+     * @return Value of UseBlocks
+     */
+    bool getUseBlocks() const;
+
+    Q_PROPERTY(bool UseBlocks READ getUseBlocks WRITE setUseBlocks)
+
+    /**
+     * @brief Setter property for BlockSize
+     */
+    void setBlockSize(int value);
+    /**
+     * @brief Getter property for BlockSize
+     * @return Value of BlockSize
+     */
+    int getBlockSize() const;
+
+    Q_PROPERTY(int BlockSize READ getBlockSize WRITE setBlockSize)
+
+    /**
+     * @brief Setter property for BlockHalo
+     */
+    void setBlockHalo(int value);
+    /**
+     * @brief Getter property for BlockHalo
+     * @return Value of BlockHalo
+     */
+    int getBlockHalo() const;
+
+    Q_PROPERTY(int BlockHalo READ getBlockHalo WRITE setBlockHalo)
+
     /**
      * @brief getCompiledLibraryName Returns the name of the Library that this filter is a part of
      * @return
@@ -210,6 +249,9 @@ class ImageProcessing_EXPORT ItkBinaryWatershedLabeled : public AbstractFilter
     DataArrayPath m_SelectedCellArrayPath = {"", "", ""};
     float m_PeakTolerance = {1.0};
     QString m_NewCellArrayName = {"BinaryWatershedLabeled"};
+    bool m_UseBlocks = {false};
+    int m_BlockSize = {128};
+    int m_BlockHalo = {16};
 
   public:
     ItkBinaryWatershedLabeled(const ItkBinaryWatershedLabeled&) = delete; // Copy Constructor Not Implemented
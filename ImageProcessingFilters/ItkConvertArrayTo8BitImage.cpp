@@ -36,11 +36,14 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "ItkConvertArrayTo8BitImage.h"
 
+#include <QtCore/QStringList>
 #include <QtCore/QTextStream>
 
 #include "SIMPLib/ITK/itkSupportConstants.h"
 #include "SIMPLib/Common/Constants.h"
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
+#include "SIMPLib/FilterParameters/FloatFilterParameter.h"
+#include "SIMPLib/FilterParameters/LinkedBooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/LinkedPathCreationFilterParameter.h"
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
@@ -51,6 +54,7 @@
 #include "SIMPLib/DataContainers/DataContainer.h"
 
 #include "ImageProcessing/ImageProcessingConstants.h"
+#include "ImageProcessing/ImageProcessingHelpers.hpp"
 #include "ImageProcessing/ImageProcessingVersion.h"
 
 /* Create Enumerations to allow the created Attribute Arrays to take part in renaming */
@@ -76,6 +80,14 @@ ItkConvertArrayTo8BitImage::~ItkConvertArrayTo8BitImage() = default;
 void ItkConvertArrayTo8BitImage::setupFilterParameters()
 {
   FilterParameterVectorType parameters;
+  {
+    QStringList linkedProps;
+    linkedProps << "LowerPercentile"
+                << "UpperPercentile";
+    parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Clip to Percentiles", ClipPercentiles, FilterParameter::Category::Parameter, ItkConvertArrayTo8BitImage, linkedProps));
+  }
+  parameters.push_back(SIMPL_NEW_FLOAT_FP("Lower Percentile", LowerPercentile, FilterParameter::Category::Parameter, ItkConvertArrayTo8BitImage));
+  parameters.push_back(SIMPL_NEW_FLOAT_FP("Upper Percentile", UpperPercentile, FilterParameter::Category::Parameter, ItkConvertArrayTo8BitImage));
   parameters.push_back(SeparatorFilterParameter::Create("Cell Data", FilterParameter::Category::RequiredArray));
   {
     DataArraySelectionFilterParameter::RequirementType req = DataArraySelectionFilterParameter::CreateCategoryRequirement(SIMPL::Defaults::AnyPrimitive, 3, AttributeMatrix::Category::Any);
@@ -95,6 +107,9 @@ void ItkConvertArrayTo8BitImage::readFilterParameters(AbstractFilterParametersRe
   reader->openFilterGroup(this, index);
   setNewArrayArrayName(reader->readString("NewArrayArrayName", getNewArrayArrayName() ) );
   setSelectedArrayPath( reader->readDataArrayPath( "SelectedArrayPath", getSelectedArrayPath() ) );
+  setClipPercentiles( reader->readValue( "ClipPercentiles", getClipPercentiles() ) );
+  setLowerPercentile( reader->readValue( "LowerPercentile", getLowerPercentile() ) );
+  setUpperPercentile( reader->readValue( "UpperPercentile", getUpperPercentile() ) );
   reader->closeFilterGroup();
 }
 
@@ -114,6 +129,13 @@ void ItkConvertArrayTo8BitImage::dataCheck()
   clearWarningCode();
   DataArrayPath tempPath;
 
+  if(m_ClipPercentiles && (m_LowerPercentile < 0.0f || m_UpperPercentile > 100.0f || m_LowerPercentile >= m_UpperPercentile))
+  {
+    QString ss = QObject::tr("The percentiles must satisfy 0 <= lower < upper <= 100 (%1, %2)").arg(m_LowerPercentile).arg(m_UpperPercentile);
+    setErrorCondition(-5579, ss);
+    return;
+  }
+
   if(m_SelectedArrayPath.isEmpty())
   {
     setErrorCondition(-11000, "An array from the DataContainer must be selected.");
@@ -155,7 +177,7 @@ void ItkConvertArrayTo8BitImage::dataCheck()
 //
 // -----------------------------------------------------------------------------
 template<typename T>
-void scaleArray(IDataArray::Pointer inputData, uint8_t* newArray)
+void scaleArray(IDataArray::Pointer inputData, uint8_t* newArray, bool clip, float lowerPercentile, float upperPercentile)
 {
   typename DataArray<T>::Pointer inputArray = std::dynamic_pointer_cast<DataArray<T>>(inputData);
   if (nullptr == inputArray)
@@ -163,28 +185,16 @@ void scaleArray(IDataArray::Pointer inputData, uint8_t* newArray)
     return;
   }
 
-  T* inputArrayPtr = inputArray->getPointer(0);
-  size_t numPoints = inputArray->getNumberOfTuples();
-
-  float min = 1000000.0f;
-  float max = 0.0f;
-  float value;
-  float scaledValue;
-  for (size_t i = 0; i < numPoints; i++)
+  ImageProcessing::ByteScaler<T> scaler(inputArray->getPointer(0), inputArray->getNumberOfTuples());
+  if(clip)
   {
-    value = inputArrayPtr[i];
-    if(value > max) { max = value; }
-    if(value < min) { min = value; }
+    scaler.findRange(lowerPercentile, upperPercentile);
   }
-
-  for (size_t i = 0; i < numPoints; i++)
+  else
   {
-    scaledValue = (inputArrayPtr[i] - min) / (max - min);
-    if(scaledValue < 0.0) { scaledValue = 0.0f; }
-    else if(scaledValue > 1.0f) { scaledValue = 1.0f; }
-    scaledValue *= 255.0f;
-    newArray[i] = static_cast<uint8_t>(scaledValue);
+    scaler.findRange();
   }
+  scaler.scale(newArray);
 }
 
 // -----------------------------------------------------------------------------
@@ -208,47 +218,47 @@ void ItkConvertArrayTo8BitImage::execute()
   IDataArray::Pointer p = IDataArray::NullPointer();
   if (dType.compare("int8_t") == 0)
   {
-    scaleArray<int8_t>(inputData, m_NewArray);
+    scaleArray<int8_t>(inputData, m_NewArray, m_ClipPercentiles, m_LowerPercentile, m_UpperPercentile);
   }
   else if (dType.compare("uint8_t") == 0)
   {
-    scaleArray<uint8_t>(inputData, m_NewArray);
+    scaleArray<uint8_t>(inputData, m_NewArray, m_ClipPercentiles, m_LowerPercentile, m_UpperPercentile);
   }
   else if (dType.compare("int16_t") == 0)
   {
-    scaleArray<int16_t>(inputData, m_NewArray);
+    scaleArray<int16_t>(inputData, m_NewArray, m_ClipPercentiles, m_LowerPercentile, m_UpperPercentile);
   }
   else if (dType.compare("uint16_t") == 0)
   {
-    scaleArray<uint16_t>(inputData, m_NewArray);
+    scaleArray<uint16_t>(inputData, m_NewArray, m_ClipPercentiles, m_LowerPercentile, m_UpperPercentile);
   }
   else if (dType.compare("int32_t") == 0)
   {
-    scaleArray<int32_t>(inputData, m_NewArray);
+    scaleArray<int32_t>(inputData, m_NewArray, m_ClipPercentiles, m_LowerPercentile, m_UpperPercentile);
   }
   else if (dType.compare("uint32_t") == 0)
   {
-    scaleArray<uint32_t>(inputData, m_NewArray);
+    scaleArray<uint32_t>(inputData, m_NewArray, m_ClipPercentiles, m_LowerPercentile, m_UpperPercentile);
   }
   else if (dType.compare("int64_t") == 0)
   {
-    scaleArray<int64_t>(inputData, m_NewArray);
+    scaleArray<int64_t>(inputData, m_NewArray, m_ClipPercentiles, m_LowerPercentile, m_UpperPercentile);
   }
   else if (dType.compare("uint64_t") == 0)
   {
-    scaleArray<uint64_t>(inputData, m_NewArray);
+    scaleArray<uint64_t>(inputData, m_NewArray, m_ClipPercentiles, m_LowerPercentile, m_UpperPercentile);
   }
   else if (dType.compare("float") == 0)
   {
-    scaleArray<float>(inputData, m_NewArray);
+    scaleArray<float>(inputData, m_NewArray, m_ClipPercentiles, m_LowerPercentile, m_UpperPercentile);
   }
   else if (dType.compare("double") == 0)
   {
-    scaleArray<double>(inputData, m_NewArray);
+    scaleArray<double>(inputData, m_NewArray, m_ClipPercentiles, m_LowerPercentile, m_UpperPercentile);
   }
   else if (dType.compare("bool") == 0)
   {
-    scaleArray<bool>(inputData, m_NewArray);
+    scaleArray<bool>(inputData, m_NewArray, m_ClipPercentiles, m_LowerPercentile, m_UpperPercentile);
   }
 
 }
@@ -373,3 +383,39 @@ QString ItkConvertArrayTo8BitImage::getNewArrayArrayName() const
 {
   return m_NewArrayArrayName;
 }
+
+// -----------------------------------------------------------------------------
+void ItkConvertArrayTo8BitImage::setClipPercentiles(bool value)
+{
+  m_ClipPercentiles = value;
+}
+
+// -----------------------------------------------------------------------------
+bool ItkConvertArrayTo8BitImage::getClipPercentiles() const
+{
+  return m_ClipPercentiles;
+}
+
+// -----------------------------------------------------------------------------
+void ItkConvertArrayTo8BitImage::setLowerPercentile(float value)
+{
+  m_LowerPercentile = value;
+}
+
+// -----------------------------------------------------------------------------
+float ItkConvertArrayTo8BitImage::getLowerPercentile() const
+{
+  return m_LowerPercentile;
+}
+
+// -----------------------------------------------------------------------------
+void ItkConvertArrayTo8BitImage::setUpperPercentile(float value)
+{
+  m_UpperPercentile = value;
+}
+
+// -----------------------------------------------------------------------------
+float ItkConvertArrayTo8BitImage::getUpperPercentile() const
+{
+  return m_UpperPercentile;
+}
@@ -69,6 +69,9 @@ class ImageProcessing_EXPORT ItkConvertArrayTo8BitImage : public AbstractFilter
     PYB11_FILTER_NEW_MACRO(ItkConvertArrayTo8BitImage)
     PYB11_PROPERTY(DataArrayPath SelectedArrayPath READ getSelectedArrayPath WRITE setSelectedArrayPath)
     PYB11_PROPERTY(QString NewArrayArrayName READ getNewArrayArrayName WRITE setNewArrayArrayName)
+    PYB11_PROPERTY(bool ClipPercentiles READ getClipPercentiles WRITE setClipPercentiles)
+    PYB11_PROPERTY(float LowerPercentile READ getLowerPercentile WRITE setLowerPercentile)
+    PYB11_PROPERTY(float UpperPercentile READ getUpperPercentile WRITE setUpperPercentile)
     PYB11_END_BINDINGS()
     // End Python bindings declarations
 
@@ -117,6 +120,42 @@ class ImageProcessing_EXPORT ItkConvertArrayTo8BitImage : public AbstractFilter
 
     Q_PROPERTY(QString NewArrayArrayName READ getNewArrayArrayName WRITE setNewArrayArrayName)
 
+    /**
+     * @brief Setter property for ClipPercentiles
+     */
+    void setClipPercentiles(bool value);
+    /**
+     * @brief Getter property for ClipPercentiles
+     * @return Value of ClipPercentiles
+     */
+    bool getClipPercentiles() const;
+
+    Q_PROPERTY(bool ClipPercentiles READ getClipPercentiles WRITE setClipPercentiles)
+
+    /**
+     * @brief Setter property for LowerPercentile
+     */
+    void setLowerPercentile(float value);
+    /**
+     * @brief Getter property for LowerPercentile
+     * @return Value of LowerPercentile
+     */
+    float getLowerPercentile() const;
+
+    Q_PROPERTY(float LowerPercentile READ getLowerPercentile WRITE setLowerPercentile)
+
+    /**
+     * @brief Setter property for UpperPercentile
+     */
+    void setUpperPercentile(float value);
+    /**
+     * @brief Getter property for UpperPercentile
+     * @return Value of UpperPercentile
+     */
+    float getUpperPercentile() const;
+
+    Q_PROPERTY(float UpperPercentile READ getUpperPercentile WRITE setUpperPercentile)
+
     /**
      * @brief getCompiledLibraryName Reimplemented from @see AbstractFilter class
      */
@@ -199,6 +238,9 @@ class ImageProcessing_EXPORT ItkConvertArrayTo8BitImage : public AbstractFilter
 
     DataArrayPath m_SelectedArrayPath = {"", "", ""};
     QString m_NewArrayArrayName = {""};
+    bool m_ClipPercentiles = {false};
+    float m_LowerPercentile = {0.1f};
+    float m_UpperPercentile = {99.9f};
 
   public:
     ItkConvertArrayTo8BitImage(const ItkConvertArrayTo8BitImage&) = delete; // Copy Constructor Not Implemented
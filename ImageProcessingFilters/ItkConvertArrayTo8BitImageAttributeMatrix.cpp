@@ -36,18 +36,23 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #include "ItkConvertArrayTo8BitImageAttributeMatrix.h"
 
+#include <limits>
+
 #include <QtCore/QTextStream>
 
 #include "SIMPLib/ITK/itkSupportConstants.h"
 #include "SIMPLib/Common/Constants.h"
 #include "SIMPLib/FilterParameters/AttributeMatrixSelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
+#include "SIMPLib/FilterParameters/IntFilterParameter.h"
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
 #include "SIMPLib/Geometry/ImageGeom.h"
 #include "SIMPLib/SIMPLibVersion.h"
 #include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
 
 #include "ImageProcessing/ImageProcessingConstants.h"
+#include "ImageProcessing/ImageProcessingHelpers.hpp"
 #include "ImageProcessing/ImageProcessingVersion.h"
 
 /* Create Enumerations to allow the created Attribute Arrays to take part in renaming */
@@ -73,6 +78,7 @@ ItkConvertArrayTo8BitImageAttributeMatrix::~ItkConvertArrayTo8BitImageAttributeM
 void ItkConvertArrayTo8BitImageAttributeMatrix::setupFilterParameters()
 {
   FilterParameterVectorType parameters;
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Memory Budget (MB, 0 for no limit)", MemoryBudget, FilterParameter::Category::Parameter, ItkConvertArrayTo8BitImageAttributeMatrix));
   parameters.push_back(SeparatorFilterParameter::Create("Cell Data", FilterParameter::Category::RequiredArray));
   {
     AttributeMatrixSelectionFilterParameter::RequirementType req;
@@ -88,6 +94,7 @@ void ItkConvertArrayTo8BitImageAttributeMatrix::readFilterParameters(AbstractFil
 {
   reader->openFilterGroup(this, index);
   setAttributeMatrixName(reader->readDataArrayPath("AttributeMatrixName", getAttributeMatrixName()));
+  setMemoryBudget(reader->readValue("MemoryBudget", getMemoryBudget()));
 //  setNewArrayArrayName(reader->readString("NewArrayArrayName", getNewArrayArrayName() ) );
 //  setSelectedArrayPath( reader->readDataArrayPath( "SelectedArrayPath", getSelectedArrayPath() ) );
   reader->closeFilterGroup();
@@ -109,6 +116,12 @@ void ItkConvertArrayTo8BitImageAttributeMatrix::dataCheck()
   clearWarningCode();
   DataArrayPath tempPath;
 
+  if(m_MemoryBudget < 0)
+  {
+    setErrorCondition(-5580, QObject::tr("The memory budget cannot be negative"));
+    return;
+  }
+
   AttributeMatrix::Pointer am = getDataContainerArray()->getAttributeMatrix(m_AttributeMatrixName);
 
   if (am.get() == nullptr)
@@ -146,9 +159,8 @@ void ItkConvertArrayTo8BitImageAttributeMatrix::dataCheck()
 }
 
 
-// -----------------------------------------------------------------------------
-//
-// -----------------------------------------------------------------------------
+namespace
+{
 template<typename T>
 void scaleArray2(IDataArray::Pointer inputData, uint8_t* newArray)
 {
@@ -158,44 +170,85 @@ void scaleArray2(IDataArray::Pointer inputData, uint8_t* newArray)
     return;
   }
 
-  T* inputArrayPtr = inputArray->getPointer(0);
-  size_t numPoints = inputArray->getNumberOfTuples();
+  ImageProcessing::ByteScaler<T> scaler(inputArray->getPointer(0), inputArray->getNumberOfTuples());
+  scaler.findRange();
+  scaler.scale(newArray);
+}
 
-  T min = std::numeric_limits<T>::max();
-  T max = 0.0f;
-  T value;
-  T scaledValue;
-  for (size_t i = 0; i < numPoints; i++)
+void convertArray(IDataArray::Pointer inputData, uint8_t* newArray)
+{
+  QString dType = inputData->getTypeAsString();
+  if (dType.compare("int8_t") == 0)
+  {
+    scaleArray2<int8_t>(inputData, newArray);
+  }
+  else if (dType.compare("uint8_t") == 0)
+  {
+    scaleArray2<uint8_t>(inputData, newArray);
+  }
+  else if (dType.compare("int16_t") == 0)
+  {
+    scaleArray2<int16_t>(inputData, newArray);
+  }
+  else if (dType.compare("uint16_t") == 0)
+  {
+    scaleArray2<uint16_t>(inputData, newArray);
+  }
+  else if (dType.compare("int32_t") == 0)
+  {
+    scaleArray2<int32_t>(inputData, newArray);
+  }
+  else if (dType.compare("uint32_t") == 0)
   {
-    value = inputArrayPtr[i];
-    if(value > max) { max = value; }
-    if(value < min) { min = value; }
+    scaleArray2<uint32_t>(inputData, newArray);
   }
+  else if (dType.compare("int64_t") == 0)
+  {
+    scaleArray2<int64_t>(inputData, newArray);
+  }
+  else if (dType.compare("uint64_t") == 0)
+  {
+    scaleArray2<uint64_t>(inputData, newArray);
+  }
+  else if (dType.compare("float") == 0)
+  {
+    scaleArray2<float>(inputData, newArray);
+  }
+  else if (dType.compare("double") == 0)
+  {
+    scaleArray2<double>(inputData, newArray);
+  }
+  else if (dType.compare("bool") == 0)
+  {
+    scaleArray2<bool>(inputData, newArray);
+  }
+}
 
-  float delta = (max - min);
-  if(delta < 0.0000001)
+/**
+ * @brief The ConvertImpl class converts a batch of arrays, one array per task. Each conversion is itself parallel.
+ */
+class ConvertImpl
+{
+public:
+  ConvertImpl(const std::vector<IDataArray::Pointer>& inputArrays, const std::vector<uint8_t*>& outputArrays)
+  : m_InputArrays(inputArrays)
+  , m_OutputArrays(outputArrays)
   {
-    for (size_t i = 0; i < numPoints; i++)
-    {
-      scaledValue = inputArrayPtr[i];
-      if(scaledValue < 0.0) { scaledValue = 0.0f; }
-      else if(scaledValue > 1.0f) { scaledValue = 1.0f; }
-      scaledValue *= 255.0f;
-      newArray[i] = static_cast<uint8_t>(scaledValue);
-    }
   }
-  else
+
+  void operator()(const SIMPLRange& range) const
   {
-    for (size_t i = 0; i < numPoints; i++)
+    for(size_t i = range.min(); i < range.max(); i++)
     {
-      scaledValue = (inputArrayPtr[i] - min) / delta;
-      if(scaledValue < 0.0) { scaledValue = 0.0f; }
-      else if(scaledValue > 1.0f) { scaledValue = 1.0f; }
-      scaledValue *= 255.0f;
-      newArray[i] = static_cast<uint8_t>(scaledValue);
+      convertArray(m_InputArrays[i], m_OutputArrays[i]);
     }
   }
-}
+
+private:
+  const std::vector<IDataArray::Pointer>& m_InputArrays;
+  const std::vector<uint8_t*>& m_OutputArrays;
+};
+} // namespace
 
 // -----------------------------------------------------------------------------
 //
@@ -212,76 +265,63 @@ void ItkConvertArrayTo8BitImageAttributeMatrix::execute()
   QList<QString> names = am->getAttributeArrayNames();
   DataArrayPath tempPath;
   std::vector<size_t> dims(1, 1);
+  const size_t budget = m_MemoryBudget > 0 ? static_cast<size_t>(m_MemoryBudget) * 1024 * 1024 : std::numeric_limits<size_t>::max();
 
-  for(size_t i = 0; i < names.size(); i++)
+  //arrays are converted concurrently in batches whose new 8 bit arrays fit in the budget (a batch holds at least one
+  //array). each source array is dropped as soon as its batch is done, 8 bit arrays are rescaled in place for free
+  int start = 0;
+  while(start < names.size())
   {
+    std::vector<IDataArray::Pointer> inputArrays;
+    std::vector<uint8_t*> outputArrays;
+    std::vector<bool> inPlace;
+    size_t batchBytes = 0;
+    int end = start;
+    for(; end < names.size(); end++)
+    {
+      IDataArray::Pointer inputData = am->getAttributeArray(names[end]);
+      UInt8ArrayType::Pointer byteArray = std::dynamic_pointer_cast<UInt8ArrayType>(inputData);
+      const size_t bytes = nullptr == byteArray ? inputData->getNumberOfTuples() : 0;
+      if(end > start && batchBytes + bytes > budget)
+      {
+        break;
+      }
+      batchBytes += bytes;
 
-    m_NewArrayArrayName = names[i] + "8bit";
-    tempPath.update(getAttributeMatrixName().getDataContainerName(), getAttributeMatrixName().getAttributeMatrixName(), getNewArrayArrayName() );
-    m_NewArrayPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<uint8_t>>(this, tempPath, 0, dims, "", DataArrayID31);
-    if(nullptr != m_NewArrayPtr.lock())
-    { m_NewArray = m_NewArrayPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
-
-    IDataArray::Pointer inputData = getDataContainerArray()->getDataContainer(getAttributeMatrixName().getDataContainerName())->getAttributeMatrix(getAttributeMatrixName().getAttributeMatrixName())->getAttributeArray(names[i]);
+      if(nullptr == byteArray)
+      {
+        tempPath.update(getAttributeMatrixName().getDataContainerName(), getAttributeMatrixName().getAttributeMatrixName(), names[end] + "8bit");
+        byteArray = getDataContainerArray()->createNonPrereqArrayFromPath<UInt8ArrayType>(this, tempPath, 0, dims, "", DataArrayID31).lock();
+        if(getErrorCode() < 0 || nullptr == byteArray)
+        {
+          return;
+        }
+      }
+      inputArrays.push_back(inputData);
+      outputArrays.push_back(byteArray->getPointer(0));
+      inPlace.push_back(0 == bytes);
+    }
 
+    notifyStatusMessage(QObject::tr("Converting Arrays %1-%2 of %3").arg(start + 1).arg(end).arg(names.size()));
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(0, inputArrays.size());
+    dataAlg.execute(ConvertImpl(inputArrays, outputArrays));
 
-    QString dType = inputData->getTypeAsString();
-    IDataArray::Pointer p = IDataArray::NullPointer();
-    if (dType.compare("int8_t") == 0)
-    {
-      scaleArray2<int8_t>(inputData, m_NewArray);
-    }
-    else if (dType.compare("uint8_t") == 0)
-    {
-      scaleArray2<uint8_t>(inputData, m_NewArray);
-    }
-    else if (dType.compare("int16_t") == 0)
-    {
-      scaleArray2<int16_t>(inputData, m_NewArray);
-    }
-    else if (dType.compare("uint16_t") == 0)
-    {
-      scaleArray2<uint16_t>(inputData, m_NewArray);
-    }
-    else if (dType.compare("int32_t") == 0)
-    {
-      scaleArray2<int32_t>(inputData, m_NewArray);
-    }
-    else if (dType.compare("uint32_t") == 0)
-    {
-      scaleArray2<uint32_t>(inputData, m_NewArray);
-    }
-    else if (dType.compare("int64_t") == 0)
-    {
-      scaleArray2<int64_t>(inputData, m_NewArray);
-    }
-    else if (dType.compare("uint64_t") == 0)
-    {
-      scaleArray2<uint64_t>(inputData, m_NewArray);
-    }
-    else if (dType.compare("float") == 0)
+    for(int i = start; i < end; i++)
     {
-      scaleArray2<float>(inputData, m_NewArray);
+      if(!inPlace[i - start])
+      {
+        am->removeAttributeArray(names[i]);
+        am->renameAttributeArray(names[i] + "8bit", names[i]);
+      }
     }
-    else if (dType.compare("double") == 0)
+
+    if(getCancel())
     {
-      scaleArray2<double>(inputData, m_NewArray);
+      return;
     }
-//      else if (dType.compare("bool") == 0)
-//      {
-//        scaleArray2<bool>(inputData, m_NewArray);
-//      }
-
-    am->removeAttributeArray(names[i]);
-    am->renameAttributeArray(names[i] + "8bit", names[i]);
-
-
+    start = end;
   }
-
-
-
-
-
 }
 
 // -----------------------------------------------------------------------------
@@ -404,3 +444,15 @@ QString ItkConvertArrayTo8BitImageAttributeMatrix::getNewArrayArrayName() const
 {
   return m_NewArrayArrayName;
 }
+
+// -----------------------------------------------------------------------------
+void ItkConvertArrayTo8BitImageAttributeMatrix::setMemoryBudget(int value)
+{
+  m_MemoryBudget = value;
+}
+
+// -----------------------------------------------------------------------------
+int ItkConvertArrayTo8BitImageAttributeMatrix::getMemoryBudget() const
+{
+  return m_MemoryBudget;
+}
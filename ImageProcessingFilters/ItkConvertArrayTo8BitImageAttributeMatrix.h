@@ -69,6 +69,7 @@ class ImageProcessing_EXPORT ItkConvertArrayTo8BitImageAttributeMatrix : public
     PYB11_FILTER_NEW_MACRO(ItkConvertArrayTo8BitImageAttributeMatrix)
     PYB11_PROPERTY(DataArrayPath AttributeMatrixName READ getAttributeMatrixName WRITE setAttributeMatrixName)
     PYB11_PROPERTY(QString NewArrayArrayName READ getNewArrayArrayName WRITE setNewArrayArrayName)
+    PYB11_PROPERTY(int MemoryBudget READ getMemoryBudget WRITE setMemoryBudget)
     PYB11_END_BINDINGS()
     // End Python bindings declarations
 
@@ -117,6 +118,18 @@ class ImageProcessing_EXPORT ItkConvertArrayTo8BitImageAttributeMatrix : public
 
     Q_PROPERTY(QString NewArrayArrayName READ getNewArrayArrayName WRITE setNewArrayArrayName)
 
+    /**
+     * @brief Setter property for MemoryBudget
+     */
+    void setMemoryBudget(int value);
+    /**
+     * @brief Getter property for MemoryBudget
+     * @return Value of MemoryBudget
+     */
+    int getMemoryBudget() const;
+
+    Q_PROPERTY(int MemoryBudget READ getMemoryBudget WRITE setMemoryBudget)
+
     /**
      * @brief getCompiledLibraryName Reimplemented from @see AbstractFilter class
      */
@@ -194,11 +207,9 @@ class ImageProcessing_EXPORT ItkConvertArrayTo8BitImageAttributeMatrix : public
 
 
   private:
-    std::weak_ptr<DataArray<uint8_t>> m_NewArrayPtr;
-    uint8_t* m_NewArray = nullptr;
-
     DataArrayPath m_AttributeMatrixName = {SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellAttributeMatrixName, ""};
     QString m_NewArrayArrayName = {""};
+    int m_MemoryBudget = {1024};
 
   public:
     ItkConvertArrayTo8BitImageAttributeMatrix(const ItkConvertArrayTo8BitImageAttributeMatrix&) = delete; // Copy Constructor Not Implemented
@@ -0,0 +1,827 @@
+/* ============================================================================
+ * Copyright (c) 2014 William Lenthe
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of William Lenthe or any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  This code was partially written under United States Air Force Contract number
+ *                              FA8650-10-D-5210
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ItkDetermineStitching.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+
+#include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
+#include "SIMPLib/FilterParameters/AttributeMatrixSelectionFilterParameter.h"
+#include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
+#include "SIMPLib/FilterParameters/FloatFilterParameter.h"
+#include "SIMPLib/FilterParameters/IntFilterParameter.h"
+#include "SIMPLib/FilterParameters/LinkedPathCreationFilterParameter.h"
+#include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
+#include "SIMPLib/FilterParameters/StringFilterParameter.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
+
+#include "ImageProcessing/ImageProcessingConstants.h"
+
+/* Create Enumerations to allow the created Attribute Arrays to take part in renaming */
+enum createdPathID : RenameDataPath::DataID_t
+{
+  AttributeMatrixID21 = 21,
+
+  DataArrayID31 = 31,
+};
+
+namespace
+{
+using Complex = std::complex<double>;
+
+size_t NextPowerOfTwo(size_t value)
+{
+  size_t power = 1;
+  while(power < value)
+  {
+    power <<= 1;
+  }
+  return power;
+}
+
+/**
+ * @brief Twiddles returns the n / 2 forward twiddle factors exp(-2 pi i k / n) of a length n (a power of 2) transform
+ */
+std::vector<Complex> Twiddles(size_t n)
+{
+  const double angle = -2.0 * std::acos(-1.0) / static_cast<double>(n);
+  std::vector<Complex> twiddles(n / 2);
+  for(size_t k = 0; k < twiddles.size(); k++)
+  {
+    twiddles[k] = std::polar(1.0, angle * static_cast<double>(k));
+  }
+  return twiddles;
+}
+
+/**
+ * @brief FFT is an in place iterative radix 2 transform of n (a power of 2) values using the twiddle factors of
+ * length n (the conjugates for the inverse), the inverse is not scaled
+ */
+void FFT(Complex* data, size_t n, const std::vector<Complex>& twiddles, bool inverse)
+{
+  for(size_t i = 1, j = 0; i < n; i++)
+  {
+    size_t bit = n >> 1;
+    for(; 0 != (j & bit); bit >>= 1)
+    {
+      j ^= bit;
+    }
+    j ^= bit;
+    if(i < j)
+    {
+      std::swap(data[i], data[j]);
+    }
+  }
+
+  for(size_t length = 2; length <= n; length <<= 1)
+  {
+    const size_t half = length / 2;
+    const size_t stride = n / length;
+    for(size_t i = 0; i < n; i += length)
+    {
+      for(size_t j = 0; j < half; j++)
+      {
+        const Complex twiddle = inverse ? std::conj(twiddles[j * stride]) : twiddles[j * stride];
+        const Complex u = data[i + j];
+        const Complex v = data[i + j + half] * twiddle;
+        data[i + j] = u + v;
+        data[i + j + half] = u - v;
+      }
+    }
+  }
+}
+
+/**
+ * @brief FFT2D transforms the rows and then the columns of a width x height (powers of 2) row major buffer
+ */
+void FFT2D(std::vector<Complex>& data, size_t width, size_t height, bool inverse)
+{
+  const std::vector<Complex> rowTwiddles = Twiddles(width);
+  for(size_t y = 0; y < height; y++)
+  {
+    FFT(data.data() + y * width, width, rowTwiddles, inverse);
+  }
+  const std::vector<Complex> columnTwiddles = height == width ? rowTwiddles : Twiddles(height);
+  std::vector<Complex> column(height);
+  for(size_t x = 0; x < width; x++)
+  {
+    for(size_t y = 0; y < height; y++)
+    {
+      column[y] = data[y * width + x];
+    }
+    FFT(column.data(), height, columnTwiddles, inverse);
+    for(size_t y = 0; y < height; y++)
+    {
+      data[y * width + x] = column[y];
+    }
+  }
+}
+
+/**
+ * @brief The TilePair struct holds two neighboring tiles and the measured position of the moving tile relative to the
+ * fixed one, weighted by the correlation of their overlap (0 if nothing could be measured)
+ */
+struct TilePair
+{
+  size_t fixed;
+  size_t moving;
+  size_t axis;
+  double offset[2];
+  double weight;
+};
+
+/**
+ * @brief The OverlapCorrelation class measures the offset between two neighboring tiles from the strips where they are
+ * expected to overlap: the far edge of the fixed tile and the near edge of the moving tile, each as deep as the nominal
+ * overlap plus the search radius. The cross correlation of the (mean free, zero padded) strips for every shift comes
+ * from one FFT product; it is normalized over the pixels that actually overlap at each shift within the search radius
+ * of the nominal offset (using summed area tables), and the peak is refined to sub pixel accuracy with a parabola.
+ */
+class OverlapCorrelation
+{
+public:
+  OverlapCorrelation(const size_t tileDims[2], const size_t overlap[2], size_t maxShift)
+  : m_MaxShift(static_cast<int64_t>(maxShift))
+  {
+    for(size_t d = 0; d < 2; d++)
+    {
+      m_TileDims[d] = tileDims[d];
+      m_Overlap[d] = overlap[d];
+    }
+  }
+
+  void measure(const uint8_t* fixed, const uint8_t* moving, TilePair& pair) const
+  {
+    //strip in the fixed tile, the moving strip starts at the moving tile's origin
+    size_t size[2] = {m_TileDims[0], m_TileDims[1]};
+    size[pair.axis] = std::min(m_TileDims[pair.axis], m_Overlap[pair.axis] + static_cast<size_t>(m_MaxShift));
+    size_t origin[2] = {0, 0};
+    origin[pair.axis] = m_TileDims[pair.axis] - size[pair.axis];
+    int64_t nominal[2] = {0, 0};
+    nominal[pair.axis] = static_cast<int64_t>(m_TileDims[pair.axis] - m_Overlap[pair.axis]) - static_cast<int64_t>(origin[pair.axis]);
+
+    pair.weight = 0.0;
+    pair.offset[0] = static_cast<double>(origin[0] + nominal[0]);
+    pair.offset[1] = static_cast<double>(origin[1] + nominal[1]);
+
+    const size_t width = size[0];
+    const size_t height = size[1];
+    std::vector<double> stripA(width * height);
+    std::vector<double> stripB(width * height);
+    double meanA = 0.0;
+    double meanB = 0.0;
+    for(size_t y = 0; y < height; y++)
+    {
+      for(size_t x = 0; x < width; x++)
+      {
+        stripA[y * width + x] = fixed[(origin[1] + y) * m_TileDims[0] + origin[0] + x];
+        stripB[y * width + x] = moving[y * m_TileDims[0] + x];
+        meanA += stripA[y * width + x];
+        meanB += stripB[y * width + x];
+      }
+    }
+    meanA /= static_cast<double>(width * height);
+    meanB /= static_cast<double>(width * height);
+
+    //correlation[t] = sum over x of A(x + t) * B(x), padded so shifts within the search radius don't wrap
+    const size_t padded[2] = {NextPowerOfTwo(width + 2 * m_MaxShift), NextPowerOfTwo(height + 2 * m_MaxShift)};
+    std::vector<Complex> transformA(padded[0] * padded[1], Complex(0.0, 0.0));
+    std::vector<Complex> transformB(padded[0] * padded[1], Complex(0.0, 0.0));
+    for(size_t y = 0; y < height; y++)
+    {
+      for(size_t x = 0; x < width; x++)
+      {
+        stripA[y * width + x] -= meanA;
+        stripB[y * width + x] -= meanB;
+        transformA[y * padded[0] + x] = stripA[y * width + x];
+        transformB[y * padded[0] + x] = stripB[y * width + x];
+      }
+    }
+    FFT2D(transformA, padded[0], padded[1], false);
+    FFT2D(transformB, padded[0], padded[1], false);
+    for(size_t i = 0; i < transformA.size(); i++)
+    {
+      transformA[i] *= std::conj(transformB[i]);
+    }
+    FFT2D(transformA, padded[0], padded[1], true);
+    const double scale = 1.0 / static_cast<double>(transformA.size());
+
+    std::vector<double> sumA;
+    std::vector<double> sumSqA;
+    std::vector<double> sumB;
+    std::vector<double> sumSqB;
+    SummedArea(stripA, width, height, sumA, sumSqA);
+    SummedArea(stripB, width, height, sumB, sumSqB);
+
+    //normalized correlation of every candidate shift, shifts overlapping less than a quarter of the nominal overlap are skipped
+    const int64_t w = static_cast<int64_t>(width);
+    const int64_t h = static_cast<int64_t>(height);
+    const int64_t minCount = std::max<int64_t>(16, (w - std::abs(nominal[0])) * (h - std::abs(nominal[1])) / 4);
+    const int64_t span = 2 * m_MaxShift + 1;
+    std::vector<double> scores(span * span, std::numeric_limits<double>::lowest());
+    int64_t best = -1;
+    for(int64_t j = 0; j < span; j++)
+    {
+      const int64_t ty = nominal[1] - m_MaxShift + j;
+      const int64_t y0 = std::max<int64_t>(0, -ty);
+      const int64_t y1 = std::min(h, h - ty);
+      for(int64_t i = 0; i < span; i++)
+      {
+        const int64_t tx = nominal[0] - m_MaxShift + i;
+        const int64_t x0 = std::max<int64_t>(0, -tx);
+        const int64_t x1 = std::min(w, w - tx);
+        const int64_t count = std::max<int64_t>(0, x1 - x0) * std::max<int64_t>(0, y1 - y0);
+        if(count < minCount)
+        {
+          continue;
+        }
+        const double n = static_cast<double>(count);
+        const double a = Region(sumA, width, x0 + tx, y0 + ty, x1 + tx, y1 + ty);
+        const double aa = Region(sumSqA, width, x0 + tx, y0 + ty, x1 + tx, y1 + ty);
+        const double b = Region(sumB, width, x0, y0, x1, y1);
+        const double bb = Region(sumSqB, width, x0, y0, x1, y1);
+        const double varA = aa - a * a / n;
+        const double varB = bb - b * b / n;
+        if(varA <= 1.0e-9 * n || varB <= 1.0e-9 * n)
+        {
+          continue;
+        }
+        const size_t index = static_cast<size_t>((ty + static_cast<int64_t>(padded[1])) % static_cast<int64_t>(padded[1])) * padded[0] +
+                             static_cast<size_t>((tx + static_cast<int64_t>(padded[0])) % static_cast<int64_t>(padded[0]));
+        const double cross = transformA[index].real() * scale;
+        scores[j * span + i] = (cross - a * b / n) / std::sqrt(varA * varB);
+        if(best < 0 || scores[j * span + i] > scores[best])
+        {
+          best = j * span + i;
+        }
+      }
+    }
+    if(best < 0 || scores[best] <= 0.0)
+    {
+      return;
+    }
+
+    const int64_t bestI = best % span;
+    const int64_t bestJ = best / span;
+    const double refined[2] = {static_cast<double>(nominal[0] - m_MaxShift + bestI) + Parabola(scores, span, bestI, bestJ, 1, 0),
+                               static_cast<double>(nominal[1] - m_MaxShift + bestJ) + Parabola(scores, span, bestI, bestJ, 0, 1)};
+    pair.offset[0] = static_cast<double>(origin[0]) + refined[0];
+    pair.offset[1] = static_cast<double>(origin[1]) + refined[1];
+    pair.weight = scores[best];
+  }
+
+private:
+  static void SummedArea(const std::vector<double>& values, size_t width, size_t height, std::vector<double>& sums, std::vector<double>& sumSquares)
+  {
+    sums.assign((width + 1) * (height + 1), 0.0);
+    sumSquares.assign((width + 1) * (height + 1), 0.0);
+    for(size_t y = 0; y < height; y++)
+    {
+      double row = 0.0;
+      double rowSquares = 0.0;
+      for(size_t x = 0; x < width; x++)
+      {
+        const double value = values[y * width + x];
+        row += value;
+        rowSquares += value * value;
+        sums[(y + 1) * (width + 1) + x + 1] = sums[y * (width + 1) + x + 1] + row;
+        sumSquares[(y + 1) * (width + 1) + x + 1] = sumSquares[y * (width + 1) + x + 1] + rowSquares;
+      }
+    }
+  }
+
+  static double Region(const std::vector<double>& sums, size_t width, int64_t x0, int64_t y0, int64_t x1, int64_t y1)
+  {
+    const size_t stride = width + 1;
+    return sums[y1 * stride + x1] - sums[y0 * stride + x1] - sums[y1 * stride + x0] + sums[y0 * stride + x0];
+  }
+
+  //vertex of the parabola through the peak and its neighbors along one axis (0 at the search border or a flat top)
+  static double Parabola(const std::vector<double>& scores, int64_t span, int64_t i, int64_t j, int64_t di, int64_t dj)
+  {
+    if(i - di < 0 || j - dj < 0 || i + di >= span || j + dj >= span)
+    {
+      return 0.0;
+    }
+    const double lower = scores[(j - dj) * span + i - di];
+    const double center = scores[j * span + i];
+    const double upper = scores[(j + dj) * span + i + di];
+    const double curvature = lower - 2.0 * center + upper;
+    if(lower == std::numeric_limits<double>::lowest() || upper == std::numeric_limits<double>::lowest() || curvature >= 0.0)
+    {
+      return 0.0;
+    }
+    return std::min(0.5, std::max(-0.5, 0.5 * (lower - upper) / curvature));
+  }
+
+  size_t m_TileDims[2];
+  size_t m_Overlap[2];
+  int64_t m_MaxShift;
+};
+
+/**
+ * @brief The PairImpl class measures a range of neighboring tile pairs
+ */
+class PairImpl
+{
+public:
+  PairImpl(const OverlapCorrelation& correlation, const std::vector<const uint8_t*>& tiles, std::vector<TilePair>& pairs)
+  : m_Correlation(correlation)
+  , m_Tiles(tiles)
+  , m_Pairs(pairs)
+  {
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    for(size_t i = range.min(); i < range.max(); i++)
+    {
+      TilePair& pair = m_Pairs[i];
+      m_Correlation.measure(m_Tiles[pair.fixed], m_Tiles[pair.moving], pair);
+    }
+  }
+
+private:
+  const OverlapCorrelation& m_Correlation;
+  const std::vector<const uint8_t*>& m_Tiles;
+  std::vector<TilePair>& m_Pairs;
+};
+
+/**
+ * @brief SolvePositions finds the tile positions along one axis that best agree (weighted least squares) with every
+ * measured pair offset, with a faint pull towards the nominal grid so tiles without a usable measurement stay in place.
+ * The normal equations are a sparse graph laplacian, solved with Jacobi preconditioned conjugate gradients.
+ */
+std::vector<double> SolvePositions(const std::vector<TilePair>& pairs, const std::vector<double>& nominal, size_t axis)
+{
+  const double prior = 1.0e-4;
+  const size_t numTiles = nominal.size();
+  std::vector<double> diagonal(numTiles, prior);
+  std::vector<double> rhs(numTiles);
+  for(size_t i = 0; i < numTiles; i++)
+  {
+    rhs[i] = prior * nominal[i];
+  }
+  for(const TilePair& pair : pairs)
+  {
+    diagonal[pair.fixed] += pair.weight;
+    diagonal[pair.moving] += pair.weight;
+    rhs[pair.moving] += pair.weight * pair.offset[axis];
+    rhs[pair.fixed] -= pair.weight * pair.offset[axis];
+  }
+
+  auto multiply = [&](const std::vector<double>& x, std::vector<double>& result) {
+    for(size_t i = 0; i < numTiles; i++)
+    {
+      result[i] = diagonal[i] * x[i];
+    }
+    for(const TilePair& pair : pairs)
+    {
+      result[pair.fixed] -= pair.weight * x[pair.moving];
+      result[pair.moving] -= pair.weight * x[pair.fixed];
+    }
+  };
+  auto dot = [](const std::vector<double>& a, const std::vector<double>& b) {
+    double sum = 0.0;
+    for(size_t i = 0; i < a.size(); i++)
+    {
+      sum += a[i] * b[i];
+    }
+    return sum;
+  };
+
+  std::vector<double> x = nominal;
+  std::vector<double> residual(numTiles);
+  std::vector<double> z(numTiles);
+  std::vector<double> direction(numTiles);
+  std::vector<double> product(numTiles);
+  multiply(x, product);
+  for(size_t i = 0; i < numTiles; i++)
+  {
+    residual[i] = rhs[i] - product[i];
+    z[i] = residual[i] / diagonal[i];
+  }
+  direction = z;
+  double rz = dot(residual, z);
+  const double tolerance = 1.0e-20 * std::max(1.0, dot(rhs, rhs));
+  for(size_t iteration = 0; iteration < 10 * numTiles + 100 && dot(residual, residual) > tolerance; iteration++)
+  {
+    multiply(direction, product);
+    const double alpha = rz / dot(direction, product);
+    for(size_t i = 0; i < numTiles; i++)
+    {
+      x[i] += alpha * direction[i];
+      residual[i] -= alpha * product[i];
+      z[i] = residual[i] / diagonal[i];
+    }
+    const double rzNext = dot(residual, z);
+    const double beta = rzNext / rz;
+    rz = rzNext;
+    for(size_t i = 0; i < numTiles; i++)
+    {
+      direction[i] = z[i] + beta * direction[i];
+    }
+  }
+  return x;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ItkDetermineStitching::ItkDetermineStitching() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ItkDetermineStitching::~ItkDetermineStitching() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkDetermineStitching::setupFilterParameters()
+{
+  FilterParameterVectorType parameters;
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Tiles per Row", TilesPerRow, FilterParameter::Category::Parameter, ItkDetermineStitching));
+  parameters.push_back(SIMPL_NEW_FLOAT_FP("Nominal Overlap (%)", OverlapPercentage, FilterParameter::Category::Parameter, ItkDetermineStitching));
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Search Radius (Pixels)", MaxShift, FilterParameter::Category::Parameter, ItkDetermineStitching));
+  parameters.push_back(SeparatorFilterParameter::Create("Cell Data", FilterParameter::Category::RequiredArray));
+  {
+    AttributeMatrixSelectionFilterParameter::RequirementType req;
+    parameters.push_back(SIMPL_NEW_AM_SELECTION_FP("Image Tile Attribute Matrix", AttributeMatrixName, FilterParameter::Category::RequiredArray, ItkDetermineStitching, req));
+  }
+  {
+    DataArraySelectionFilterParameter::RequirementType req;
+    parameters.push_back(SIMPL_NEW_DA_SELECTION_FP("Image Tile Names", AttributeArrayNamesPath, FilterParameter::Category::RequiredArray, ItkDetermineStitching, req));
+  }
+  parameters.push_back(SeparatorFilterParameter::Create("Tile Data", FilterParameter::Category::CreatedArray));
+  parameters.push_back(SIMPL_NEW_STRING_FP("Tile Attribute Matrix", TileAttributeMatrixName, FilterParameter::Category::CreatedArray, ItkDetermineStitching));
+  parameters.push_back(
+      SIMPL_NEW_DA_WITH_LINKED_AM_FP("Image Tile Origins", StitchedCoordinatesArrayName, AttributeMatrixName, TileAttributeMatrixName, FilterParameter::Category::CreatedArray, ItkDetermineStitching));
+
+  setFilterParameters(parameters);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkDetermineStitching::readFilterParameters(AbstractFilterParametersReader* reader, int index)
+{
+  reader->openFilterGroup(this, index);
+  setAttributeMatrixName(reader->readDataArrayPath("AttributeMatrixName", getAttributeMatrixName()));
+  setAttributeArrayNamesPath(reader->readDataArrayPath("AttributeArrayNamesPath", getAttributeArrayNamesPath()));
+  setTilesPerRow(reader->readValue("TilesPerRow", getTilesPerRow()));
+  setOverlapPercentage(reader->readValue("OverlapPercentage", getOverlapPercentage()));
+  setMaxShift(reader->readValue("MaxShift", getMaxShift()));
+  setTileAttributeMatrixName(reader->readString("TileAttributeMatrixName", getTileAttributeMatrixName()));
+  setStitchedCoordinatesArrayName(reader->readString("StitchedCoordinatesArrayName", getStitchedCoordinatesArrayName()));
+  reader->closeFilterGroup();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkDetermineStitching::initialize()
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkDetermineStitching::dataCheck()
+{
+  clearErrorCode();
+  clearWarningCode();
+  DataArrayPath tempPath;
+
+  if(m_TilesPerRow < 1)
+  {
+    setErrorCondition(-5582, QObject::tr("There must be at least 1 tile per row"));
+    return;
+  }
+  if(m_OverlapPercentage <= 0.0f || m_OverlapPercentage >= 100.0f)
+  {
+    setErrorCondition(-5583, QObject::tr("The nominal overlap must be between 0 and 100 percent"));
+    return;
+  }
+  if(m_MaxShift < 0)
+  {
+    setErrorCondition(-5584, QObject::tr("The search radius cannot be negative"));
+    return;
+  }
+
+  AttributeMatrix::Pointer am = getDataContainerArray()->getAttributeMatrix(m_AttributeMatrixName);
+  if(nullptr == am.get())
+  {
+    setErrorCondition(-76000, "The attribute matrix has not been selected properly");
+    return;
+  }
+
+  std::vector<size_t> dims(1, 1);
+  m_AttributeArrayNamesPtr = getDataContainerArray()->getPrereqArrayFromPath<StringDataArray>(this, getAttributeArrayNamesPath(), dims);
+  StringDataArray::Pointer namesPtr = m_AttributeArrayNamesPtr.lock();
+  if(getErrorCode() < 0 || nullptr == namesPtr)
+  {
+    return;
+  }
+  for(size_t i = 0; i < namesPtr->getNumberOfTuples(); i++)
+  {
+    tempPath.update(getAttributeMatrixName().getDataContainerName(), getAttributeMatrixName().getAttributeMatrixName(), namesPtr->getValue(i));
+    getDataContainerArray()->getPrereqArrayFromPath<UInt8ArrayType>(this, tempPath, dims);
+    if(getErrorCode() < 0)
+    {
+      return;
+    }
+  }
+
+  //one tuple per tile, in the data container of the tiles
+  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getAttributeMatrixName().getDataContainerName());
+  std::vector<size_t> tDims(1, namesPtr->getNumberOfTuples());
+  m->createNonPrereqAttributeMatrix(this, getTileAttributeMatrixName(), tDims, AttributeMatrix::Type::Generic, AttributeMatrixID21);
+  if(getErrorCode() < 0)
+  {
+    return;
+  }
+  dims[0] = 2;
+  tempPath.update(getAttributeMatrixName().getDataContainerName(), getTileAttributeMatrixName(), getStitchedCoordinatesArrayName());
+  m_StitchedCoordinatesPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<float>>(this, tempPath, 0, dims, "", DataArrayID31);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkDetermineStitching::execute()
+{
+  dataCheck();
+  if(getErrorCode() < 0)
+  {
+    return;
+  }
+
+  AttributeMatrix::Pointer am = getDataContainerArray()->getAttributeMatrix(m_AttributeMatrixName);
+  StringDataArray::Pointer namesPtr = m_AttributeArrayNamesPtr.lock();
+  const size_t numTiles = namesPtr->getNumberOfTuples();
+  std::vector<size_t> udims = am->getTupleDimensions();
+  const size_t tileDims[2] = {udims[0], udims.size() > 1 ? udims[1] : 1};
+
+  DataArrayPath tempPath;
+  std::vector<size_t> cDims(1, 1);
+  std::vector<const uint8_t*> tiles(numTiles, nullptr);
+  for(size_t i = 0; i < numTiles; i++)
+  {
+    tempPath.update(getAttributeMatrixName().getDataContainerName(), getAttributeMatrixName().getAttributeMatrixName(), namesPtr->getValue(i));
+    UInt8ArrayType::Pointer imagePtr = getDataContainerArray()->getPrereqArrayFromPath<UInt8ArrayType>(this, tempPath, cDims);
+    if(getErrorCode() < 0 || nullptr == imagePtr)
+    {
+      return;
+    }
+    tiles[i] = imagePtr->getPointer(0);
+  }
+
+  //tiles are laid out row by row on a grid with the nominal overlap
+  const size_t tilesPerRow = static_cast<size_t>(m_TilesPerRow);
+  size_t overlap[2] = {0, 0};
+  for(size_t d = 0; d < 2; d++)
+  {
+    overlap[d] = static_cast<size_t>(std::lround(tileDims[d] * m_OverlapPercentage / 100.0f));
+    overlap[d] = std::min(std::max<size_t>(overlap[d], 1), std::max<size_t>(tileDims[d], 2) - 1);
+  }
+  std::vector<double> nominalX(numTiles);
+  std::vector<double> nominalY(numTiles);
+  std::vector<TilePair> pairs;
+  for(size_t i = 0; i < numTiles; i++)
+  {
+    nominalX[i] = static_cast<double>((i % tilesPerRow) * (tileDims[0] - overlap[0]));
+    nominalY[i] = static_cast<double>((i / tilesPerRow) * (tileDims[1] - overlap[1]));
+    if(i % tilesPerRow + 1 < tilesPerRow && i + 1 < numTiles)
+    {
+      pairs.push_back({i, i + 1, 0, {0.0, 0.0}, 0.0});
+    }
+    if(i + tilesPerRow < numTiles)
+    {
+      pairs.push_back({i, i + tilesPerRow, 1, {0.0, 0.0}, 0.0});
+    }
+  }
+
+  notifyStatusMessage(QObject::tr("Correlating %1 Tile Overlaps").arg(pairs.size()));
+  OverlapCorrelation correlation(tileDims, overlap, static_cast<size_t>(m_MaxShift));
+  ParallelDataAlgorithm dataAlg;
+  dataAlg.setRange(0, pairs.size());
+  dataAlg.execute(PairImpl(correlation, tiles, pairs));
+  if(getCancel())
+  {
+    return;
+  }
+
+  notifyStatusMessage(QObject::tr("Solving Tile Positions"));
+  std::vector<double> positionsX = SolvePositions(pairs, nominalX, 0);
+  std::vector<double> positionsY = SolvePositions(pairs, nominalY, 1);
+
+  std::vector<size_t> tDims(1, numTiles);
+  getDataContainerArray()->getDataContainer(getAttributeMatrixName().getDataContainerName())->getAttributeMatrix(getTileAttributeMatrixName())->resizeAttributeArrays(tDims);
+  float* origins = m_StitchedCoordinatesPtr.lock()->getPointer(0);
+  for(size_t i = 0; i < numTiles; i++)
+  {
+    origins[2 * i] = static_cast<float>(positionsX[i]);
+    origins[2 * i + 1] = static_cast<float>(positionsY[i]);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer ItkDetermineStitching::newFilterInstance(bool copyFilterParameters) const
+{
+  ItkDetermineStitching::Pointer filter = ItkDetermineStitching::New();
+  if(copyFilterParameters)
+  {
+    copyFilterParameterInstanceVariables(filter.get());
+  }
+  return filter;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ItkDetermineStitching::getCompiledLibraryName() const
+{return ImageProcessingConstants::ImageProcessingBaseName;}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ItkDetermineStitching::getGroupName() const
+{return SIMPL::FilterGroups::Unsupported;}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QUuid ItkDetermineStitching::getUuid() const
+{
+  return QUuid("{5c8e2a41-9f37-5d06-b1e4-7a2d6f93c058}");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ItkDetermineStitching::getSubGroupName() const
+{return "Misc";}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ItkDetermineStitching::getHumanLabel() const
+{ return "Determine Stitching (ImageProcessing)"; }
+
+// -----------------------------------------------------------------------------
+ItkDetermineStitching::Pointer ItkDetermineStitching::NullPointer()
+{
+  return Pointer(static_cast<Self*>(nullptr));
+}
+
+// -----------------------------------------------------------------------------
+std::shared_ptr<ItkDetermineStitching> ItkDetermineStitching::New()
+{
+  struct make_shared_enabler : public ItkDetermineStitching
+  {
+  };
+  std::shared_ptr<make_shared_enabler> val = std::make_shared<make_shared_enabler>();
+  val->setupFilterParameters();
+  return val;
+}
+
+// -----------------------------------------------------------------------------
+QString ItkDetermineStitching::getNameOfClass() const
+{
+  return QString("ItkDetermineStitching");
+}
+
+// -----------------------------------------------------------------------------
+QString ItkDetermineStitching::ClassName()
+{
+  return QString("ItkDetermineStitching");
+}
+
+// -----------------------------------------------------------------------------
+void ItkDetermineStitching::setAttributeMatrixName(const DataArrayPath& value)
+{
+  m_AttributeMatrixName = value;
+}
+
+// -----------------------------------------------------------------------------
+DataArrayPath ItkDetermineStitching::getAttributeMatrixName() const
+{
+  return m_AttributeMatrixName;
+}
+
+// -----------------------------------------------------------------------------
+void ItkDetermineStitching::setAttributeArrayNamesPath(const DataArrayPath& value)
+{
+  m_AttributeArrayNamesPath = value;
+}
+
+// -----------------------------------------------------------------------------
+DataArrayPath ItkDetermineStitching::getAttributeArrayNamesPath() const
+{
+  return m_AttributeArrayNamesPath;
+}
+
+// -----------------------------------------------------------------------------
+void ItkDetermineStitching::setTilesPerRow(int value)
+{
+  m_TilesPerRow = value;
+}
+
+// -----------------------------------------------------------------------------
+int ItkDetermineStitching::getTilesPerRow() const
+{
+  return m_TilesPerRow;
+}
+
+// -----------------------------------------------------------------------------
+void ItkDetermineStitching::setOverlapPercentage(float value)
+{
+  m_OverlapPercentage = value;
+}
+
+// -----------------------------------------------------------------------------
+float ItkDetermineStitching::getOverlapPercentage() const
+{
+  return m_OverlapPercentage;
+}
+
+// -----------------------------------------------------------------------------
+void ItkDetermineStitching::setMaxShift(int value)
+{
+  m_MaxShift = value;
+}
+
+// -----------------------------------------------------------------------------
+int ItkDetermineStitching::getMaxShift() const
+{
+  return m_MaxShift;
+}
+
+// -----------------------------------------------------------------------------
+void ItkDetermineStitching::setTileAttributeMatrixName(const QString& value)
+{
+  m_TileAttributeMatrixName = value;
+}
+
+// -----------------------------------------------------------------------------
+QString ItkDetermineStitching::getTileAttributeMatrixName() const
+{
+  return m_TileAttributeMatrixName;
+}
+
+// -----------------------------------------------------------------------------
+void ItkDetermineStitching::setStitchedCoordinatesArrayName(const QString& value)
+{
+  m_StitchedCoordinatesArrayName = value;
+}
+
+// -----------------------------------------------------------------------------
+QString ItkDetermineStitching::getStitchedCoordinatesArrayName() const
+{
+  return m_StitchedCoordinatesArrayName;
+}
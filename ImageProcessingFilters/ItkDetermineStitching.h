@@ -0,0 +1,269 @@
+/* ============================================================================
+ * Copyright (c) 2014 William Lenthe
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of William Lenthe or any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  This code was partially written under United States Air Force Contract number
+ *                              FA8650-10-D-5210
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <memory>
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/DataArrays/StringDataArray.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+#include "SIMPLib/DataArrays/DataArray.hpp"
+
+#include "ImageProcessing/ImageProcessingConstants.h"
+
+#include "ImageProcessing/ImageProcessingDLLExport.h"
+
+/**
+ * @class ItkDetermineStitching ItkDetermineStitching.h ImageProcessing/ImageProcessingFilters/ItkDetermineStitching.h
+ * @brief Finds the origins of a grid of overlapping image tiles from the correlation of their overlaps
+ * @author
+ * @date
+ * @version 1.0
+ */
+class ImageProcessing_EXPORT ItkDetermineStitching : public AbstractFilter
+{
+    Q_OBJECT
+
+    // Start Python bindings declarations
+    PYB11_BEGIN_BINDINGS(ItkDetermineStitching SUPERCLASS AbstractFilter)
+    PYB11_FILTER()
+    PYB11_SHARED_POINTERS(ItkDetermineStitching)
+    PYB11_FILTER_NEW_MACRO(ItkDetermineStitching)
+    PYB11_PROPERTY(DataArrayPath AttributeMatrixName READ getAttributeMatrixName WRITE setAttributeMatrixName)
+    PYB11_PROPERTY(DataArrayPath AttributeArrayNamesPath READ getAttributeArrayNamesPath WRITE setAttributeArrayNamesPath)
+    PYB11_PROPERTY(int TilesPerRow READ getTilesPerRow WRITE setTilesPerRow)
+    PYB11_PROPERTY(float OverlapPercentage READ getOverlapPercentage WRITE setOverlapPercentage)
+    PYB11_PROPERTY(int MaxShift READ getMaxShift WRITE setMaxShift)
+    PYB11_PROPERTY(QString TileAttributeMatrixName READ getTileAttributeMatrixName WRITE setTileAttributeMatrixName)
+    PYB11_PROPERTY(QString StitchedCoordinatesArrayName READ getStitchedCoordinatesArrayName WRITE setStitchedCoordinatesArrayName)
+    PYB11_END_BINDINGS()
+    // End Python bindings declarations
+
+  public:
+    using Self = ItkDetermineStitching;
+    using Pointer = std::shared_ptr<Self>;
+    using ConstPointer = std::shared_ptr<const Self>;
+    using WeakPointer = std::weak_ptr<Self>;
+    using ConstWeakPointer = std::weak_ptr<const Self>;
+    static Pointer NullPointer();
+
+    static std::shared_ptr<ItkDetermineStitching> New();
+
+    /**
+     * @brief Returns the name of the class for ItkDetermineStitching
+     */
+    QString getNameOfClass() const override;
+    /**
+     * @brief Returns the name of the class for ItkDetermineStitching
+     */
+    static QString ClassName();
+
+    ~ItkDetermineStitching() override;
+
+    /**
+     * @brief Setter property for AttributeMatrixName
+     */
+    void setAttributeMatrixName(const DataArrayPath& value);
+    /**
+     * @brief Getter property for AttributeMatrixName
+     * @return Value of AttributeMatrixName
+     */
+    DataArrayPath getAttributeMatrixName() const;
+
+    Q_PROPERTY(DataArrayPath AttributeMatrixName READ getAttributeMatrixName WRITE setAttributeMatrixName)
+
+    /**
+     * @brief Setter property for AttributeArrayNamesPath
+     */
+    void setAttributeArrayNamesPath(const DataArrayPath& value);
+    /**
+     * @brief Getter property for AttributeArrayNamesPath
+     * @return Value of AttributeArrayNamesPath
+     */
+    DataArrayPath getAttributeArrayNamesPath() const;
+
+    Q_PROPERTY(DataArrayPath AttributeArrayNamesPath READ getAttributeArrayNamesPath WRITE setAttributeArrayNamesPath)
+
+    /**
+     * @brief Setter property for TilesPerRow
+     */
+    void setTilesPerRow(int value);
+    /**
+     * @brief Getter property for TilesPerRow
+     * @return Value of TilesPerRow
+     */
+    int getTilesPerRow() const;
+
+    Q_PROPERTY(int TilesPerRow READ getTilesPerRow WRITE setTilesPerRow)
+
+    /**
+     * @brief Setter property for OverlapPercentage
+     */
+    void setOverlapPercentage(float value);
+    /**
+     * @brief Getter property for OverlapPercentage
+     * @return Value of OverlapPercentage
+     */
+    float getOverlapPercentage() const;
+
+    Q_PROPERTY(float OverlapPercentage READ getOverlapPercentage WRITE setOverlapPercentage)
+
+    /**
+     * @brief Setter property for MaxShift
+     */
+    void setMaxShift(int value);
+    /**
+     * @brief Getter property for MaxShift
+     * @return Value of MaxShift
+     */
+    int getMaxShift() const;
+
+    Q_PROPERTY(int MaxShift READ getMaxShift WRITE setMaxShift)
+
+    /**
+     * @brief Setter property for TileAttributeMatrixName
+     */
+    void setTileAttributeMatrixName(const QString& value);
+    /**
+     * @brief Getter property for TileAttributeMatrixName
+     * @return Value of TileAttributeMatrixName
+     */
+    QString getTileAttributeMatrixName() const;
+
+    Q_PROPERTY(QString TileAttributeMatrixName READ getTileAttributeMatrixName WRITE setTileAttributeMatrixName)
+
+    /**
+     * @brief Setter property for StitchedCoordinatesArrayName
+     */
+    void setStitchedCoordinatesArrayName(const QString& value);
+    /**
+     * @brief Getter property for StitchedCoordinatesArrayName
+     * @return Value of StitchedCoordinatesArrayName
+     */
+    QString getStitchedCoordinatesArrayName() const;
+
+    Q_PROPERTY(QString StitchedCoordinatesArrayName READ getStitchedCoordinatesArrayName WRITE setStitchedCoordinatesArrayName)
+
+    /**
+     * @brief getCompiledLibraryName Returns the name of the Library that this filter is a part of
+     * @return
+     */
+    QString getCompiledLibraryName() const override;
+
+    /**
+    * @brief This returns a string that is displayed in the GUI. It should be readable
+    * and understandable by humans.
+    */
+    QString getHumanLabel() const override;
+
+    /**
+    * @brief This returns the group that the filter belonds to. You can select
+    * a different group if you want. The string returned here will be displayed
+    * in the GUI for the filter
+    */
+    QString getGroupName() const override;
+
+    /**
+    * @brief This returns a string that is displayed in the GUI and helps to sort the filters into
+    * a subgroup. It should be readable and understandable by humans.
+    */
+    QString getSubGroupName() const override;
+
+    /**
+     * @brief getUuid Return the unique identifier for this filter.
+     * @return A QUuid object.
+     */
+    QUuid getUuid() const override;
+
+    /**
+    * @brief This method will instantiate all the end user settable options/parameters
+    * for this filter
+    */
+    void setupFilterParameters() override;
+
+    /**
+    * @brief This method will read the options from a file
+    * @param reader The reader that is used to read the options from a file
+    * @param index The index to read the information from
+    */
+    void readFilterParameters(AbstractFilterParametersReader* reader, int index) override;
+
+    /**
+     * @brief Reimplemented from @see AbstractFilter class
+     */
+    void execute() override;
+
+
+    /**
+     * @brief newFilterInstance Returns a new instance of the filter optionally copying the filter parameters from the
+     * current filter to the new instance.
+     * @param copyFilterParameters
+     * @return
+     */
+    AbstractFilter::Pointer newFilterInstance(bool copyFilterParameters) const override;
+
+  protected:
+    ItkDetermineStitching();
+
+    /**
+     * @brief dataCheck Checks for the appropriate parameter values and availability of arrays
+     */
+    void dataCheck() override;
+
+    /**
+     * @brief Initializes all the private instance variables.
+     */
+    void initialize();
+
+
+  private:
+    StringDataArray::WeakPointer m_AttributeArrayNamesPtr;
+    std::weak_ptr<DataArray<float>> m_StitchedCoordinatesPtr;
+
+    DataArrayPath m_AttributeMatrixName = {SIMPL::Defaults::ImageDataContainerName, SIMPL::Defaults::CellAttributeMatrixName, ""};
+    DataArrayPath m_AttributeArrayNamesPath = {};
+    int m_TilesPerRow = {2};
+    float m_OverlapPercentage = {10.0f};
+    int m_MaxShift = {20};
+    QString m_TileAttributeMatrixName = {"TileData"};
+    QString m_StitchedCoordinatesArrayName = {"StitchedCoordinates"};
+
+  public:
+    ItkDetermineStitching(const ItkDetermineStitching&) = delete; // Copy Constructor Not Implemented
+    ItkDetermineStitching(ItkDetermineStitching&&) = delete;      // Move Constructor Not Implemented
+    ItkDetermineStitching& operator=(const ItkDetermineStitching&) = delete; // Copy Assignment Not Implemented
+    ItkDetermineStitching& operator=(ItkDetermineStitching&&) = delete;      // Move Assignment Not Implemented
+};
+
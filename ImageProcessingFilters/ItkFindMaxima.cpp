@@ -35,10 +35,15 @@
 
 #include "ItkFindMaxima.h"
 
+#include <algorithm>
+
+#include <QtCore/QStringList>
+
 #include "SIMPLib/Common/TemplateHelpers.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/FloatFilterParameter.h"
+#include "SIMPLib/FilterParameters/LinkedBooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/LinkedPathCreationFilterParameter.h"
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
@@ -56,6 +61,63 @@
 #include "itkFloodFilledImageFunctionConditionalIterator.h"
 #include "itkRegionalMaximaImageFilter.h"
 
+/* Create Enumerations to allow the created Attribute Arrays to take part in renaming */
+enum createdPathID : RenameDataPath::DataID_t
+{
+  AttributeMatrixID21 = 21,
+  AttributeMatrixID22 = 22,
+
+  DataArrayID31 = 31,
+  DataArrayID32 = 32,
+  DataArrayID33 = 33,
+  DataArrayID34 = 34,
+  DataArrayID35 = 35,
+  DataArrayID36 = 36,
+  DataArrayID37 = 37,
+  DataArrayID38 = 38,
+  DataArrayID39 = 39,
+  DataArrayID40 = 40,
+
+  ToleranceMaskID100 = 100, //first of one id per additional tolerance mask
+};
+
+namespace
+{
+//arrays of the peak list attribute matrix
+const QString k_CentroidsArrayName("Centroids");
+const QString k_VoxelIndicesArrayName("VoxelIndices");
+const QString k_IntensityArrayName("Intensity");
+const QString k_ProminenceArrayName("Prominence");
+//further arrays of the regional maxima attribute matrix
+const QString k_VoxelCountArrayName("VoxelCount");
+const QString k_MergeParentArrayName("MergeParent");
+} // namespace
+
+/**
+ * @brief The FindMaximaOutputs struct collects the requested outputs (outputs that weren't requested are null / empty)
+ */
+struct FindMaximaOutputs
+{
+  bool* mask = nullptr;
+  std::vector<float> tolerances;
+  std::vector<bool*> toleranceMasks;
+
+  //table of every regional maximum: mean voxel index (3 per maximum), voxel count, intensity, prominence and the
+  //equal valued maximum it merges into (1 based, 0 for none)
+  bool maximaTable = false;
+  std::vector<float> maximaPositions;
+  std::vector<int32_t> maximaCounts;
+  std::vector<float> maximaIntensities;
+  std::vector<float> maximaProminences;
+  std::vector<int32_t> maximaParents;
+
+  //sparse list of the peaks: voxel index (3 per peak), intensity and, with the maxima table, prominence
+  bool peakList = false;
+  std::vector<int32_t> peakIndices;
+  std::vector<float> peakIntensities;
+  std::vector<float> peakProminences;
+};
+
 /**
  * @brief This is a private implementation for the filter that handles the actual algorithm implementation details
  * for us like figuring out if we can use this private implementation with the data array that is assigned.
@@ -65,6 +127,8 @@ class FindMaximaPrivate
 {
   public:
     typedef DataArray<PixelType> DataArrayType;
+    typedef itk::Image<PixelType, ImageProcessingConstants::ImageDimension> ImageType;
+    typedef ImageProcessing::LocalMaxima<ImageType> LocalMaximaType;
 
     FindMaximaPrivate() = default;
     virtual ~FindMaximaPrivate() = default;
@@ -80,42 +144,120 @@ class FindMaximaPrivate
     // -----------------------------------------------------------------------------
     // This is the actual templated algorithm
     // -----------------------------------------------------------------------------
-    void static Execute(ItkFindMaxima* filter, IDataArray::Pointer inputArray, double tolerance, bool* outputData, DataContainer::Pointer m, QString attrMatName)
+    void static Execute(ItkFindMaxima* filter, IDataArray::Pointer inputArray, double tolerance, FindMaximaOutputs& outputs, DataContainer::Pointer m, QString attrMatName)
     {
       typename DataArrayType::Pointer inputArrayPtr = std::dynamic_pointer_cast<DataArrayType>(inputArray);
 
       //convert array to correct type
       PixelType* inputData = static_cast<PixelType*>(inputArrayPtr->getPointer(0));
+      size_t numVoxels = inputArrayPtr->getNumberOfTuples();
 
-      //size_t numVoxels = inputArrayPtr->getNumberOfTuples();
-
-//      typedef ItkBridge<PixelType> ItkBridgeType;
-
-      //wrap input and output as itk image
-      typedef itk::Image<PixelType, ImageProcessingConstants::ImageDimension> ImageType;
-      typedef itk::Image<bool, ImageProcessingConstants::ImageDimension> BoolImageType;
+      //wrap input as itk image
       typename ImageType::Pointer inputImage = ItkBridge<PixelType>::CreateItkWrapperForDataPointer(m, attrMatName, inputData);
-      BoolImageType::Pointer outputImage = ItkBridge<bool>::CreateItkWrapperForDataPointer(m, attrMatName, outputData);
+      typename ImageType::SizeType size = inputImage->GetLargestPossibleRegion().GetSize();
 
       //find maxima
-      std::vector<typename ImageType::IndexType> peakLocations;
       try
       {
-        peakLocations = ImageProcessing::LocalMaxima<ImageType>::Find(inputImage, tolerance, true);
+        //the primary mask and the peak list always come from the flood search, so requesting other outputs never changes
+        //them. the flood only needs a few bytes per voxel, the prominence pass is only run for the outputs that need it
+        std::vector<typename LocalMaximaType::FoundPeak> found;
+        std::vector<int64_t> peakOfMaximum;
+        if(nullptr != outputs.mask || outputs.peakList)
+        {
+          found = LocalMaximaType::FindPeaks(inputImage, tolerance, true, outputs.peakList && outputs.maximaTable ? &peakOfMaximum : nullptr);
+        }
+        if(nullptr != outputs.mask)
+        {
+          std::vector<typename ImageType::IndexType> peakLocations;
+          peakLocations.reserve(found.size());
+          for(size_t i = 0; i < found.size(); i++)
+          {
+            peakLocations.push_back(found[i].index);
+          }
+          WriteMask(peakLocations, size, outputs.mask, numVoxels);
+        }
+        if(outputs.peakList)
+        {
+          for(size_t i = 0; i < found.size(); i++)
+          {
+            for(unsigned int k = 0; k < 3; k++)
+            {
+              outputs.peakIndices.push_back(k < ImageType::ImageDimension ? static_cast<int32_t>(found[i].index[k]) : 0);
+            }
+            outputs.peakIntensities.push_back(static_cast<float>(found[i].value));
+          }
+        }
+        if(outputs.toleranceMasks.empty() && !outputs.maximaTable)
+        {
+          return;
+        }
+
+        //a single pass gives the prominence of every maximum, each tolerance is then a cut of it
+        std::vector<typename LocalMaximaType::Peak> peaks = LocalMaximaType::Prominence(inputImage, true);
+        for(size_t i = 0; i < outputs.toleranceMasks.size(); i++)
+        {
+          WriteMask(LocalMaximaType::Cut(peaks, outputs.tolerances[i]), size, outputs.toleranceMasks[i], numVoxels);
+        }
+
+        if(outputs.maximaTable)
+        {
+          for(size_t i = 0; i < peaks.size(); i++)
+          {
+            for(size_t k = 0; k < 3; k++)
+            {
+              outputs.maximaPositions.push_back(static_cast<float>(peaks[i].sum[k] / static_cast<double>(peaks[i].count)));
+            }
+            outputs.maximaCounts.push_back(static_cast<int32_t>(peaks[i].count));
+            outputs.maximaIntensities.push_back(static_cast<float>(peaks[i].value));
+            outputs.maximaProminences.push_back(static_cast<float>(peaks[i].prominence));
+            outputs.maximaParents.push_back(static_cast<int32_t>(peaks[i].parent + 1));
+          }
+        }
+
+        //a peak is as prominent as the most prominent of the maxima it combines
+        if(outputs.peakList && outputs.maximaTable)
+        {
+          outputs.peakProminences.assign(found.size(), 0.0f);
+          for(size_t i = 0; i < peakOfMaximum.size(); i++)
+          {
+            if(peakOfMaximum[i] >= 0)
+            {
+              float& prominence = outputs.peakProminences[static_cast<size_t>(peakOfMaximum[i])];
+              prominence = std::max(prominence, static_cast<float>(peaks[i].prominence));
+            }
+          }
+        }
       }
       catch( itk::ExceptionObject& err )
       {
         QString ss = QObject::tr("Failed to convert image. Error Message returned from ITK:\n   %1").arg(err.GetDescription());
         filter->setErrorCondition(-5, ss);
       }
+    }
 
-      //fill output data with false then set peaks to true
-      outputImage->FillBuffer(false);
+    // -----------------------------------------------------------------------------
+    // Fills a mask with false then sets the peaks to true
+    // -----------------------------------------------------------------------------
+    void static WriteMask(const std::vector<typename ImageType::IndexType>& peakLocations, const typename ImageType::SizeType& size, bool* mask, size_t numVoxels)
+    {
+      std::fill(mask, mask + numVoxels, false);
       for(size_t i = 0; i < peakLocations.size(); i++)
       {
-        outputImage->SetPixel(peakLocations[i], true);
+        mask[LinearIndex(peakLocations[i], size)] = true;
+      }
+    }
+
+    size_t static LinearIndex(const typename ImageType::IndexType& index, const typename ImageType::SizeType& size)
+    {
+      size_t linear = 0;
+      for(int k = ImageType::ImageDimension - 1; k >= 0; k--)
+      {
+        linear = linear * size[k] + static_cast<size_t>(index[k]);
       }
+      return linear;
     }
+
   private:
     FindMaximaPrivate(const FindMaximaPrivate&) = delete; // Copy Constructor Not Implemented
     void operator=(const FindMaximaPrivate&) = delete;    // Move assignment Not Implemented
@@ -143,9 +285,23 @@ void ItkFindMaxima::setupFilterParameters()
     parameters.push_back(SIMPL_NEW_DA_SELECTION_FP("Input Attribute Array", SelectedCellArrayPath, FilterParameter::Category::RequiredArray, ItkFindMaxima, req));
   }
   parameters.push_back(SIMPL_NEW_FLOAT_FP("Noise Tolerance", Tolerance, FilterParameter::Category::Parameter, ItkFindMaxima));
+  parameters.push_back(SIMPL_NEW_STRING_FP("Additional Noise Tolerances (comma separated)", AdditionalTolerances, FilterParameter::Category::Parameter, ItkFindMaxima));
+  QStringList linkedProps("MaximaAttributeMatrixName");
+  parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Save Peak Prominence", SaveProminence, FilterParameter::Category::Parameter, ItkFindMaxima, linkedProps));
+  {
+    QStringList linkedProps("NewCellArrayName");
+    parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Create Maxima Mask", CreateMask, FilterParameter::Category::Parameter, ItkFindMaxima, linkedProps));
+  }
+  {
+    QStringList linkedProps("PeakAttributeMatrixName");
+    parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Create Peak List", SavePeakList, FilterParameter::Category::Parameter, ItkFindMaxima, linkedProps));
+  }
   parameters.push_back(SeparatorFilterParameter::Create("Cell Data", FilterParameter::Category::CreatedArray));
   parameters.push_back(
       SIMPL_NEW_DA_WITH_LINKED_AM_FP("Output Attribute Array", NewCellArrayName, SelectedCellArrayPath, SelectedCellArrayPath, FilterParameter::Category::CreatedArray, ItkFindMaxima));
+  parameters.push_back(SeparatorFilterParameter::Create("Feature Data", FilterParameter::Category::CreatedArray));
+  parameters.push_back(SIMPL_NEW_STRING_FP("Peak Attribute Matrix", PeakAttributeMatrixName, FilterParameter::Category::CreatedArray, ItkFindMaxima));
+  parameters.push_back(SIMPL_NEW_STRING_FP("Regional Maxima Attribute Matrix", MaximaAttributeMatrixName, FilterParameter::Category::CreatedArray, ItkFindMaxima));
   setFilterParameters(parameters);
 }
 
@@ -158,6 +314,12 @@ void ItkFindMaxima::readFilterParameters(AbstractFilterParametersReader* reader,
   setSelectedCellArrayPath( reader->readDataArrayPath( "SelectedCellArrayPath", getSelectedCellArrayPath() ) );
   setTolerance( reader->readValue( "Tolerance", getTolerance() ) );
   setNewCellArrayName( reader->readString( "NewCellArrayName", getNewCellArrayName() ) );
+  setAdditionalTolerances( reader->readString( "AdditionalTolerances", getAdditionalTolerances() ) );
+  setSaveProminence( reader->readValue( "SaveProminence", getSaveProminence() ) );
+  setMaximaAttributeMatrixName( reader->readString( "MaximaAttributeMatrixName", getMaximaAttributeMatrixName() ) );
+  setCreateMask( reader->readValue( "CreateMask", getCreateMask() ) );
+  setSavePeakList( reader->readValue( "SavePeakList", getSavePeakList() ) );
+  setPeakAttributeMatrixName( reader->readString( "PeakAttributeMatrixName", getPeakAttributeMatrixName() ) );
   reader->closeFilterGroup();
 }
 
@@ -208,12 +370,87 @@ void ItkFindMaxima::dataCheck()
   {
     return;
   }
+  if(!m_CreateMask && !m_SavePeakList)
+  {
+    QString ss = QObject::tr("At least one of the maxima mask or the peak list must be created");
+    setErrorCondition(-5562, ss);
+    return;
+  }
+
   //create new boolean array
-  tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getSelectedCellArrayPath().getAttributeMatrixName(), getNewCellArrayName() );
-  m_NewCellArrayPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<bool>>(this, tempPath, false, compDims);
-  if(nullptr != m_NewCellArrayPtr.lock())
-  { m_NewCellArray = m_NewCellArrayPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
+  m_NewCellArray = nullptr;
+  if(m_CreateMask)
+  {
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getSelectedCellArrayPath().getAttributeMatrixName(), getNewCellArrayName() );
+    m_NewCellArrayPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<bool>>(this, tempPath, false, compDims, "", DataArrayID31);
+    if(nullptr != m_NewCellArrayPtr.lock())
+    { m_NewCellArray = m_NewCellArrayPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
+  }
 
+  //one feature per peak, the number of peaks is only known after the search
+  if(m_SavePeakList)
+  {
+    std::vector<size_t> tDims(1, 0);
+    dataContiner->createNonPrereqAttributeMatrix(this, getPeakAttributeMatrixName(), tDims, AttributeMatrix::Type::CellFeature, AttributeMatrixID21);
+    if(getErrorCode() < 0)
+    {
+      return;
+    }
+    std::vector<size_t> vectorDims(1, 3);
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getPeakAttributeMatrixName(), k_CentroidsArrayName);
+    m_PeakCentroidsPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<float>>(this, tempPath, 0, vectorDims, "", DataArrayID32);
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getPeakAttributeMatrixName(), k_VoxelIndicesArrayName);
+    m_PeakVoxelIndicesPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<int32_t>>(this, tempPath, 0, vectorDims, "", DataArrayID33);
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getPeakAttributeMatrixName(), k_IntensityArrayName);
+    m_PeakIntensityPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<float>>(this, tempPath, 0, compDims, "", DataArrayID34);
+    //the prominence of a peak needs the prominence pass, which is only run when the maxima table is saved
+    if(m_SaveProminence)
+    {
+      tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getPeakAttributeMatrixName(), k_ProminenceArrayName);
+      m_PeakProminencePtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<float>>(this, tempPath, 0, compDims, "", DataArrayID35);
+    }
+  }
+
+  //one more mask per additional tolerance
+  m_ToleranceValues.clear();
+  m_ToleranceMaskPtrs.clear();
+  QStringList tolerances = getAdditionalTolerances().split(',', QString::SkipEmptyParts);
+  for(int i = 0; i < tolerances.size(); i++)
+  {
+    bool ok = false;
+    float tolerance = tolerances[i].trimmed().toFloat(&ok);
+    if(!ok || tolerance < 0.0f)
+    {
+      QString ss = QObject::tr("'%1' is not a valid noise tolerance").arg(tolerances[i].trimmed());
+      setErrorCondition(-5561, ss);
+      return;
+    }
+    m_ToleranceValues.push_back(tolerance);
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getSelectedCellArrayPath().getAttributeMatrixName(), QString("%1_%2").arg(getNewCellArrayName()).arg(tolerance));
+    m_ToleranceMaskPtrs.push_back(getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<bool>>(this, tempPath, false, compDims, "", static_cast<RenameDataPath::DataID_t>(ToleranceMaskID100 + i)));
+  }
+
+  //one feature per regional maximum, with everything needed to cut the maxima at any tolerance afterwards
+  if(m_SaveProminence)
+  {
+    std::vector<size_t> tDims(1, 0);
+    dataContiner->createNonPrereqAttributeMatrix(this, getMaximaAttributeMatrixName(), tDims, AttributeMatrix::Type::CellFeature, AttributeMatrixID22);
+    if(getErrorCode() < 0)
+    {
+      return;
+    }
+    std::vector<size_t> vectorDims(1, 3);
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getMaximaAttributeMatrixName(), k_CentroidsArrayName);
+    m_MaximaCentroidsPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<float>>(this, tempPath, 0, vectorDims, "", DataArrayID36);
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getMaximaAttributeMatrixName(), k_VoxelCountArrayName);
+    m_MaximaVoxelCountPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<int32_t>>(this, tempPath, 0, compDims, "", DataArrayID37);
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getMaximaAttributeMatrixName(), k_IntensityArrayName);
+    m_MaximaIntensityPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<float>>(this, tempPath, 0, compDims, "", DataArrayID38);
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getMaximaAttributeMatrixName(), k_ProminenceArrayName);
+    m_MaximaProminencePtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<float>>(this, tempPath, 0, compDims, "", DataArrayID39);
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getMaximaAttributeMatrixName(), k_MergeParentArrayName);
+    m_MaximaMergeParentPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<int32_t>>(this, tempPath, 0, compDims, "", DataArrayID40);
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -236,6 +473,15 @@ void ItkFindMaxima::execute()
 
   //get input data
   IDataArray::Pointer inputData = m_SelectedCellArrayPtr.lock();
+  FindMaximaOutputs outputs;
+  outputs.mask = m_NewCellArray;
+  outputs.tolerances = m_ToleranceValues;
+  for(size_t i = 0; i < m_ToleranceMaskPtrs.size(); i++)
+  {
+    outputs.toleranceMasks.push_back(m_ToleranceMaskPtrs[i].lock()->getPointer(0));
+  }
+  outputs.maximaTable = m_SaveProminence;
+  outputs.peakList = m_SavePeakList;
 
   //execute type dependant portion using a Private Implementation that takes care of figuring out if
   // we can work on the correct type and actually handling the algorithm execution. We pass in "this" so
@@ -243,43 +489,43 @@ void ItkFindMaxima::execute()
   // progress or handle "cancel" if needed.
   if(FindMaximaPrivate<int8_t>()(inputData))
   {
-    FindMaximaPrivate<int8_t>::Execute(this, inputData, m_Tolerance, m_NewCellArray, m, attrMatName);
+    FindMaximaPrivate<int8_t>::Execute(this, inputData, m_Tolerance, outputs, m, attrMatName);
   }
   else if(FindMaximaPrivate<uint8_t>()(inputData) )
   {
-    FindMaximaPrivate<uint8_t>::Execute(this, inputData, m_Tolerance, m_NewCellArray, m, attrMatName);
+    FindMaximaPrivate<uint8_t>::Execute(this, inputData, m_Tolerance, outputs, m, attrMatName);
   }
   else if(FindMaximaPrivate<int16_t>()(inputData) )
   {
-    FindMaximaPrivate<int16_t>::Execute(this, inputData, m_Tolerance, m_NewCellArray, m, attrMatName);
+    FindMaximaPrivate<int16_t>::Execute(this, inputData, m_Tolerance, outputs, m, attrMatName);
   }
   else if(FindMaximaPrivate<uint16_t>()(inputData) )
   {
-    FindMaximaPrivate<uint16_t>::Execute(this, inputData, m_Tolerance, m_NewCellArray, m, attrMatName);
+    FindMaximaPrivate<uint16_t>::Execute(this, inputData, m_Tolerance, outputs, m, attrMatName);
   }
   else if(FindMaximaPrivate<int32_t>()(inputData) )
   {
-    FindMaximaPrivate<int32_t>::Execute(this, inputData, m_Tolerance, m_NewCellArray, m, attrMatName);
+    FindMaximaPrivate<int32_t>::Execute(this, inputData, m_Tolerance, outputs, m, attrMatName);
   }
   else if(FindMaximaPrivate<uint32_t>()(inputData) )
   {
-    FindMaximaPrivate<uint32_t>::Execute(this, inputData, m_Tolerance, m_NewCellArray, m, attrMatName);
+    FindMaximaPrivate<uint32_t>::Execute(this, inputData, m_Tolerance, outputs, m, attrMatName);
   }
   else if(FindMaximaPrivate<int64_t>()(inputData) )
   {
-    FindMaximaPrivate<int64_t>::Execute(this, inputData, m_Tolerance, m_NewCellArray, m, attrMatName);
+    FindMaximaPrivate<int64_t>::Execute(this, inputData, m_Tolerance, outputs, m, attrMatName);
   }
   else if(FindMaximaPrivate<uint64_t>()(inputData) )
   {
-    FindMaximaPrivate<uint64_t>::Execute(this, inputData, m_Tolerance, m_NewCellArray, m, attrMatName);
+    FindMaximaPrivate<uint64_t>::Execute(this, inputData, m_Tolerance, outputs, m, attrMatName);
   }
   else if(FindMaximaPrivate<float>()(inputData) )
   {
-    FindMaximaPrivate<float>::Execute(this, inputData, m_Tolerance, m_NewCellArray, m, attrMatName);
+    FindMaximaPrivate<float>::Execute(this, inputData, m_Tolerance, outputs, m, attrMatName);
   }
   else if(FindMaximaPrivate<double>()(inputData) )
   {
-    FindMaximaPrivate<double>::Execute(this, inputData, m_Tolerance, m_NewCellArray, m, attrMatName);
+    FindMaximaPrivate<double>::Execute(this, inputData, m_Tolerance, outputs, m, attrMatName);
   }
   else
   {
@@ -287,6 +533,75 @@ void ItkFindMaxima::execute()
     setErrorCondition(-10001, ss);
     return;
   }
+
+  if(m_SavePeakList && getErrorCode() >= 0)
+  {
+    //feature 0 is reserved, peak i is feature i + 1
+    size_t numPeaks = outputs.peakIntensities.size();
+    std::vector<size_t> tDims(1, numPeaks + 1);
+    m->getAttributeMatrix(getPeakAttributeMatrixName())->resizeAttributeArrays(tDims);
+    float* centroids = m_PeakCentroidsPtr.lock()->getPointer(0);
+    int32_t* voxelIndices = m_PeakVoxelIndicesPtr.lock()->getPointer(0);
+    float* intensity = m_PeakIntensityPtr.lock()->getPointer(0);
+    std::fill(centroids, centroids + 3, 0.0f);
+    std::fill(voxelIndices, voxelIndices + 3, 0);
+    intensity[0] = 0.0f;
+
+    //centroids are at voxel centers
+    ImageGeom::Pointer image = m->getGeometryAs<ImageGeom>();
+    FloatVec3Type origin = image->getOrigin();
+    FloatVec3Type spacing = image->getSpacing();
+    for(size_t i = 0; i < numPeaks; i++)
+    {
+      for(size_t k = 0; k < 3; k++)
+      {
+        voxelIndices[3 * (i + 1) + k] = outputs.peakIndices[3 * i + k];
+        centroids[3 * (i + 1) + k] = origin[k] + (static_cast<float>(outputs.peakIndices[3 * i + k]) + 0.5f) * spacing[k];
+      }
+      intensity[i + 1] = outputs.peakIntensities[i];
+    }
+
+    if(m_SaveProminence)
+    {
+      float* prominence = m_PeakProminencePtr.lock()->getPointer(0);
+      prominence[0] = 0.0f;
+      std::copy(outputs.peakProminences.begin(), outputs.peakProminences.end(), prominence + 1);
+    }
+  }
+
+  if(m_SaveProminence && getErrorCode() >= 0)
+  {
+    //feature 0 is reserved, maximum i is feature i + 1 and merge parents use the same numbering
+    size_t numMaxima = outputs.maximaIntensities.size();
+    std::vector<size_t> tDims(1, numMaxima + 1);
+    m->getAttributeMatrix(getMaximaAttributeMatrixName())->resizeAttributeArrays(tDims);
+    float* centroids = m_MaximaCentroidsPtr.lock()->getPointer(0);
+    int32_t* voxelCount = m_MaximaVoxelCountPtr.lock()->getPointer(0);
+    float* intensity = m_MaximaIntensityPtr.lock()->getPointer(0);
+    float* prominence = m_MaximaProminencePtr.lock()->getPointer(0);
+    int32_t* mergeParent = m_MaximaMergeParentPtr.lock()->getPointer(0);
+    std::fill(centroids, centroids + 3, 0.0f);
+    voxelCount[0] = 0;
+    intensity[0] = 0.0f;
+    prominence[0] = 0.0f;
+    mergeParent[0] = 0;
+
+    //centroids are the unrounded plateau means, so the voxel count weighted mean of merged maxima is exact
+    ImageGeom::Pointer image = m->getGeometryAs<ImageGeom>();
+    FloatVec3Type origin = image->getOrigin();
+    FloatVec3Type spacing = image->getSpacing();
+    for(size_t i = 0; i < numMaxima; i++)
+    {
+      for(size_t k = 0; k < 3; k++)
+      {
+        centroids[3 * (i + 1) + k] = origin[k] + (outputs.maximaPositions[3 * i + k] + 0.5f) * spacing[k];
+      }
+      voxelCount[i + 1] = outputs.maximaCounts[i];
+      intensity[i + 1] = outputs.maximaIntensities[i];
+      prominence[i + 1] = outputs.maximaProminences[i];
+      mergeParent[i + 1] = outputs.maximaParents[i];
+    }
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -402,3 +717,75 @@ QString ItkFindMaxima::getNewCellArrayName() const
 {
   return m_NewCellArrayName;
 }
+
+// -----------------------------------------------------------------------------
+void ItkFindMaxima::setAdditionalTolerances(const QString& value)
+{
+  m_AdditionalTolerances = value;
+}
+
+// -----------------------------------------------------------------------------
+QString ItkFindMaxima::getAdditionalTolerances() const
+{
+  return m_AdditionalTolerances;
+}
+
+// -----------------------------------------------------------------------------
+void ItkFindMaxima::setSaveProminence(bool value)
+{
+  m_SaveProminence = value;
+}
+
+// -----------------------------------------------------------------------------
+bool ItkFindMaxima::getSaveProminence() const
+{
+  return m_SaveProminence;
+}
+
+// -----------------------------------------------------------------------------
+void ItkFindMaxima::setMaximaAttributeMatrixName(const QString& value)
+{
+  m_MaximaAttributeMatrixName = value;
+}
+
+// -----------------------------------------------------------------------------
+QString ItkFindMaxima::getMaximaAttributeMatrixName() const
+{
+  return m_MaximaAttributeMatrixName;
+}
+
+// -----------------------------------------------------------------------------
+void ItkFindMaxima::setCreateMask(bool value)
+{
+  m_CreateMask = value;
+}
+
+// -----------------------------------------------------------------------------
+bool ItkFindMaxima::getCreateMask() const
+{
+  return m_CreateMask;
+}
+
+// -----------------------------------------------------------------------------
+void ItkFindMaxima::setSavePeakList(bool value)
+{
+  m_SavePeakList = value;
+}
+
+// -----------------------------------------------------------------------------
+bool ItkFindMaxima::getSavePeakList() const
+{
+  return m_SavePeakList;
+}
+
+// -----------------------------------------------------------------------------
+void ItkFindMaxima::setPeakAttributeMatrixName(const QString& value)
+{
+  m_PeakAttributeMatrixName = value;
+}
+
+// -----------------------------------------------------------------------------
+QString ItkFindMaxima::getPeakAttributeMatrixName() const
+{
+  return m_PeakAttributeMatrixName;
+}
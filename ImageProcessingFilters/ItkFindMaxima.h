@@ -34,7 +34,7 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #pragma once
 
-//#include <vector>
+#include <vector>
 #include <memory>
 
 #include <QtCore/QString>
@@ -71,6 +71,12 @@ class ImageProcessing_EXPORT ItkFindMaxima : public AbstractFilter
     PYB11_PROPERTY(DataArrayPath SelectedCellArrayPath READ getSelectedCellArrayPath WRITE setSelectedCellArrayPath)
     PYB11_PROPERTY(float Tolerance READ getTolerance WRITE setTolerance)
     PYB11_PROPERTY(QString NewCellArrayName READ getNewCellArrayName WRITE setNewCellArrayName)
+    PYB11_PROPERTY(QString AdditionalTolerances READ getAdditionalTolerances WRITE setAdditionalTolerances)
+    PYB11_PROPERTY(bool SaveProminence READ getSaveProminence WRITE setSaveProminence)
+    PYB11_PROPERTY(QString MaximaAttributeMatrixName READ getMaximaAttributeMatrixName WRITE setMaximaAttributeMatrixName)
+    PYB11_PROPERTY(bool CreateMask READ getCreateMask WRITE setCreateMask)
+    PYB11_PROPERTY(bool SavePeakList READ getSavePeakList WRITE setSavePeakList)
+    PYB11_PROPERTY(QString PeakAttributeMatrixName READ getPeakAttributeMatrixName WRITE setPeakAttributeMatrixName)
     PYB11_END_BINDINGS()
     // End Python bindings declarations
 
@@ -131,6 +137,78 @@ class ImageProcessing_EXPORT ItkFindMaxima : public AbstractFilter
 
     Q_PROPERTY(QString NewCellArrayName READ getNewCellArrayName WRITE setNewCellArrayName)
 
+    /**
+     * @brief Setter property for AdditionalTolerances
+     */
+    void setAdditionalTolerances(const QString& value);
+    /**
+     * @brief Getter property for AdditionalTolerances
+     * @return Value of AdditionalTolerances
+     */
+    QString getAdditionalTolerances() const;
+
+    Q_PROPERTY(QString AdditionalTolerances READ getAdditionalTolerances WRITE setAdditionalTolerances)
+
+    /**
+     * @brief Setter property for SaveProminence
+     */
+    void setSaveProminence(bool value);
+    /**
+     * @brief Getter property for SaveProminence
+     * @return Value of SaveProminence
+     */
+    bool getSaveProminence() const;
+
+    Q_PROPERTY(bool SaveProminence READ getSaveProminence WRITE setSaveProminence)
+
+    /**
+     * @brief Setter property for MaximaAttributeMatrixName
+     */
+    void setMaximaAttributeMatrixName(const QString& value);
+    /**
+     * @brief Getter property for MaximaAttributeMatrixName
+     * @return Value of MaximaAttributeMatrixName
+     */
+    QString getMaximaAttributeMatrixName() const;
+
+    Q_PROPERTY(QString MaximaAttributeMatrixName READ getMaximaAttributeMatrixName WRITE setMaximaAttributeMatrixName)
+
+    /**
+     * @brief Setter property for CreateMask
+     */
+    void setCreateMask(bool value);
+    /**
+     * @brief Getter property for CreateMask
+     * @return Value of CreateMask
+     */
+    bool getCreateMask() const;
+
+    Q_PROPERTY(bool CreateMask READ getCreateMask WRITE setCreateMask)
+
+    /**
+     * @brief Setter property for SavePeakList
+     */
+    void setSavePeakList(bool value);
+    /**
+     * @brief Getter property for SavePeakList
+     * @return Value of SavePeakList
+     */
+    bool getSavePeakList() const;
+
+    Q_PROPERTY(bool SavePeakList READ getSavePeakList WRITE setSavePeakList)
+
+    /**
+     * @brief Setter property for PeakAttributeMatrixName
+     */
+    void setPeakAttributeMatrixName(const QString& value);
+    /**
+     * @brief Getter property for PeakAttributeMatrixName
+     * @return Value of PeakAttributeMatrixName
+     */
+    QString getPeakAttributeMatrixName() const;
+
+    Q_PROPERTY(QString PeakAttributeMatrixName READ getPeakAttributeMatrixName WRITE setPeakAttributeMatrixName)
+
     /**
      * @brief getCompiledLibraryName Returns the name of the Library that this filter is a part of
      * @return
@@ -209,10 +287,27 @@ class ImageProcessing_EXPORT ItkFindMaxima : public AbstractFilter
 
     std::weak_ptr<DataArray<bool>> m_NewCellArrayPtr;
     bool* m_NewCellArray = nullptr;
+    std::vector<std::weak_ptr<DataArray<bool>>> m_ToleranceMaskPtrs;
+    std::vector<float> m_ToleranceValues;
+    std::weak_ptr<DataArray<float>> m_PeakCentroidsPtr;
+    std::weak_ptr<DataArray<int32_t>> m_PeakVoxelIndicesPtr;
+    std::weak_ptr<DataArray<float>> m_PeakIntensityPtr;
+    std::weak_ptr<DataArray<float>> m_PeakProminencePtr;
+    std::weak_ptr<DataArray<float>> m_MaximaCentroidsPtr;
+    std::weak_ptr<DataArray<int32_t>> m_MaximaVoxelCountPtr;
+    std::weak_ptr<DataArray<float>> m_MaximaIntensityPtr;
+    std::weak_ptr<DataArray<float>> m_MaximaProminencePtr;
+    std::weak_ptr<DataArray<int32_t>> m_MaximaMergeParentPtr;
 
     DataArrayPath m_SelectedCellArrayPath = {"", "", ""};
     float m_Tolerance = {1.0};
     QString m_NewCellArrayName = {"Maxima"};
+    QString m_AdditionalTolerances = {""};
+    bool m_SaveProminence = {false};
+    QString m_MaximaAttributeMatrixName = {"RegionalMaxima"};
+    bool m_CreateMask = {true};
+    bool m_SavePeakList = {false};
+    QString m_PeakAttributeMatrixName = {"Peaks"};
 
   public:
     ItkFindMaxima(const ItkFindMaxima&) = delete;  // Copy Constructor Not Implemented
@@ -0,0 +1,459 @@
+/* ============================================================================
+ * Copyright (c) 2014 William Lenthe
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of William Lenthe or any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  This code was partially written under United States Air Force Contract number
+ *                              FA8650-10-D-5210
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ItkFlatFieldCorrection.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <QtCore/QStringList>
+
+#include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
+#include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
+#include "SIMPLib/FilterParameters/FloatFilterParameter.h"
+#include "SIMPLib/FilterParameters/LinkedBooleanFilterParameter.h"
+#include "SIMPLib/FilterParameters/LinkedPathCreationFilterParameter.h"
+#include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
+
+#include "ImageProcessing/ImageProcessingConstants.h"
+
+/* Create Enumerations to allow the created Attribute Arrays to take part in renaming */
+enum createdPathID : RenameDataPath::DataID_t
+{
+  DataArrayID31 = 31,
+};
+
+namespace
+{
+/**
+ * @brief The FlatFieldImpl class evaluates scale * (I - dark) / (flat - dark) row by row and writes the rounded, clamped
+ * result straight into the output. A flat or dark operand with a single slice of tuples is indexed by the position in
+ * the slice, so it is broadcast over every slice of the volume without being copied.
+ */
+template <typename T>
+class FlatFieldImpl
+{
+public:
+  FlatFieldImpl(const T* image, const T* flat, bool flatSlice, const T* dark, bool darkSlice, const size_t dims[3], float scale, T* output)
+  : m_Image(image)
+  , m_Flat(flat)
+  , m_FlatSlice(flatSlice)
+  , m_Dark(dark)
+  , m_DarkSlice(darkSlice)
+  , m_Dims(dims)
+  , m_Scale(scale)
+  , m_Output(output)
+  {
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    const float maxValue = static_cast<float>(std::numeric_limits<T>::max());
+    for(size_t row = range.min(); row < range.max(); row++)
+    {
+      const size_t offset = row * m_Dims[0];
+      const size_t sliceOffset = (row % m_Dims[1]) * m_Dims[0];
+      const T* image = m_Image + offset;
+      const T* flat = m_Flat + (m_FlatSlice ? sliceOffset : offset);
+      const T* dark = nullptr == m_Dark ? nullptr : m_Dark + (m_DarkSlice ? sliceOffset : offset);
+      T* output = m_Output + offset;
+      for(size_t x = 0; x < m_Dims[0]; x++)
+      {
+        const float darkValue = nullptr == dark ? 0.0f : static_cast<float>(dark[x]);
+        const float gain = static_cast<float>(flat[x]) - darkValue;
+        const float value = gain > 0.0f ? m_Scale * (static_cast<float>(image[x]) - darkValue) / gain : 0.0f;
+        output[x] = static_cast<T>(std::min(std::max(value, 0.0f), maxValue) + 0.5f);
+      }
+    }
+  }
+
+private:
+  const T* m_Image;
+  const T* m_Flat;
+  bool m_FlatSlice;
+  const T* m_Dark;
+  bool m_DarkSlice;
+  const size_t* m_Dims;
+  float m_Scale;
+  T* m_Output;
+};
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ItkFlatFieldCorrection::ItkFlatFieldCorrection() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ItkFlatFieldCorrection::~ItkFlatFieldCorrection() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkFlatFieldCorrection::setupFilterParameters()
+{
+  FilterParameterVectorType parameters;
+
+  parameters.push_back(SIMPL_NEW_FLOAT_FP("Scale (0 for the mean flat field)", Scale, FilterParameter::Category::Parameter, ItkFlatFieldCorrection));
+  {
+    QStringList linkedProps("DarkFrameArrayPath");
+    parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Subtract Dark Frame", UseDarkFrame, FilterParameter::Category::Parameter, ItkFlatFieldCorrection, linkedProps));
+  }
+  {
+    QStringList linkedProps("NewCellArrayName");
+    parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Save as New Array", SaveAsNewArray, FilterParameter::Category::Parameter, ItkFlatFieldCorrection, linkedProps));
+  }
+  parameters.push_back(SeparatorFilterParameter::Create("Cell Data", FilterParameter::Category::RequiredArray));
+  {
+    DataArraySelectionFilterParameter::RequirementType req = DataArraySelectionFilterParameter::CreateCategoryRequirement(SIMPL::TypeNames::UInt8, 1, AttributeMatrix::Category::Any);
+    parameters.push_back(SIMPL_NEW_DA_SELECTION_FP("Attribute Array to Process", SelectedCellArrayPath, FilterParameter::Category::RequiredArray, ItkFlatFieldCorrection, req));
+    parameters.push_back(SIMPL_NEW_DA_SELECTION_FP("Flat Field", FlatFieldArrayPath, FilterParameter::Category::RequiredArray, ItkFlatFieldCorrection, req));
+    parameters.push_back(SIMPL_NEW_DA_SELECTION_FP("Dark Frame", DarkFrameArrayPath, FilterParameter::Category::RequiredArray, ItkFlatFieldCorrection, req));
+  }
+  parameters.push_back(SeparatorFilterParameter::Create("Cell Data", FilterParameter::Category::CreatedArray));
+  parameters.push_back(
+      SIMPL_NEW_DA_WITH_LINKED_AM_FP("Output Attribute Array", NewCellArrayName, SelectedCellArrayPath, SelectedCellArrayPath, FilterParameter::Category::CreatedArray, ItkFlatFieldCorrection));
+
+  setFilterParameters(parameters);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkFlatFieldCorrection::readFilterParameters(AbstractFilterParametersReader* reader, int index)
+{
+  reader->openFilterGroup(this, index);
+  setSelectedCellArrayPath( reader->readDataArrayPath( "SelectedCellArrayPath", getSelectedCellArrayPath() ) );
+  setFlatFieldArrayPath( reader->readDataArrayPath( "FlatFieldArrayPath", getFlatFieldArrayPath() ) );
+  setUseDarkFrame( reader->readValue( "UseDarkFrame", getUseDarkFrame() ) );
+  setDarkFrameArrayPath( reader->readDataArrayPath( "DarkFrameArrayPath", getDarkFrameArrayPath() ) );
+  setScale( reader->readValue( "Scale", getScale() ) );
+  setSaveAsNewArray( reader->readValue( "SaveAsNewArray", getSaveAsNewArray() ) );
+  setNewCellArrayName( reader->readString( "NewCellArrayName", getNewCellArrayName() ) );
+  reader->closeFilterGroup();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkFlatFieldCorrection::initialize()
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkFlatFieldCorrection::dataCheck()
+{
+  clearErrorCode();
+  clearWarningCode();
+  DataArrayPath tempPath;
+
+  std::vector<size_t> dims(1, 1);
+  m_SelectedCellArrayPtr = getDataContainerArray()->getPrereqArrayFromPath<DataArray<ImageProcessingConstants::DefaultPixelType>>(this, getSelectedCellArrayPath(), dims);
+  if(nullptr != m_SelectedCellArrayPtr.lock())
+  { m_SelectedCellArray = m_SelectedCellArrayPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
+  if(getErrorCode() < 0)
+  {
+    return;
+  }
+
+  ImageGeom::Pointer image = getDataContainerArray()->getDataContainer(getSelectedCellArrayPath().getDataContainerName())->getPrereqGeometry<ImageGeom>(this);
+  if(getErrorCode() < 0 || nullptr == image.get())
+  {
+    return;
+  }
+  SizeVec3Type udims = image->getDimensions();
+  const size_t sliceSize = udims[0] * udims[1];
+  const size_t totalPoints = m_SelectedCellArrayPtr.lock()->getNumberOfTuples();
+
+  //the flat and dark images may live anywhere, they only need one slice or one volume worth of tuples
+  m_FlatFieldArrayPtr = getDataContainerArray()->getPrereqArrayFromPath<DataArray<ImageProcessingConstants::DefaultPixelType>>(this, getFlatFieldArrayPath(), dims);
+  if(nullptr != m_FlatFieldArrayPtr.lock())
+  { m_FlatFieldArray = m_FlatFieldArrayPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
+  if(getErrorCode() < 0)
+  {
+    return;
+  }
+  size_t tuples = m_FlatFieldArrayPtr.lock()->getNumberOfTuples();
+  if(tuples != sliceSize && tuples != totalPoints)
+  {
+    QString ss = QObject::tr("The flat field must have one slice (%1) or one volume (%2) of tuples, not %3").arg(sliceSize).arg(totalPoints).arg(tuples);
+    setErrorCondition(-5570, ss);
+    return;
+  }
+
+  m_DarkFrameArray = nullptr;
+  if(m_UseDarkFrame)
+  {
+    m_DarkFrameArrayPtr = getDataContainerArray()->getPrereqArrayFromPath<DataArray<ImageProcessingConstants::DefaultPixelType>>(this, getDarkFrameArrayPath(), dims);
+    if(nullptr != m_DarkFrameArrayPtr.lock())
+    { m_DarkFrameArray = m_DarkFrameArrayPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
+    if(getErrorCode() < 0)
+    {
+      return;
+    }
+    tuples = m_DarkFrameArrayPtr.lock()->getNumberOfTuples();
+    if(tuples != sliceSize && tuples != totalPoints)
+    {
+      QString ss = QObject::tr("The dark frame must have one slice (%1) or one volume (%2) of tuples, not %3").arg(sliceSize).arg(totalPoints).arg(tuples);
+      setErrorCondition(-5570, ss);
+      return;
+    }
+  }
+
+  //the correction only reads each voxel before writing it, so without a new array it is done in place
+  if(m_SaveAsNewArray)
+  {
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getSelectedCellArrayPath().getAttributeMatrixName(), getNewCellArrayName());
+    m_NewCellArrayPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<ImageProcessingConstants::DefaultPixelType>>(this, tempPath, 0, dims, "", DataArrayID31);
+    if(nullptr != m_NewCellArrayPtr.lock())
+    { m_NewCellArray = m_NewCellArrayPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkFlatFieldCorrection::execute()
+{
+  dataCheck();
+  if(getErrorCode() < 0)
+  {
+    return;
+  }
+
+  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getSelectedCellArrayPath().getDataContainerName());
+  ImageGeom::Pointer image = m->getGeometryAs<ImageGeom>();
+  SizeVec3Type udims = image->getDimensions();
+  const size_t dims[3] = {udims[0], udims[1], udims[2]};
+  const size_t sliceSize = dims[0] * dims[1];
+  const size_t flatTuples = m_FlatFieldArrayPtr.lock()->getNumberOfTuples();
+  const bool flatSlice = flatTuples == sliceSize;
+  const bool darkSlice = m_UseDarkFrame && m_DarkFrameArrayPtr.lock()->getNumberOfTuples() == sliceSize;
+
+  //by default the corrected image keeps the mean brightness of the flat field
+  float scale = m_Scale;
+  if(scale <= 0.0f)
+  {
+    double sum = 0.0;
+    for(size_t i = 0; i < flatTuples; i++)
+    {
+      const size_t darkIndex = darkSlice ? i % sliceSize : i;
+      sum += static_cast<double>(m_FlatFieldArray[i]) - (nullptr == m_DarkFrameArray ? 0.0 : static_cast<double>(m_DarkFrameArray[darkIndex]));
+    }
+    scale = static_cast<float>(sum / static_cast<double>(flatTuples));
+    if(scale <= 0.0f)
+    {
+      QString ss = QObject::tr("The flat field must be brighter than the dark frame on average");
+      setErrorCondition(-5571, ss);
+      return;
+    }
+  }
+
+  ImageProcessingConstants::DefaultPixelType* output = m_SaveAsNewArray ? m_NewCellArray : m_SelectedCellArray;
+  ParallelDataAlgorithm dataAlg;
+  dataAlg.setRange(0, dims[1] * dims[2]);
+  dataAlg.execute(FlatFieldImpl<ImageProcessingConstants::DefaultPixelType>(m_SelectedCellArray, m_FlatFieldArray, flatSlice, m_DarkFrameArray, darkSlice, dims, scale, output));
+}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer ItkFlatFieldCorrection::newFilterInstance(bool copyFilterParameters) const
+{
+  ItkFlatFieldCorrection::Pointer filter = ItkFlatFieldCorrection::New();
+  if(copyFilterParameters)
+  {
+    copyFilterParameterInstanceVariables(filter.get());
+  }
+  return filter;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ItkFlatFieldCorrection::getCompiledLibraryName() const
+{return ImageProcessingConstants::ImageProcessingBaseName;}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ItkFlatFieldCorrection::getGroupName() const
+{return SIMPL::FilterGroups::Unsupported;}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QUuid ItkFlatFieldCorrection::getUuid() const
+{
+  return QUuid("{8b3d5f1e-2c7a-5e46-9d18-6a4f0c3e7b25}");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ItkFlatFieldCorrection::getSubGroupName() const
+{return "Misc";}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ItkFlatFieldCorrection::getHumanLabel() const
+{ return "Flat Field Correction (ImageProcessing)"; }
+
+// -----------------------------------------------------------------------------
+ItkFlatFieldCorrection::Pointer ItkFlatFieldCorrection::NullPointer()
+{
+  return Pointer(static_cast<Self*>(nullptr));
+}
+
+// -----------------------------------------------------------------------------
+std::shared_ptr<ItkFlatFieldCorrection> ItkFlatFieldCorrection::New()
+{
+  struct make_shared_enabler : public ItkFlatFieldCorrection
+  {
+  };
+  std::shared_ptr<make_shared_enabler> val = std::make_shared<make_shared_enabler>();
+  val->setupFilterParameters();
+  return val;
+}
+
+// -----------------------------------------------------------------------------
+QString ItkFlatFieldCorrection::getNameOfClass() const
+{
+  return QString("ItkFlatFieldCorrection");
+}
+
+// -----------------------------------------------------------------------------
+QString ItkFlatFieldCorrection::ClassName()
+{
+  return QString("ItkFlatFieldCorrection");
+}
+
+// -----------------------------------------------------------------------------
+void ItkFlatFieldCorrection::setSelectedCellArrayPath(const DataArrayPath& value)
+{
+  m_SelectedCellArrayPath = value;
+}
+
+// -----------------------------------------------------------------------------
+DataArrayPath ItkFlatFieldCorrection::getSelectedCellArrayPath() const
+{
+  return m_SelectedCellArrayPath;
+}
+
+// -----------------------------------------------------------------------------
+void ItkFlatFieldCorrection::setFlatFieldArrayPath(const DataArrayPath& value)
+{
+  m_FlatFieldArrayPath = value;
+}
+
+// -----------------------------------------------------------------------------
+DataArrayPath ItkFlatFieldCorrection::getFlatFieldArrayPath() const
+{
+  return m_FlatFieldArrayPath;
+}
+
+// -----------------------------------------------------------------------------
+void ItkFlatFieldCorrection::setUseDarkFrame(bool value)
+{
+  m_UseDarkFrame = value;
+}
+
+// -----------------------------------------------------------------------------
+bool ItkFlatFieldCorrection::getUseDarkFrame() const
+{
+  return m_UseDarkFrame;
+}
+
+// -----------------------------------------------------------------------------
+void ItkFlatFieldCorrection::setDarkFrameArrayPath(const DataArrayPath& value)
+{
+  m_DarkFrameArrayPath = value;
+}
+
+// -----------------------------------------------------------------------------
+DataArrayPath ItkFlatFieldCorrection::getDarkFrameArrayPath() const
+{
+  return m_DarkFrameArrayPath;
+}
+
+// -----------------------------------------------------------------------------
+void ItkFlatFieldCorrection::setScale(float value)
+{
+  m_Scale = value;
+}
+
+// -----------------------------------------------------------------------------
+float ItkFlatFieldCorrection::getScale() const
+{
+  return m_Scale;
+}
+
+// -----------------------------------------------------------------------------
+void ItkFlatFieldCorrection::setSaveAsNewArray(bool value)
+{
+  m_SaveAsNewArray = value;
+}
+
+// -----------------------------------------------------------------------------
+bool ItkFlatFieldCorrection::getSaveAsNewArray() const
+{
+  return m_SaveAsNewArray;
+}
+
+// -----------------------------------------------------------------------------
+void ItkFlatFieldCorrection::setNewCellArrayName(const QString& value)
+{
+  m_NewCellArrayName = value;
+}
+
+// -----------------------------------------------------------------------------
+QString ItkFlatFieldCorrection::getNewCellArrayName() const
+{
+  return m_NewCellArrayName;
+}
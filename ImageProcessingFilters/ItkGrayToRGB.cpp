@@ -35,22 +35,57 @@
 
 #include "ItkGrayToRGB.h"
 
-//thresholding filter
-#include "itkComposeImageFilter.h"
+#include <algorithm>
+
+#include <QtCore/QStringList>
 
 #include "SIMPLib/Common/TemplateHelpers.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
+#include "SIMPLib/FilterParameters/LinkedBooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/LinkedPathCreationFilterParameter.h"
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
 #include "SIMPLib/Geometry/ImageGeom.h"
-#include "SIMPLib/ITK/itkBridge.h"
 #include "SIMPLib/DataContainers/DataContainerArray.h"
 #include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
 
 #include "ImageProcessing/ImageProcessingConstants.h"
 
+namespace
+{
+/**
+ * @brief The InterleaveImpl class writes the channels into consecutive components of the output. The channel count is a
+ * template parameter so the inner loop unrolls and the compiler can vectorize the strided stores.
+ */
+template <typename PixelType, size_t Channels>
+class InterleaveImpl
+{
+public:
+  InterleaveImpl(const PixelType* const* channels, PixelType* output)
+  : m_Output(output)
+  {
+    std::copy(channels, channels + Channels, m_Channels);
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    for(size_t i = range.min(); i < range.max(); i++)
+    {
+      for(size_t c = 0; c < Channels; c++)
+      {
+        m_Output[Channels * i + c] = m_Channels[c][i];
+      }
+    }
+  }
+
+private:
+  const PixelType* m_Channels[Channels];
+  PixelType* m_Output;
+};
+} // namespace
+
 /**
  * @brief This is a private implementation for the filter that handles the actual algorithm implementation details
  * for us like figuring out if we can use this private implementation with the data array that is assigned.
@@ -75,49 +110,30 @@ class GrayToRGBPrivate
     // -----------------------------------------------------------------------------
     // This is the actual templated algorithm
     // -----------------------------------------------------------------------------
-    void static Execute(ItkGrayToRGB* filter, IDataArray::Pointer redInputIDataArray, IDataArray::Pointer greenInputIDataArray, IDataArray::Pointer blueInputIDataArray, IDataArray::Pointer outputIDataArray, DataContainer::Pointer m, QString attrMatName)
+    void static Execute(ItkGrayToRGB* /*filter*/, IDataArray::Pointer redInputIDataArray, IDataArray::Pointer greenInputIDataArray, IDataArray::Pointer blueInputIDataArray, IDataArray::Pointer alphaInputIDataArray, IDataArray::Pointer outputIDataArray)
     {
-      typename DataArrayType::Pointer redInputDataPtr = std::dynamic_pointer_cast<DataArrayType>(redInputIDataArray);
-      typename DataArrayType::Pointer greenInputDataPtr = std::dynamic_pointer_cast<DataArrayType>(greenInputIDataArray);
-      typename DataArrayType::Pointer blueInputDataPtr = std::dynamic_pointer_cast<DataArrayType>(blueInputIDataArray);
-      typename DataArrayType::Pointer outputDataPtr = std::dynamic_pointer_cast<DataArrayType>(outputIDataArray);
-
-      //convert arrays to correct type
-      PixelType* redData = static_cast<PixelType*>(redInputDataPtr->getPointer(0));
-      PixelType* greenData = static_cast<PixelType*>(greenInputDataPtr->getPointer(0));
-      PixelType* blueData = static_cast<PixelType*>(blueInputDataPtr->getPointer(0));
-      PixelType* outputData = static_cast<PixelType*>(outputDataPtr->getPointer(0));
-
-      size_t numVoxels = redInputDataPtr->getNumberOfTuples();
-
-      typedef ItkBridge<PixelType> ItkBridgeType;
-
-      //wrap inputs as itk images
-      typedef itk::Image<PixelType, ImageProcessingConstants::ImageDimension> ImageType;
-      typename ImageType::Pointer redImage = ItkBridgeType::CreateItkWrapperForDataPointer(m, attrMatName, redData);
-      typename ImageType::Pointer greenImage = ItkBridgeType::CreateItkWrapperForDataPointer(m, attrMatName, greenData);
-      typename ImageType::Pointer blueImage = ItkBridgeType::CreateItkWrapperForDataPointer(m, attrMatName, blueData);
-
-      //define threshold filters
-      typedef itk::ComposeImageFilter<typename ItkBridgeType::ScalarImageType, typename ItkBridgeType::RGBImageType> ComposeRGBType;
-
-      //threshold
-      typename ComposeRGBType::Pointer composeRGB = ComposeRGBType::New();
-      composeRGB->SetInput(0, redImage);
-      composeRGB->SetInput(1, greenImage);
-      composeRGB->SetInput(2, blueImage);
-      composeRGB->GetOutput()->GetPixelContainer()->SetImportPointer(reinterpret_cast<typename ItkBridgeType::RGBImageType::PixelType*>(outputData), numVoxels, false);
-
-      try
+      //convert arrays to correct type (the alpha channel is optional)
+      const PixelType* channels[4] = {std::dynamic_pointer_cast<DataArrayType>(redInputIDataArray)->getPointer(0), std::dynamic_pointer_cast<DataArrayType>(greenInputIDataArray)->getPointer(0),
+                                      std::dynamic_pointer_cast<DataArrayType>(blueInputIDataArray)->getPointer(0), nullptr};
+      if(nullptr != alphaInputIDataArray.get())
       {
-        composeRGB->Update();
+        channels[3] = std::dynamic_pointer_cast<DataArrayType>(alphaInputIDataArray)->getPointer(0);
       }
-      catch( itk::ExceptionObject& err )
+      PixelType* outputData = std::dynamic_pointer_cast<DataArrayType>(outputIDataArray)->getPointer(0);
+      size_t numVoxels = redInputIDataArray->getNumberOfTuples();
+
+      ParallelDataAlgorithm dataAlg;
+      dataAlg.setRange(0, numVoxels);
+      if(nullptr == channels[3])
       {
-        QString ss = QObject::tr("Failed to convert image. Error Message returned from ITK:\n   %1").arg(err.GetDescription());
-        filter->setErrorCondition(-5, ss);
+        dataAlg.execute(InterleaveImpl<PixelType, 3>(channels, outputData));
+      }
+      else
+      {
+        dataAlg.execute(InterleaveImpl<PixelType, 4>(channels, outputData));
       }
     }
+
   private:
     GrayToRGBPrivate(const GrayToRGBPrivate&) = delete; // Copy Constructor Not Implemented
     void operator=(const GrayToRGBPrivate&) = delete;   // Move assignment Not Implemented
@@ -139,6 +155,10 @@ ItkGrayToRGB::~ItkGrayToRGB() = default;
 void ItkGrayToRGB::setupFilterParameters()
 {
   FilterParameterVectorType parameters;
+  {
+    QStringList linkedProps("AlphaArrayPath");
+    parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Add Alpha Channel", UseAlpha, FilterParameter::Category::Parameter, ItkGrayToRGB, linkedProps));
+  }
   parameters.push_back(SeparatorFilterParameter::Create("Cell Data", FilterParameter::Category::RequiredArray));
   {
     DataArraySelectionFilterParameter::RequirementType req = DataArraySelectionFilterParameter::CreateCategoryRequirement(SIMPL::Defaults::AnyPrimitive, 1, AttributeMatrix::Category::Any);
@@ -152,6 +172,10 @@ void ItkGrayToRGB::setupFilterParameters()
     DataArraySelectionFilterParameter::RequirementType req = DataArraySelectionFilterParameter::CreateCategoryRequirement(SIMPL::Defaults::AnyPrimitive, 1, AttributeMatrix::Category::Any);
     parameters.push_back(SIMPL_NEW_DA_SELECTION_FP("Blue Channel", BlueArrayPath, FilterParameter::Category::RequiredArray, ItkGrayToRGB, req));
   }
+  {
+    DataArraySelectionFilterParameter::RequirementType req = DataArraySelectionFilterParameter::CreateCategoryRequirement(SIMPL::Defaults::AnyPrimitive, 1, AttributeMatrix::Category::Any);
+    parameters.push_back(SIMPL_NEW_DA_SELECTION_FP("Alpha Channel", AlphaArrayPath, FilterParameter::Category::RequiredArray, ItkGrayToRGB, req));
+  }
   parameters.push_back(SeparatorFilterParameter::Create("Cell Data", FilterParameter::Category::CreatedArray));
   parameters.push_back(SIMPL_NEW_DA_WITH_LINKED_AM_FP("RGB Array", NewCellArrayName, RedArrayPath, RedArrayPath, FilterParameter::Category::CreatedArray, ItkGrayToRGB));
   setFilterParameters(parameters);
@@ -166,6 +190,8 @@ void ItkGrayToRGB::readFilterParameters(AbstractFilterParametersReader* reader,
   setRedArrayPath( reader->readDataArrayPath( "RedArrayPath", getRedArrayPath() ) );
   setGreenArrayPath( reader->readDataArrayPath( "GreenArrayPath", getGreenArrayPath() ) );
   setBlueArrayPath( reader->readDataArrayPath( "BlueArrayPath", getBlueArrayPath() ) );
+  setUseAlpha( reader->readValue( "UseAlpha", getUseAlpha() ) );
+  setAlphaArrayPath( reader->readDataArrayPath( "AlphaArrayPath", getAlphaArrayPath() ) );
   setNewCellArrayName( reader->readString( "NewCellArrayName", getNewCellArrayName() ) );
   reader->closeFilterGroup();
 }
@@ -203,6 +229,34 @@ void ItkGrayToRGB::dataCheck()
   {
     m_Blue = m_BluePtr.lock().get();
   }
+  if(m_UseAlpha)
+  {
+    m_AlphaPtr = TemplateHelpers::GetPrereqArrayFromPath()(this, getAlphaArrayPath(), compDims);
+    if(nullptr != m_AlphaPtr.lock())
+    {
+      m_Alpha = m_AlphaPtr.lock().get();
+    }
+  }
+  if(getErrorCode() < 0)
+  {
+    return;
+  }
+
+  //the channels are interleaved directly so they must match
+  std::vector<IDataArray::Pointer> channels = {m_RedPtr.lock(), m_GreenPtr.lock(), m_BluePtr.lock()};
+  if(m_UseAlpha)
+  {
+    channels.push_back(m_AlphaPtr.lock());
+  }
+  for(size_t i = 1; i < channels.size(); i++)
+  {
+    if(channels[i]->getTypeAsString() != channels[0]->getTypeAsString() || channels[i]->getNumberOfTuples() != channels[0]->getNumberOfTuples())
+    {
+      QString ss = QObject::tr("All channels must have the same type and number of tuples");
+      setErrorCondition(-5575, ss);
+      return;
+    }
+  }
 
   //configured created name / location
   tempPath.update(getRedArrayPath().getDataContainerName(), getRedArrayPath().getAttributeMatrixName(), getNewCellArrayName() );
@@ -227,7 +281,7 @@ void ItkGrayToRGB::dataCheck()
   }
 
   //create new array of same type
-  compDims[0] = 3;
+  compDims[0] = m_UseAlpha ? 4 : 3;
   m_NewCellArrayPtr = TemplateHelpers::CreateNonPrereqArrayFromArrayType()(this, tempPath, compDims, redArrayptr);
   if(nullptr != m_NewCellArrayPtr.lock())
   {
@@ -251,12 +305,12 @@ void ItkGrayToRGB::execute()
 
   //get volume container
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getRedArrayPath().getDataContainerName());
-  QString attrMatName = getRedArrayPath().getAttributeMatrixName();
 
   //get input and output data
   IDataArray::Pointer redData = m_RedPtr.lock();
   IDataArray::Pointer greenData = m_GreenPtr.lock();
   IDataArray::Pointer blueData = m_BluePtr.lock();
+  IDataArray::Pointer alphaData = m_UseAlpha ? m_AlphaPtr.lock() : IDataArray::Pointer();
   IDataArray::Pointer outputData = m_NewCellArrayPtr.lock();
 
   //execute type dependant portion using a Private Implementation that takes care of figuring out if
@@ -265,43 +319,43 @@ void ItkGrayToRGB::execute()
   // progress or handle "cancel" if needed.
   if(GrayToRGBPrivate<int8_t>()(redData))
   {
-    GrayToRGBPrivate<int8_t>::Execute(this, redData, greenData, blueData, outputData, m, attrMatName);
+    GrayToRGBPrivate<int8_t>::Execute(this, redData, greenData, blueData, alphaData, outputData);
   }
   else if(GrayToRGBPrivate<uint8_t>()(redData) )
   {
-    GrayToRGBPrivate<uint8_t>::Execute(this, redData, greenData, blueData, outputData, m, attrMatName);
+    GrayToRGBPrivate<uint8_t>::Execute(this, redData, greenData, blueData, alphaData, outputData);
   }
   else if(GrayToRGBPrivate<int16_t>()(redData) )
   {
-    GrayToRGBPrivate<int16_t>::Execute(this, redData, greenData, blueData, outputData, m, attrMatName);
+    GrayToRGBPrivate<int16_t>::Execute(this, redData, greenData, blueData, alphaData, outputData);
   }
   else if(GrayToRGBPrivate<uint16_t>()(redData) )
   {
-    GrayToRGBPrivate<uint16_t>::Execute(this, redData, greenData, blueData, outputData, m, attrMatName);
+    GrayToRGBPrivate<uint16_t>::Execute(this, redData, greenData, blueData, alphaData, outputData);
   }
   else if(GrayToRGBPrivate<int32_t>()(redData) )
   {
-    GrayToRGBPrivate<int32_t>::Execute(this, redData, greenData, blueData, outputData, m, attrMatName);
+    GrayToRGBPrivate<int32_t>::Execute(this, redData, greenData, blueData, alphaData, outputData);
   }
   else if(GrayToRGBPrivate<uint32_t>()(redData) )
   {
-    GrayToRGBPrivate<uint32_t>::Execute(this, redData, greenData, blueData, outputData, m, attrMatName);
+    GrayToRGBPrivate<uint32_t>::Execute(this, redData, greenData, blueData, alphaData, outputData);
   }
   else if(GrayToRGBPrivate<int64_t>()(redData) )
   {
-    GrayToRGBPrivate<int64_t>::Execute(this, redData, greenData, blueData, outputData, m, attrMatName);
+    GrayToRGBPrivate<int64_t>::Execute(this, redData, greenData, blueData, alphaData, outputData);
   }
   else if(GrayToRGBPrivate<uint64_t>()(redData) )
   {
-    GrayToRGBPrivate<uint64_t>::Execute(this, redData, greenData, blueData, outputData, m, attrMatName);
+    GrayToRGBPrivate<uint64_t>::Execute(this, redData, greenData, blueData, alphaData, outputData);
   }
   else if(GrayToRGBPrivate<float>()(redData) )
   {
-    GrayToRGBPrivate<float>::Execute(this, redData, greenData, blueData, outputData, m, attrMatName);
+    GrayToRGBPrivate<float>::Execute(this, redData, greenData, blueData, alphaData, outputData);
   }
   else if(GrayToRGBPrivate<double>()(redData) )
   {
-    GrayToRGBPrivate<double>::Execute(this, redData, greenData, blueData, outputData, m, attrMatName);
+    GrayToRGBPrivate<double>::Execute(this, redData, greenData, blueData, alphaData, outputData);
   }
   else
   {
@@ -440,3 +494,27 @@ QString ItkGrayToRGB::getNewCellArrayName() const
 {
   return m_NewCellArrayName;
 }
+
+// -----------------------------------------------------------------------------
+void ItkGrayToRGB::setUseAlpha(bool value)
+{
+  m_UseAlpha = value;
+}
+
+// -----------------------------------------------------------------------------
+bool ItkGrayToRGB::getUseAlpha() const
+{
+  return m_UseAlpha;
+}
+
+// -----------------------------------------------------------------------------
+void ItkGrayToRGB::setAlphaArrayPath(const DataArrayPath& value)
+{
+  m_AlphaArrayPath = value;
+}
+
+// -----------------------------------------------------------------------------
+DataArrayPath ItkGrayToRGB::getAlphaArrayPath() const
+{
+  return m_AlphaArrayPath;
+}
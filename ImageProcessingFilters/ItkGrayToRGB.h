@@ -70,6 +70,8 @@ class ImageProcessing_EXPORT ItkGrayToRGB : public AbstractFilter
     PYB11_PROPERTY(DataArrayPath RedArrayPath READ getRedArrayPath WRITE setRedArrayPath)
     PYB11_PROPERTY(DataArrayPath GreenArrayPath READ getGreenArrayPath WRITE setGreenArrayPath)
     PYB11_PROPERTY(DataArrayPath BlueArrayPath READ getBlueArrayPath WRITE setBlueArrayPath)
+    PYB11_PROPERTY(bool UseAlpha READ getUseAlpha WRITE setUseAlpha)
+    PYB11_PROPERTY(DataArrayPath AlphaArrayPath READ getAlphaArrayPath WRITE setAlphaArrayPath)
     PYB11_PROPERTY(QString NewCellArrayName READ getNewCellArrayName WRITE setNewCellArrayName)
     PYB11_END_BINDINGS()
     // End Python bindings declarations
@@ -131,6 +133,30 @@ class ImageProcessing_EXPORT ItkGrayToRGB : public AbstractFilter
 
     Q_PROPERTY(DataArrayPath BlueArrayPath READ getBlueArrayPath WRITE setBlueArrayPath)
 
+    /**
+     * @brief Setter property for UseAlpha
+     */
+    void setUseAlpha(bool value);
+    /**
+     * @brief Getter property for UseAlpha
+     * @return Value of UseAlpha
+     */
+    bool getUseAlpha() const;
+
+    Q_PROPERTY(bool UseAlpha READ getUseAlpha WRITE setUseAlpha)
+
+    /**
+     * @brief Setter property for AlphaArrayPath
+     */
+    void setAlphaArrayPath(const DataArrayPath& value);
+    /**
+     * @brief Getter property for AlphaArrayPath
+     * @return Value of AlphaArrayPath
+     */
+    DataArrayPath getAlphaArrayPath() const;
+
+    Q_PROPERTY(DataArrayPath AlphaArrayPath READ getAlphaArrayPath WRITE setAlphaArrayPath)
+
     /**
      * @brief Setter property for NewCellArrayName
      */
@@ -224,12 +250,16 @@ class ImageProcessing_EXPORT ItkGrayToRGB : public AbstractFilter
     void* m_Green = nullptr;
     IDataArrayWkPtrType m_BluePtr;
     void* m_Blue = nullptr;
+    IDataArrayWkPtrType m_AlphaPtr;
+    void* m_Alpha = nullptr;
     IDataArrayWkPtrType m_NewCellArrayPtr;
     void* m_NewCellArray = nullptr;
 
     DataArrayPath m_RedArrayPath = {"", "", ""};
     DataArrayPath m_GreenArrayPath = {"", "", ""};
     DataArrayPath m_BlueArrayPath = {"", "", ""};
+    bool m_UseAlpha = {false};
+    DataArrayPath m_AlphaArrayPath = {"", "", ""};
     QString m_NewCellArrayName = {""};
 
   public:
@@ -35,11 +35,15 @@
 
 #include "ItkHoughCircles.h"
 
+#include <algorithm>
 #include <cmath>
+#include <mutex>
+#include <vector>
 
 #include "itkHoughTransform2DCirclesImageFilter.h"
 
 #include <QtCore/QString>
+#include <QtCore/QStringList>
 
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
@@ -53,16 +57,264 @@
 #include "SIMPLib/ITK/itkBridge.h"
 #include "SIMPLib/DataContainers/DataContainerArray.h"
 #include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
 
 #include "ImageProcessing/ImageProcessingConstants.h"
 
 /* Create Enumerations to allow the created Attribute Arrays to take part in renaming */
 enum createdPathID : RenameDataPath::DataID_t
 {
+  AttributeMatrixID21 = 21,
+
   DataArrayID30 = 30,
   DataArrayID31 = 31,
+  DataArrayID32 = 32,
+  DataArrayID33 = 33,
+  DataArrayID34 = 34,
+  DataArrayID35 = 35,
+};
+
+#if defined(ITK_VERSION_MAJOR) && ITK_VERSION_MAJOR == 4
+#define GETRADIUS GetRadius
+using HoughTransformFilterType = itk::HoughTransform2DCirclesImageFilter<ImageProcessingConstants::DefaultPixelType, ImageProcessingConstants::FloatPixelType>;
+#else
+#define GETRADIUS GetRadiusInObjectSpace
+using HoughTransformFilterType =
+    itk::HoughTransform2DCirclesImageFilter<ImageProcessingConstants::DefaultPixelType, ImageProcessingConstants::FloatPixelType, ImageProcessingConstants::FloatPixelType>;
+#endif
+
+namespace
+{
+//arrays of the circle list attribute matrix
+const QString k_SliceArrayName("Slice");
+const QString k_CentroidsArrayName("Centroids");
+const QString k_RadiusArrayName("Radius");
+const QString k_VotesArrayName("Votes");
+
+//a detected circle, center and radius are in voxels of the slice
+struct HoughCircle
+{
+  int32_t slice;
+  float center[2];
+  float radius;
+  float votes;
 };
 
+/**
+ * @brief The HoughSliceImpl class runs the hough transform on a range of slices. Every range gets its own hough filters
+ * (and so its own accumulators) and slice buffers, circles are kept per slice and optionally drawn into the output slice.
+ * With a downsample factor above 1 each slice is first transformed at reduced resolution and every coarse circle is then
+ * refined by a full resolution transform of a small region around it (with a narrow radius range)
+ */
+class HoughSliceImpl
+{
+public:
+  HoughSliceImpl(const ImageProcessingConstants::DefaultPixelType* input, ImageProcessingConstants::DefaultPixelType* output, const size_t dims[3], const ItkHoughCircles* filter,
+                 std::vector<std::vector<HoughCircle>>* circles, QString* error, std::mutex* mutex)
+  : m_Input(input)
+  , m_Output(output)
+  , m_Dims(dims)
+  , m_Filter(filter)
+  , m_Circles(circles)
+  , m_Error(error)
+  , m_Mutex(mutex)
+  {
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    const size_t sliceSize = m_Dims[0] * m_Dims[1];
+    const size_t factor = m_Filter->getCoarseToFine() ? static_cast<size_t>(m_Filter->getDownsampleFactor()) : 1;
+    ImageProcessingConstants::DefaultSliceType::Pointer slice = CreateSlice((m_Dims[0] + factor - 1) / factor, (m_Dims[1] + factor - 1) / factor);
+    HoughTransformFilterType::Pointer houghFilter = HoughTransformFilterType::New();
+    HoughTransformFilterType::Pointer roiFilter = HoughTransformFilterType::New();
+
+    for(size_t z = range.min(); z < range.max(); z++)
+    {
+      if(m_Filter->getCancel())
+      {
+        return;
+      }
+
+      std::vector<HoughCircle>& sliceCircles = (*m_Circles)[z];
+      sliceCircles.clear();
+      try
+      {
+        const ImageProcessingConstants::DefaultPixelType* input = m_Input + z * sliceSize;
+        if(1 == factor)
+        {
+          std::copy(input, input + sliceSize, slice->GetBufferPointer());
+          slice->Modified();
+          houghFilter->SetInput(slice);
+          Detect(houghFilter, m_Filter->getNumberCircles(), m_Filter->getMinRadius(), m_Filter->getMaxRadius(), 0, 0, 1, sliceCircles);
+        }
+        else
+        {
+          coarseToFine(input, factor, slice, houghFilter, roiFilter, sliceCircles);
+        }
+      }
+      catch(itk::ExceptionObject& err)
+      {
+        std::lock_guard<std::mutex> lock(*m_Mutex);
+        *m_Error = err.GetDescription();
+        return;
+      }
+      for(size_t i = 0; i < sliceCircles.size(); i++)
+      {
+        sliceCircles[i].slice = static_cast<int32_t>(z);
+      }
+
+      if(nullptr != m_Output)
+      {
+        drawCircles(sliceCircles, m_Output + z * sliceSize);
+      }
+    }
+  }
+
+private:
+  static ImageProcessingConstants::DefaultSliceType::Pointer CreateSlice(size_t width, size_t height)
+  {
+    ImageProcessingConstants::DefaultSliceType::Pointer slice = ImageProcessingConstants::DefaultSliceType::New();
+    ImageProcessingConstants::DefaultSliceType::RegionType region;
+    ImageProcessingConstants::DefaultSliceType::SizeType size;
+    size[0] = width;
+    size[1] = height;
+    region.SetSize(size);
+    slice->SetRegions(region);
+    slice->Allocate();
+    return slice;
+  }
+
+  //transforms the filter's input and appends its circles, mapped from the input's pixels to slice pixels (scale then offset)
+  static void Detect(HoughTransformFilterType* houghFilter, int numberCircles, float minRadius, float maxRadius, size_t offsetX, size_t offsetY, size_t scale, std::vector<HoughCircle>& circles)
+  {
+    houghFilter->SetNumberOfCircles(numberCircles);
+    houghFilter->SetMinimumRadius(minRadius);
+    houghFilter->SetMaximumRadius(maxRadius);
+    houghFilter->Update();
+    ImageProcessingConstants::FloatSliceType::Pointer accumulator = houghFilter->GetOutput();
+    HoughTransformFilterType::CirclesListType found = houghFilter->GetCircles();
+    for(HoughTransformFilterType::CirclesListType::const_iterator iter = found.begin(); iter != found.end(); ++iter)
+    {
+      HoughCircle circle;
+      circle.slice = 0;
+      const float center[2] = {static_cast<float>((*iter)->GetObjectToParentTransform()->GetOffset()[0]), static_cast<float>((*iter)->GetObjectToParentTransform()->GetOffset()[1])};
+      circle.center[0] = center[0] * scale + offsetX;
+      circle.center[1] = center[1] * scale + offsetY;
+      circle.radius = static_cast<float>((*iter)->GETRADIUS()[0]) * scale;
+      ImageProcessingConstants::FloatSliceType::IndexType centerIndex;
+      centerIndex[0] = static_cast<long int>(center[0]);
+      centerIndex[1] = static_cast<long int>(center[1]);
+      circle.votes = accumulator->GetLargestPossibleRegion().IsInside(centerIndex) ? accumulator->GetPixel(centerIndex) : 0.0f;
+      circles.push_back(circle);
+    }
+  }
+
+  //votes on a box averaged copy of the slice, then refines each candidate at full resolution in a window just larger than it
+  void coarseToFine(const ImageProcessingConstants::DefaultPixelType* input, size_t factor, ImageProcessingConstants::DefaultSliceType* coarseSlice, HoughTransformFilterType* houghFilter,
+                    HoughTransformFilterType* roiFilter, std::vector<HoughCircle>& circles) const
+  {
+    //downsample
+    const size_t coarseDims[2] = {(m_Dims[0] + factor - 1) / factor, (m_Dims[1] + factor - 1) / factor};
+    ImageProcessingConstants::DefaultPixelType* coarse = coarseSlice->GetBufferPointer();
+    for(size_t cy = 0; cy < coarseDims[1]; cy++)
+    {
+      for(size_t cx = 0; cx < coarseDims[0]; cx++)
+      {
+        size_t sum = 0;
+        size_t count = 0;
+        for(size_t y = cy * factor; y < std::min(m_Dims[1], (cy + 1) * factor); y++)
+        {
+          for(size_t x = cx * factor; x < std::min(m_Dims[0], (cx + 1) * factor); x++)
+          {
+            sum += input[y * m_Dims[0] + x];
+            count++;
+          }
+        }
+        coarse[cy * coarseDims[0] + cx] = static_cast<ImageProcessingConstants::DefaultPixelType>(sum / count);
+      }
+    }
+    coarseSlice->Modified();
+
+    //candidates, more than requested since some collapse onto the same circle once refined
+    std::vector<HoughCircle> candidates;
+    houghFilter->SetInput(coarseSlice);
+    const float scale = static_cast<float>(factor);
+    Detect(houghFilter, 2 * m_Filter->getNumberCircles(), m_Filter->getMinRadius() / scale, m_Filter->getMaxRadius() / scale, 0, 0, factor, candidates);
+
+    //refine in a window around each candidate with the radius range narrowed to the coarse uncertainty
+    std::vector<HoughCircle> refined;
+    for(size_t i = 0; i < candidates.size(); i++)
+    {
+      const float minRadius = std::max(m_Filter->getMinRadius(), candidates[i].radius - scale);
+      const float maxRadius = std::min(m_Filter->getMaxRadius(), candidates[i].radius + scale);
+      const float halfWidth = maxRadius + 2.0f * scale;
+      size_t start[2];
+      size_t end[2];
+      for(size_t d = 0; d < 2; d++)
+      {
+        start[d] = static_cast<size_t>(std::max(0.0f, std::floor(candidates[i].center[d] - halfWidth)));
+        end[d] = std::min(m_Dims[d], static_cast<size_t>(std::max(0.0f, std::ceil(candidates[i].center[d] + halfWidth))) + 1);
+      }
+      if(end[0] <= start[0] || end[1] <= start[1])
+      {
+        continue;
+      }
+      ImageProcessingConstants::DefaultSliceType::Pointer roi = CreateSlice(end[0] - start[0], end[1] - start[1]);
+      for(size_t y = start[1]; y < end[1]; y++)
+      {
+        std::copy(input + y * m_Dims[0] + start[0], input + y * m_Dims[0] + end[0], roi->GetBufferPointer() + (y - start[1]) * (end[0] - start[0]));
+      }
+      roiFilter->SetInput(roi);
+      Detect(roiFilter, 1, minRadius, maxRadius, start[0], start[1], 1, refined);
+    }
+
+    //strongest first, dropping circles that refined onto a stronger one
+    std::stable_sort(refined.begin(), refined.end(), [](const HoughCircle& lhs, const HoughCircle& rhs) { return lhs.votes > rhs.votes; });
+    for(size_t i = 0; i < refined.size() && circles.size() < static_cast<size_t>(m_Filter->getNumberCircles()); i++)
+    {
+      bool duplicate = false;
+      for(size_t j = 0; j < circles.size() && !duplicate; j++)
+      {
+        const float dx = refined[i].center[0] - circles[j].center[0];
+        const float dy = refined[i].center[1] - circles[j].center[1];
+        duplicate = dx * dx + dy * dy < scale * scale;
+      }
+      if(!duplicate)
+      {
+        circles.push_back(refined[i]);
+      }
+    }
+  }
+
+  //draws the outline of each circle (every 3 degrees) on a blank slice
+  void drawCircles(const std::vector<HoughCircle>& circles, ImageProcessingConstants::DefaultPixelType* output) const
+  {
+    std::fill(output, output + m_Dims[0] * m_Dims[1], 0);
+    for(size_t i = 0; i < circles.size(); i++)
+    {
+      for(double angle = 0; angle <= 2 * vnl_math::pi; angle += vnl_math::pi / 60.0)
+      {
+        const long int x = static_cast<long int>(circles[i].center[0] + circles[i].radius * std::cos(angle));
+        const long int y = static_cast<long int>(circles[i].center[1] + circles[i].radius * std::sin(angle));
+        if(x >= 0 && y >= 0 && x < static_cast<long int>(m_Dims[0]) && y < static_cast<long int>(m_Dims[1]))
+        {
+          output[y * m_Dims[0] + x] = 255;
+        }
+      }
+    }
+  }
+
+  const ImageProcessingConstants::DefaultPixelType* m_Input;
+  ImageProcessingConstants::DefaultPixelType* m_Output;
+  const size_t* m_Dims;
+  const ItkHoughCircles* m_Filter;
+  std::vector<std::vector<HoughCircle>>* m_Circles;
+  QString* m_Error;
+  std::mutex* m_Mutex;
+};
+} // namespace
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -80,9 +332,19 @@ void ItkHoughCircles::setupFilterParameters()
 {
   FilterParameterVectorType parameters;
 
+  {
+    QStringList linkedProps;
+    linkedProps << "SaveAsNewArray"
+                << "NewCellArrayName";
+    parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Draw Circles", DrawCircles, FilterParameter::Category::Parameter, ItkHoughCircles, linkedProps));
+  }
   std::vector<QString> linkedProps;
   linkedProps.push_back("NewCellArrayName");
   parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Save as New Array", SaveAsNewArray, FilterParameter::Category::Parameter, ItkHoughCircles, linkedProps));
+  {
+    QStringList linkedProps("CircleAttributeMatrixName");
+    parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Create Circle List", SaveCircleList, FilterParameter::Category::Parameter, ItkHoughCircles, linkedProps));
+  }
   parameters.push_back(SeparatorFilterParameter::Create("Cell Data", FilterParameter::Category::RequiredArray));
   {
     DataArraySelectionFilterParameter::RequirementType req = DataArraySelectionFilterParameter::CreateCategoryRequirement(SIMPL::TypeNames::Int8, 1, AttributeMatrix::Category::Any);
@@ -94,6 +356,13 @@ void ItkHoughCircles::setupFilterParameters()
   parameters.push_back(SIMPL_NEW_FLOAT_FP("Minimum Radius", MinRadius, FilterParameter::Category::Parameter, ItkHoughCircles));
   parameters.push_back(SIMPL_NEW_FLOAT_FP("Maximum Radius", MaxRadius, FilterParameter::Category::Parameter, ItkHoughCircles));
   parameters.push_back(SIMPL_NEW_INTEGER_FP("Number of Circles", NumberCircles, FilterParameter::Category::Parameter, ItkHoughCircles));
+  {
+    QStringList linkedProps("DownsampleFactor");
+    parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Coarse to Fine", CoarseToFine, FilterParameter::Category::Parameter, ItkHoughCircles, linkedProps));
+  }
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Downsample Factor", DownsampleFactor, FilterParameter::Category::Parameter, ItkHoughCircles));
+  parameters.push_back(SeparatorFilterParameter::Create("Feature Data", FilterParameter::Category::CreatedArray));
+  parameters.push_back(SIMPL_NEW_STRING_FP("Circle Attribute Matrix", CircleAttributeMatrixName, FilterParameter::Category::CreatedArray, ItkHoughCircles));
 
   setFilterParameters(parameters);
 }
@@ -110,6 +379,11 @@ void ItkHoughCircles::readFilterParameters(AbstractFilterParametersReader* reade
   setMinRadius( reader->readValue( "MinRadius", getMinRadius() ) );
   setMaxRadius( reader->readValue( "MaxRadius", getMaxRadius() ) );
   setNumberCircles( reader->readValue( "NumberCircles", getNumberCircles() ) );
+  setDrawCircles( reader->readValue( "DrawCircles", getDrawCircles() ) );
+  setSaveCircleList( reader->readValue( "SaveCircleList", getSaveCircleList() ) );
+  setCircleAttributeMatrixName( reader->readString( "CircleAttributeMatrixName", getCircleAttributeMatrixName() ) );
+  setCoarseToFine( reader->readValue( "CoarseToFine", getCoarseToFine() ) );
+  setDownsampleFactor( reader->readValue( "DownsampleFactor", getDownsampleFactor() ) );
   reader->closeFilterGroup();
 }
 
@@ -144,22 +418,56 @@ void ItkHoughCircles::dataCheck()
     return;
   }
 
-  if(!m_SaveAsNewArray)
+  if(!m_DrawCircles && !m_SaveCircleList)
+  {
+    QString ss = QObject::tr("At least one of the drawn circles or the circle list must be created");
+    setErrorCondition(-5564, ss);
+    return;
+  }
+
+  if(m_CoarseToFine && m_DownsampleFactor < 2)
+  {
+    QString ss = QObject::tr("The downsample factor must be at least 2");
+    setErrorCondition(-5565, ss);
+    return;
+  }
+
+  m_NewCellArray = nullptr;
+  if(m_DrawCircles)
   {
-    m_NewCellArrayName = "thisIsATempName";
+    if(!m_SaveAsNewArray)
+    {
+      m_NewCellArrayName = "thisIsATempName";
+    }
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getSelectedCellArrayPath().getAttributeMatrixName(), getNewCellArrayName() );
+    m_NewCellArrayPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<ImageProcessingConstants::DefaultPixelType>>(
+        this, tempPath, 0, dims, "", DataArrayID31);
+    if(nullptr != m_NewCellArrayPtr.lock())
+    { m_NewCellArray = m_NewCellArrayPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
+  }
+
+  //one feature per circle, the number of circles is only known after the transform
+  if(m_SaveCircleList)
+  {
+    std::vector<size_t> tDims(1, 0);
+    getDataContainerArray()->getDataContainer(getSelectedCellArrayPath().getDataContainerName())
+        ->createNonPrereqAttributeMatrix(this, getCircleAttributeMatrixName(), tDims, AttributeMatrix::Type::CellFeature, AttributeMatrixID21);
+    if(getErrorCode() < 0)
+    {
+      return;
+    }
+    std::vector<size_t> vectorDims(1, 3);
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getCircleAttributeMatrixName(), k_SliceArrayName);
+    m_CircleSlicesPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<int32_t>>(this, tempPath, 0, dims, "", DataArrayID32);
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getCircleAttributeMatrixName(), k_CentroidsArrayName);
+    m_CircleCentroidsPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<float>>(this, tempPath, 0, vectorDims, "", DataArrayID33);
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getCircleAttributeMatrixName(), k_RadiusArrayName);
+    m_CircleRadiiPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<float>>(this, tempPath, 0, dims, "", DataArrayID34);
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getCircleAttributeMatrixName(), k_VotesArrayName);
+    m_CircleVotesPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<float>>(this, tempPath, 0, dims, "", DataArrayID35);
   }
-  tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getSelectedCellArrayPath().getAttributeMatrixName(), getNewCellArrayName() );
-  m_NewCellArrayPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<ImageProcessingConstants::DefaultPixelType>>(
-      this, tempPath, 0, dims, "", DataArrayID31);
-  if(nullptr != m_NewCellArrayPtr.lock())
-  { m_NewCellArray = m_NewCellArrayPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
 }
 
-#if defined(ITK_VERSION_MAJOR) && ITK_VERSION_MAJOR == 4
-#define GETRADIUS GetRadius
-#else
-#define GETRADIUS GetRadiusInObjectSpace
-#endif
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -173,101 +481,72 @@ void ItkHoughCircles::execute()
   }
 
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getSelectedCellArrayPath().getDataContainerName());
-  QString attrMatName = getSelectedCellArrayPath().getAttributeMatrixName();
 
-  /* Place all your code to execute your filter here. */
   //get dimensions
-  SizeVec3Type udims = m->getGeometryAs<ImageGeom>()->getDimensions();
-
-  int64_t dims[3] =
+  ImageGeom::Pointer image = m->getGeometryAs<ImageGeom>();
+  SizeVec3Type udims = image->getDimensions();
+  const size_t dims[3] = {udims[0], udims[1], udims[2]};
+
+  //transform slices in parallel
+  notifyStatusMessage("Hough Transforming Slices");
+  std::vector<std::vector<HoughCircle>> circles(dims[2]);
+  QString error;
+  std::mutex mutex;
+  ParallelDataAlgorithm dataAlg;
+  dataAlg.setRange(0, dims[2]);
+  dataAlg.execute(HoughSliceImpl(m_SelectedCellArray, m_NewCellArray, dims, this, &circles, &error, &mutex));
+  if(!error.isEmpty())
   {
-    static_cast<int64_t>(udims[0]),
-    static_cast<int64_t>(udims[1]),
-    static_cast<int64_t>(udims[2]),
-  };
-
-  size_t totalPoints = m_SelectedCellArrayPtr.lock()->getNumberOfTuples();
-  for(int i = 0; i < totalPoints; ++i)
+    QString ss = QObject::tr("Failed to execute itk::HoughTransform2DCirclesImageFilter. Error Message returned from ITK:\n   %1").arg(error);
+    setErrorCondition(-5, ss);
+    return;
+  }
+  if(getCancel())
   {
-    m_NewCellArray[i] = m_SelectedCellArray[i];
+    return;
   }
 
-  //wrap raw and processed image data as itk::images
-  ImageProcessingConstants::DefaultImageType::Pointer inputImage = ITKUtilitiesType::CreateItkWrapperForDataPointer(m, attrMatName, m_SelectedCellArray);
-  ImageProcessingConstants::DefaultImageType::Pointer outputImage = ITKUtilitiesType::CreateItkWrapperForDataPointer(m, attrMatName, m_NewCellArray);
-
-  ImageProcessingConstants::DefaultSliceType::IndexType localIndex;
-#if defined(ITK_VERSION_MAJOR) && ITK_VERSION_MAJOR == 4
-  using HoughTransformFilterType = itk::HoughTransform2DCirclesImageFilter<ImageProcessingConstants::DefaultPixelType, ImageProcessingConstants::FloatPixelType>;
-#else
-  using HoughTransformFilterType =
-      itk::HoughTransform2DCirclesImageFilter<ImageProcessingConstants::DefaultPixelType, ImageProcessingConstants::FloatPixelType, ImageProcessingConstants::FloatPixelType>;
-#endif
-  HoughTransformFilterType::Pointer houghFilter = HoughTransformFilterType::New();
-  houghFilter->SetNumberOfCircles( m_NumberCircles );
-  houghFilter->SetMinimumRadius( m_MinRadius );
-  houghFilter->SetMaximumRadius( m_MaxRadius );
-  /*optional parameters, these are the default values
-  houghFilter->SetSweepAngle( 0 );
-  houghFilter->SetSigmaGradient( 1 );
-  houghFilter->SetVariance( 5 );
-  houghFilter->SetDiscRadiusRatio( 10 );
-  */
-
-  //loop over slices
-  for(int i = 0; i < dims[2]; ++i)
+  if(m_SaveCircleList)
   {
-    //extract slice and transform
-    QString ss = QObject::tr("Hough Transforming Slice: %1").arg(i + 1);
-    notifyStatusMessage(ss);
-    ImageProcessingConstants::DefaultSliceType::Pointer inputSlice = ITKUtilitiesType::ExtractSlice(inputImage, ImageProcessingConstants::ZSlice, i);
-    houghFilter->SetInput( inputSlice );
-    houghFilter->Update();
-    ImageProcessingConstants::FloatSliceType::Pointer localAccumulator = houghFilter->GetOutput();
-
-    //find circles
-    ss = QObject::tr("Finding Circles on Slice: %1").arg(i + 1);
-    notifyStatusMessage(ss);
-    HoughTransformFilterType::CirclesListType circles = houghFilter->GetCircles();
-
-    //create blank slice of same dimensions
-    ImageProcessingConstants::DefaultSliceType::Pointer outputSlice = ImageProcessingConstants::DefaultSliceType::New();
-    ImageProcessingConstants::DefaultSliceType::RegionType region;
-    region.SetSize(inputSlice->GetLargestPossibleRegion().GetSize());
-    region.SetIndex(inputSlice->GetLargestPossibleRegion().GetIndex());
-    outputSlice->SetRegions( region );
-    outputSlice->SetOrigin(inputSlice->GetOrigin());
-    outputSlice->SetSpacing(inputSlice->GetSpacing());
-    outputSlice->Allocate();
-    outputSlice->FillBuffer(0);
-
-    //loop over circles drawing on slice
-    HoughTransformFilterType::CirclesListType::const_iterator itCircles = circles.begin();
-    while( itCircles != circles.end() )
+    //feature 0 is reserved, circles are numbered by slice
+    size_t numCircles = 0;
+    for(size_t i = 0; i < circles.size(); i++)
     {
-      //std::cout << "Center: ";
-      //std::cout << (*itCircles)->GetObjectToParentTransform()->GetOffset() << std::endl;
-      //std::cout << "Radius: " << (*itCircles)->GetRadius()[0] << std::endl;
-
-      for(double angle = 0; angle <= 2 * vnl_math::pi; angle += vnl_math::pi / 60.0 )
+      numCircles += circles[i].size();
+    }
+    std::vector<size_t> tDims(1, numCircles + 1);
+    m->getAttributeMatrix(getCircleAttributeMatrixName())->resizeAttributeArrays(tDims);
+    int32_t* slices = m_CircleSlicesPtr.lock()->getPointer(0);
+    float* centroids = m_CircleCentroidsPtr.lock()->getPointer(0);
+    float* radii = m_CircleRadiiPtr.lock()->getPointer(0);
+    float* votes = m_CircleVotesPtr.lock()->getPointer(0);
+    slices[0] = 0;
+    std::fill(centroids, centroids + 3, 0.0f);
+    radii[0] = 0.0f;
+    votes[0] = 0.0f;
+
+    //centroids are in physical coordinates (at the center of the slice's voxels)
+    FloatVec3Type origin = image->getOrigin();
+    FloatVec3Type spacing = image->getSpacing();
+    size_t feature = 1;
+    for(size_t i = 0; i < circles.size(); i++)
+    {
+      for(size_t j = 0; j < circles[i].size(); j++)
       {
-        localIndex[0] = (long int)((*itCircles)->GetObjectToParentTransform()->GetOffset()[0] + (*itCircles)->GETRADIUS()[0] * std::cos(angle));
-        localIndex[1] = (long int)((*itCircles)->GetObjectToParentTransform()->GetOffset()[1] + (*itCircles)->GETRADIUS()[0] * std::sin(angle));
-        ImageProcessingConstants::DefaultSliceType::RegionType outputRegion = outputSlice->GetLargestPossibleRegion();
-        if( outputRegion.IsInside( localIndex ) )
-        {
-          outputSlice->SetPixel( localIndex, 255 );
-        }
+        const HoughCircle& circle = circles[i][j];
+        slices[feature] = circle.slice;
+        centroids[3 * feature + 0] = origin[0] + (circle.center[0] + 0.5f) * spacing[0];
+        centroids[3 * feature + 1] = origin[1] + (circle.center[1] + 0.5f) * spacing[1];
+        centroids[3 * feature + 2] = origin[2] + (static_cast<float>(circle.slice) + 0.5f) * spacing[2];
+        radii[feature] = circle.radius;
+        votes[feature] = circle.votes;
+        feature++;
       }
-      itCircles++;
     }
-
-    //copy slice into output
-    ITKUtilitiesType::SetSlice(outputImage, outputSlice, ImageProcessingConstants::ZSlice, i);
   }
 
   //array name changing/cleanup
-  if(!m_SaveAsNewArray)
+  if(m_DrawCircles && !m_SaveAsNewArray)
   {
     AttributeMatrix::Pointer attrMat = m->getAttributeMatrix(m_SelectedCellArrayPath.getAttributeMatrixName());
     attrMat->removeAttributeArray(m_SelectedCellArrayPath.getDataArrayName());
@@ -424,3 +703,63 @@ int ItkHoughCircles::getNumberCircles() const
 {
   return m_NumberCircles;
 }
+
+// -----------------------------------------------------------------------------
+void ItkHoughCircles::setDrawCircles(bool value)
+{
+  m_DrawCircles = value;
+}
+
+// -----------------------------------------------------------------------------
+bool ItkHoughCircles::getDrawCircles() const
+{
+  return m_DrawCircles;
+}
+
+// -----------------------------------------------------------------------------
+void ItkHoughCircles::setSaveCircleList(bool value)
+{
+  m_SaveCircleList = value;
+}
+
+// -----------------------------------------------------------------------------
+bool ItkHoughCircles::getSaveCircleList() const
+{
+  return m_SaveCircleList;
+}
+
+// -----------------------------------------------------------------------------
+void ItkHoughCircles::setCircleAttributeMatrixName(const QString& value)
+{
+  m_CircleAttributeMatrixName = value;
+}
+
+// -----------------------------------------------------------------------------
+QString ItkHoughCircles::getCircleAttributeMatrixName() const
+{
+  return m_CircleAttributeMatrixName;
+}
+
+// -----------------------------------------------------------------------------
+void ItkHoughCircles::setCoarseToFine(bool value)
+{
+  m_CoarseToFine = value;
+}
+
+// -----------------------------------------------------------------------------
+bool ItkHoughCircles::getCoarseToFine() const
+{
+  return m_CoarseToFine;
+}
+
+// -----------------------------------------------------------------------------
+void ItkHoughCircles::setDownsampleFactor(int value)
+{
+  m_DownsampleFactor = value;
+}
+
+// -----------------------------------------------------------------------------
+int ItkHoughCircles::getDownsampleFactor() const
+{
+  return m_DownsampleFactor;
+}
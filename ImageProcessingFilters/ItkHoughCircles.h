@@ -66,6 +66,11 @@ class ImageProcessing_EXPORT ItkHoughCircles : public AbstractFilter
     PYB11_PROPERTY(float MinRadius READ getMinRadius WRITE setMinRadius)
     PYB11_PROPERTY(float MaxRadius READ getMaxRadius WRITE setMaxRadius)
     PYB11_PROPERTY(int NumberCircles READ getNumberCircles WRITE setNumberCircles)
+    PYB11_PROPERTY(bool DrawCircles READ getDrawCircles WRITE setDrawCircles)
+    PYB11_PROPERTY(bool SaveCircleList READ getSaveCircleList WRITE setSaveCircleList)
+    PYB11_PROPERTY(QString CircleAttributeMatrixName READ getCircleAttributeMatrixName WRITE setCircleAttributeMatrixName)
+    PYB11_PROPERTY(bool CoarseToFine READ getCoarseToFine WRITE setCoarseToFine)
+    PYB11_PROPERTY(int DownsampleFactor READ getDownsampleFactor WRITE setDownsampleFactor)
     PYB11_END_BINDINGS()
     // End Python bindings declarations
 
@@ -159,6 +164,66 @@ class ImageProcessing_EXPORT ItkHoughCircles : public AbstractFilter
 
     Q_PROPERTY(int NumberCircles READ getNumberCircles WRITE setNumberCircles)
 
+    /**
+     * @brief Setter property for DrawCircles
+     */
+    void setDrawCircles(bool value);
+    /**
+     * @brief Getter property for DrawCircles
+     * @return Value of DrawCircles
+     */
+    bool getDrawCircles() const;
+
+    Q_PROPERTY(bool DrawCircles READ getDrawCircles WRITE setDrawCircles)
+
+    /**
+     * @brief Setter property for SaveCircleList
+     */
+    void setSaveCircleList(bool value);
+    /**
+     * @brief Getter property for SaveCircleList
+     * @return Value of SaveCircleList
+     */
+    bool getSaveCircleList() const;
+
+    Q_PROPERTY(bool SaveCircleList READ getSaveCircleList WRITE setSaveCircleList)
+
+    /**
+     * @brief Setter property for CircleAttributeMatrixName
+     */
+    void setCircleAttributeMatrixName(const QString& value);
+    /**
+     * @brief Getter property for CircleAttributeMatrixName
+     * @return Value of CircleAttributeMatrixName
+     */
+    QString getCircleAttributeMatrixName() const;
+
+    Q_PROPERTY(QString CircleAttributeMatrixName READ getCircleAttributeMatrixName WRITE setCircleAttributeMatrixName)
+
+    /**
+     * @brief Setter property for CoarseToFine
+     */
+    void setCoarseToFine(bool value);
+    /**
+     * @brief Getter property for CoarseToFine
+     * @return Value of CoarseToFine
+     */
+    bool getCoarseToFine() const;
+
+    Q_PROPERTY(bool CoarseToFine READ getCoarseToFine WRITE setCoarseToFine)
+
+    /**
+     * @brief Setter property for DownsampleFactor
+     */
+    void setDownsampleFactor(int value);
+    /**
+     * @brief Getter property for DownsampleFactor
+     * @return Value of DownsampleFactor
+     */
+    int getDownsampleFactor() const;
+
+    Q_PROPERTY(int DownsampleFactor READ getDownsampleFactor WRITE setDownsampleFactor)
+
     /**
      * @brief getCompiledLibraryName Returns the name of the Library that this filter is a part of
      * @return
@@ -236,6 +301,10 @@ class ImageProcessing_EXPORT ItkHoughCircles : public AbstractFilter
     ImageProcessingConstants::DefaultPixelType* m_SelectedCellArray = nullptr;
     std::weak_ptr<DataArray<ImageProcessingConstants::DefaultPixelType>> m_NewCellArrayPtr;
     ImageProcessingConstants::DefaultPixelType* m_NewCellArray = nullptr;
+    std::weak_ptr<DataArray<int32_t>> m_CircleSlicesPtr;
+    std::weak_ptr<DataArray<float>> m_CircleCentroidsPtr;
+    std::weak_ptr<DataArray<float>> m_CircleRadiiPtr;
+    std::weak_ptr<DataArray<float>> m_CircleVotesPtr;
 
     DataArrayPath m_SelectedCellArrayPath = {"", "", ""};
     QString m_NewCellArrayName = {""};
@@ -243,6 +312,11 @@ class ImageProcessing_EXPORT ItkHoughCircles : public AbstractFilter
     float m_MinRadius = {0};
     float m_MaxRadius = {0};
     int m_NumberCircles = {0};
+    bool m_DrawCircles = {true};
+    bool m_SaveCircleList = {false};
+    QString m_CircleAttributeMatrixName = {"Circles"};
+    bool m_CoarseToFine = {false};
+    int m_DownsampleFactor = {4};
 
   public:
     ItkHoughCircles(const ItkHoughCircles&) = delete; // Copy Constructor Not Implemented
@@ -0,0 +1,742 @@
+/* ============================================================================
+ * Copyright (c) 2014 William Lenthe
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of William Lenthe or any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  This code was partially written under United States Air Force Contract number
+ *                              FA8650-10-D-5210
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ItkHoughSpheres.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QString>
+
+#include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
+#include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
+#include "SIMPLib/FilterParameters/FloatFilterParameter.h"
+#include "SIMPLib/FilterParameters/IntFilterParameter.h"
+#include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
+#include "SIMPLib/FilterParameters/StringFilterParameter.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
+
+#include "ImageProcessing/ImageProcessingConstants.h"
+#include "ImageProcessing/ImageProcessingHelpers.hpp"
+
+/* Create Enumerations to allow the created Attribute Arrays to take part in renaming */
+enum createdPathID : RenameDataPath::DataID_t
+{
+  AttributeMatrixID21 = 21,
+
+  DataArrayID31 = 31,
+  DataArrayID32 = 32,
+  DataArrayID33 = 33,
+  DataArrayID34 = 34,
+};
+
+namespace
+{
+//arrays of the sphere list attribute matrix
+const QString k_CentroidsArrayName("Centroids");
+const QString k_RadiusArrayName("Radius");
+const QString k_VotesArrayName("Votes");
+const QString k_SupportArrayName("Support");
+
+//accumulator cells are packed into 64 bits: 18 bits per center coordinate and 10 bits of radius
+const uint64_t k_CoordinateBits = 18;
+const uint64_t k_RadiusBits = 10;
+const int64_t k_MaxCoordinate = (int64_t(1) << k_CoordinateBits) - 1;
+const int64_t k_MaxRadius = (int64_t(1) << k_RadiusBits) - 1;
+
+uint64_t PackCell(const int64_t cell[4])
+{
+  return ((((static_cast<uint64_t>(cell[2]) << k_CoordinateBits) | static_cast<uint64_t>(cell[1])) << k_CoordinateBits | static_cast<uint64_t>(cell[0])) << k_RadiusBits) | static_cast<uint64_t>(cell[3]);
+}
+
+void UnpackCell(uint64_t key, int64_t cell[4])
+{
+  cell[3] = static_cast<int64_t>(key & k_MaxRadius);
+  key >>= k_RadiusBits;
+  for(size_t d = 0; d < 3; d++)
+  {
+    cell[d] = static_cast<int64_t>(key & k_MaxCoordinate);
+    key >>= k_CoordinateBits;
+  }
+}
+
+typedef std::unordered_map<uint64_t, uint32_t> VoteMap;
+
+struct Sphere
+{
+  float center[3];
+  float radius;
+  int32_t votes;
+  float support;
+};
+
+/**
+ * @brief The SphereVoteImpl class finds the edge voxels (sobel gradient magnitude above the threshold) of
+ * a range of chunks and casts one vote per radius on each side of the voxel along its gradient. every chunk votes into
+ * its own maps, one per partition of the accumulator, so chunks never share a map
+ */
+class SphereVoteImpl
+{
+public:
+  SphereVoteImpl(const ImageProcessingConstants::DefaultPixelType* input, const size_t dims[3], const int64_t radii[2], float edgeThreshold, std::vector<std::vector<VoteMap>>* votes)
+  : m_Input(input)
+  , m_Dims(dims)
+  , m_Radii(radii)
+  , m_EdgeThreshold(edgeThreshold)
+  , m_Votes(votes)
+  {
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    const size_t numChunks = m_Votes->size();
+    const size_t numRows = m_Dims[1] * m_Dims[2];
+    for(size_t chunk = range.min(); chunk < range.max(); chunk++)
+    {
+      std::vector<VoteMap>& maps = (*m_Votes)[chunk];
+      maps.assign(numChunks, VoteMap());
+      for(size_t row = numRows * chunk / numChunks; row < numRows * (chunk + 1) / numChunks; row++)
+      {
+        const size_t coords[3] = {0, row % m_Dims[1], row / m_Dims[1]};
+        for(size_t x = 0; x < m_Dims[0]; x++)
+        {
+          const size_t index = row * m_Dims[0] + x;
+          const size_t position[3] = {x, coords[1], coords[2]};
+          float gradient[3] = {0.0f, 0.0f, 0.0f};
+          float magnitude = 0.0f;
+          for(size_t d = 0; d < 3; d++)
+          {
+            //sobel: central difference along d smoothed (1 2 1) across the other two axes, edges replicated
+            const size_t a = (d + 1) % 3;
+            const size_t b = (d + 2) % 3;
+            for(int i = -1; i <= 1; i++)
+            {
+              for(int j = -1; j <= 1; j++)
+              {
+                const size_t center = Shift(Shift(index, position[a], i, a), position[b], j, b);
+                const float weight = static_cast<float>((2 - std::abs(i)) * (2 - std::abs(j)));
+                const float difference = static_cast<float>(m_Input[Shift(center, position[d], 1, d)]) - static_cast<float>(m_Input[Shift(center, position[d], -1, d)]);
+                gradient[d] += weight * difference;
+              }
+            }
+            gradient[d] /= 32.0f;
+            magnitude += gradient[d] * gradient[d];
+          }
+          magnitude = std::sqrt(magnitude);
+          if(magnitude < m_EdgeThreshold || 0.0f == magnitude)
+          {
+            continue;
+          }
+
+          //the center is inward for bright objects and outward for dark ones, vote both ways
+          for(int64_t r = m_Radii[0]; r <= m_Radii[1]; r++)
+          {
+            for(int sign = -1; sign <= 1; sign += 2)
+            {
+              int64_t cell[4] = {0, 0, 0, r};
+              bool inside = true;
+              for(size_t d = 0; d < 3 && inside; d++)
+              {
+                cell[d] = static_cast<int64_t>(std::floor(static_cast<double>(position[d]) + sign * r * gradient[d] / magnitude + 0.5));
+                inside = cell[d] >= 0 && cell[d] < static_cast<int64_t>(m_Dims[d]);
+              }
+              if(inside)
+              {
+                const uint64_t key = PackCell(cell);
+                maps[ImageProcessing::HashPartition(key, numChunks)][key]++;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+private:
+  //index of the neighbor 'step' voxels along an axis, clamped to the volume
+  size_t Shift(size_t index, size_t coordinate, int step, size_t axis) const
+  {
+    const size_t strides[3] = {1, m_Dims[0], m_Dims[0] * m_Dims[1]};
+    if(step < 0 && coordinate > 0)
+    {
+      return index - strides[axis];
+    }
+    if(step > 0 && coordinate + 1 < m_Dims[axis])
+    {
+      return index + strides[axis];
+    }
+    return index;
+  }
+
+  const ImageProcessingConstants::DefaultPixelType* m_Input;
+  const size_t* m_Dims;
+  const int64_t* m_Radii;
+  float m_EdgeThreshold;
+  std::vector<std::vector<VoteMap>>* m_Votes;
+};
+
+/**
+ * @brief The SphereMergeImpl class sums the votes of every chunk for a range of accumulator partitions, since a
+ * partition is only ever touched by one task no locking is needed
+ */
+class SphereMergeImpl
+{
+public:
+  SphereMergeImpl(std::vector<std::vector<VoteMap>>* votes, std::vector<VoteMap>* accumulator)
+  : m_Votes(votes)
+  , m_Accumulator(accumulator)
+  {
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    for(size_t p = range.min(); p < range.max(); p++)
+    {
+      VoteMap& merged = (*m_Accumulator)[p];
+      for(size_t chunk = 0; chunk < m_Votes->size(); chunk++)
+      {
+        VoteMap& votes = (*m_Votes)[chunk][p];
+        if(merged.empty())
+        {
+          merged.swap(votes);
+        }
+        else
+        {
+          for(VoteMap::const_iterator iter = votes.begin(); iter != votes.end(); ++iter)
+          {
+            merged[iter->first] += iter->second;
+          }
+        }
+        VoteMap().swap(votes);
+      }
+    }
+  }
+
+private:
+  std::vector<std::vector<VoteMap>>* m_Votes;
+  std::vector<VoteMap>* m_Accumulator;
+};
+
+/**
+ * @brief The SphereCandidateImpl class finds the accumulator cells of a range of partitions that are the largest of
+ * their 3x3x3 (center) x 3 (radius) neighborhood and whose neighborhood holds enough votes for the sphere's surface area.
+ * the neighborhood's vote weighted mean gives the sub voxel center and radius
+ */
+class SphereCandidateImpl
+{
+public:
+  SphereCandidateImpl(const std::vector<VoteMap>* accumulator, const size_t dims[3], float minimumSupport, std::vector<std::vector<Sphere>>* candidates)
+  : m_Accumulator(accumulator)
+  , m_Dims(dims)
+  , m_MinimumSupport(minimumSupport)
+  , m_Candidates(candidates)
+  {
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    const size_t numPartitions = m_Accumulator->size();
+    const double fourPi = 4.0 * 3.14159265358979323846;
+    for(size_t p = range.min(); p < range.max(); p++)
+    {
+      std::vector<Sphere>& candidates = (*m_Candidates)[p];
+      const VoteMap& votes = (*m_Accumulator)[p];
+      for(VoteMap::const_iterator iter = votes.begin(); iter != votes.end(); ++iter)
+      {
+        int64_t cell[4];
+        UnpackCell(iter->first, cell);
+        const double required = m_MinimumSupport * fourPi * static_cast<double>(cell[3] * cell[3]);
+        if(81.0 * iter->second < required)
+        {
+          continue;//even a neighborhood of cells this large can't reach the support
+        }
+
+        double sum = 0.0;
+        double weighted[4] = {0.0, 0.0, 0.0, 0.0};
+        bool maximum = true;
+        for(int64_t dr = -1; dr <= 1 && maximum; dr++)
+        {
+          for(int64_t dz = -1; dz <= 1 && maximum; dz++)
+          {
+            for(int64_t dy = -1; dy <= 1 && maximum; dy++)
+            {
+              for(int64_t dx = -1; dx <= 1 && maximum; dx++)
+              {
+                const int64_t neighbor[4] = {cell[0] + dx, cell[1] + dy, cell[2] + dz, cell[3] + dr};
+                bool inside = neighbor[3] >= 1 && neighbor[3] <= k_MaxRadius;
+                for(size_t d = 0; d < 3; d++)
+                {
+                  inside = inside && neighbor[d] >= 0 && neighbor[d] < static_cast<int64_t>(m_Dims[d]);
+                }
+                if(!inside)
+                {
+                  continue;
+                }
+                const uint64_t key = PackCell(neighbor);
+                const VoteMap& partition = (*m_Accumulator)[ImageProcessing::HashPartition(key, numPartitions)];
+                VoteMap::const_iterator found = partition.find(key);
+                if(found == partition.end())
+                {
+                  continue;
+                }
+                //ties go to the lowest key so a flat peak gives a single candidate
+                maximum = found->second < iter->second || (found->second == iter->second && key >= iter->first);
+                sum += found->second;
+                for(size_t d = 0; d < 4; d++)
+                {
+                  weighted[d] += static_cast<double>(found->second) * neighbor[d];
+                }
+              }
+            }
+          }
+        }
+        if(!maximum || sum < required)
+        {
+          continue;
+        }
+
+        Sphere sphere;
+        for(size_t d = 0; d < 3; d++)
+        {
+          sphere.center[d] = static_cast<float>(weighted[d] / sum);
+        }
+        sphere.radius = static_cast<float>(weighted[3] / sum);
+        sphere.votes = static_cast<int32_t>(sum);
+        sphere.support = static_cast<float>(sum / (fourPi * sphere.radius * sphere.radius));
+        candidates.push_back(sphere);
+      }
+    }
+  }
+
+private:
+  const std::vector<VoteMap>* m_Accumulator;
+  const size_t* m_Dims;
+  float m_MinimumSupport;
+  std::vector<std::vector<Sphere>>* m_Candidates;
+};
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ItkHoughSpheres::ItkHoughSpheres() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ItkHoughSpheres::~ItkHoughSpheres() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkHoughSpheres::setupFilterParameters()
+{
+  FilterParameterVectorType parameters;
+
+  parameters.push_back(SIMPL_NEW_FLOAT_FP("Minimum Radius", MinRadius, FilterParameter::Category::Parameter, ItkHoughSpheres));
+  parameters.push_back(SIMPL_NEW_FLOAT_FP("Maximum Radius", MaxRadius, FilterParameter::Category::Parameter, ItkHoughSpheres));
+  parameters.push_back(SIMPL_NEW_FLOAT_FP("Edge Threshold", EdgeThreshold, FilterParameter::Category::Parameter, ItkHoughSpheres));
+  parameters.push_back(SIMPL_NEW_FLOAT_FP("Minimum Support", MinimumSupport, FilterParameter::Category::Parameter, ItkHoughSpheres));
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Maximum Number of Spheres (0 for all)", NumberSpheres, FilterParameter::Category::Parameter, ItkHoughSpheres));
+  parameters.push_back(SeparatorFilterParameter::Create("Cell Data", FilterParameter::Category::RequiredArray));
+  {
+    DataArraySelectionFilterParameter::RequirementType req = DataArraySelectionFilterParameter::CreateCategoryRequirement(SIMPL::TypeNames::UInt8, 1, AttributeMatrix::Category::Any);
+    parameters.push_back(SIMPL_NEW_DA_SELECTION_FP("Attribute Array to Process", SelectedCellArrayPath, FilterParameter::Category::RequiredArray, ItkHoughSpheres, req));
+  }
+  parameters.push_back(SeparatorFilterParameter::Create("Feature Data", FilterParameter::Category::CreatedArray));
+  parameters.push_back(SIMPL_NEW_STRING_FP("Sphere Attribute Matrix", SphereAttributeMatrixName, FilterParameter::Category::CreatedArray, ItkHoughSpheres));
+
+  setFilterParameters(parameters);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkHoughSpheres::readFilterParameters(AbstractFilterParametersReader* reader, int index)
+{
+  reader->openFilterGroup(this, index);
+  setSelectedCellArrayPath( reader->readDataArrayPath( "SelectedCellArrayPath", getSelectedCellArrayPath() ) );
+  setMinRadius( reader->readValue( "MinRadius", getMinRadius() ) );
+  setMaxRadius( reader->readValue( "MaxRadius", getMaxRadius() ) );
+  setEdgeThreshold( reader->readValue( "EdgeThreshold", getEdgeThreshold() ) );
+  setMinimumSupport( reader->readValue( "MinimumSupport", getMinimumSupport() ) );
+  setNumberSpheres( reader->readValue( "NumberSpheres", getNumberSpheres() ) );
+  setSphereAttributeMatrixName( reader->readString( "SphereAttributeMatrixName", getSphereAttributeMatrixName() ) );
+  reader->closeFilterGroup();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkHoughSpheres::initialize()
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkHoughSpheres::dataCheck()
+{
+  clearErrorCode();
+  clearWarningCode();
+  DataArrayPath tempPath;
+
+  std::vector<size_t> dims(1, 1);
+  m_SelectedCellArrayPtr = getDataContainerArray()->getPrereqArrayFromPath<DataArray<ImageProcessingConstants::DefaultPixelType>>(this, getSelectedCellArrayPath(), dims);
+  if(nullptr != m_SelectedCellArrayPtr.lock())
+  { m_SelectedCellArray = m_SelectedCellArrayPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
+  if(getErrorCode() < 0)
+  {
+    return;
+  }
+
+  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getSelectedCellArrayPath().getDataContainerName());
+  ImageGeom::Pointer image = m->getPrereqGeometry<ImageGeom>(this);
+  if(getErrorCode() < 0 || nullptr == image.get())
+  {
+    return;
+  }
+
+  if(m_MinRadius < 1.0f || m_MaxRadius < m_MinRadius || m_MaxRadius > static_cast<float>(k_MaxRadius))
+  {
+    QString ss = QObject::tr("The radii must satisfy 1 <= Minimum Radius <= Maximum Radius <= %1").arg(k_MaxRadius);
+    setErrorCondition(-5566, ss);
+    return;
+  }
+  //votes are cast at integer radii, so the range has to hold at least one
+  if(std::ceil(m_MinRadius) > std::floor(m_MaxRadius))
+  {
+    QString ss = QObject::tr("There is no integer radius between the Minimum Radius (%1) and the Maximum Radius (%2)").arg(m_MinRadius).arg(m_MaxRadius);
+    setErrorCondition(-5590, ss);
+    return;
+  }
+  SizeVec3Type udims = image->getDimensions();
+  for(size_t d = 0; d < 3; d++)
+  {
+    if(udims[d] > static_cast<size_t>(k_MaxCoordinate) + 1)
+    {
+      QString ss = QObject::tr("The volume can't be larger than %1 voxels along any axis").arg(k_MaxCoordinate + 1);
+      setErrorCondition(-5567, ss);
+      return;
+    }
+  }
+
+  //one feature per sphere, the number of spheres is only known after voting
+  std::vector<size_t> tDims(1, 0);
+  m->createNonPrereqAttributeMatrix(this, getSphereAttributeMatrixName(), tDims, AttributeMatrix::Type::CellFeature, AttributeMatrixID21);
+  if(getErrorCode() < 0)
+  {
+    return;
+  }
+  std::vector<size_t> vectorDims(1, 3);
+  tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getSphereAttributeMatrixName(), k_CentroidsArrayName);
+  m_SphereCentroidsPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<float>>(this, tempPath, 0, vectorDims, "", DataArrayID31);
+  tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getSphereAttributeMatrixName(), k_RadiusArrayName);
+  m_SphereRadiiPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<float>>(this, tempPath, 0, dims, "", DataArrayID32);
+  tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getSphereAttributeMatrixName(), k_VotesArrayName);
+  m_SphereVotesPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<int32_t>>(this, tempPath, 0, dims, "", DataArrayID33);
+  tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getSphereAttributeMatrixName(), k_SupportArrayName);
+  m_SphereSupportPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<float>>(this, tempPath, 0, dims, "", DataArrayID34);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkHoughSpheres::execute()
+{
+  dataCheck();
+  if(getErrorCode() < 0)
+  {
+    return;
+  }
+
+  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getSelectedCellArrayPath().getDataContainerName());
+  ImageGeom::Pointer image = m->getGeometryAs<ImageGeom>();
+  SizeVec3Type udims = image->getDimensions();
+  const size_t dims[3] = {udims[0], udims[1], udims[2]};
+  const int64_t radii[2] = {static_cast<int64_t>(std::ceil(m_MinRadius)), static_cast<int64_t>(std::floor(m_MaxRadius))};
+
+  //vote, every chunk of rows into its own partitioned maps
+  notifyStatusMessage("Voting");
+  const size_t numChunks = std::max<size_t>(1, 2 * std::thread::hardware_concurrency());
+  std::vector<std::vector<VoteMap>> votes(numChunks);
+  ParallelDataAlgorithm dataAlg;
+  dataAlg.setRange(0, numChunks);
+  dataAlg.execute(SphereVoteImpl(m_SelectedCellArray, dims, radii, m_EdgeThreshold, &votes));
+  if(getCancel())
+  {
+    return;
+  }
+
+  //merge partition by partition
+  notifyStatusMessage("Merging Votes");
+  std::vector<VoteMap> accumulator(numChunks);
+  dataAlg.execute(SphereMergeImpl(&votes, &accumulator));
+  votes.clear();
+
+  //peaks of the accumulator
+  notifyStatusMessage("Finding Spheres");
+  std::vector<std::vector<Sphere>> candidates(numChunks);
+  dataAlg.execute(SphereCandidateImpl(&accumulator, dims, m_MinimumSupport, &candidates));
+  accumulator.clear();
+  std::vector<Sphere> spheres;
+  for(size_t i = 0; i < candidates.size(); i++)
+  {
+    spheres.insert(spheres.end(), candidates[i].begin(), candidates[i].end());
+  }
+  std::sort(spheres.begin(), spheres.end(), [](const Sphere& lhs, const Sphere& rhs) {
+    if(lhs.support != rhs.support)
+    {
+      return lhs.support > rhs.support;
+    }
+    return std::lexicographical_compare(lhs.center, lhs.center + 3, rhs.center, rhs.center + 3);
+  });
+
+  //strongest first, a sphere whose center is inside a stronger sphere is the same object (or an echo of its surface)
+  std::vector<Sphere> accepted;
+  for(size_t i = 0; i < spheres.size(); i++)
+  {
+    if(m_NumberSpheres > 0 && accepted.size() >= static_cast<size_t>(m_NumberSpheres))
+    {
+      break;
+    }
+    bool duplicate = false;
+    for(size_t j = 0; j < accepted.size() && !duplicate; j++)
+    {
+      float distance = 0.0f;
+      for(size_t d = 0; d < 3; d++)
+      {
+        distance += (spheres[i].center[d] - accepted[j].center[d]) * (spheres[i].center[d] - accepted[j].center[d]);
+      }
+      duplicate = distance < accepted[j].radius * accepted[j].radius;
+    }
+    if(!duplicate)
+    {
+      accepted.push_back(spheres[i]);
+    }
+  }
+
+  //feature 0 is reserved, centroids are in physical coordinates
+  std::vector<size_t> tDims(1, accepted.size() + 1);
+  m->getAttributeMatrix(getSphereAttributeMatrixName())->resizeAttributeArrays(tDims);
+  float* centroids = m_SphereCentroidsPtr.lock()->getPointer(0);
+  float* sphereRadii = m_SphereRadiiPtr.lock()->getPointer(0);
+  int32_t* sphereVotes = m_SphereVotesPtr.lock()->getPointer(0);
+  float* support = m_SphereSupportPtr.lock()->getPointer(0);
+  std::fill(centroids, centroids + 3, 0.0f);
+  sphereRadii[0] = 0.0f;
+  sphereVotes[0] = 0;
+  support[0] = 0.0f;
+  FloatVec3Type origin = image->getOrigin();
+  FloatVec3Type spacing = image->getSpacing();
+  for(size_t i = 0; i < accepted.size(); i++)
+  {
+    for(size_t d = 0; d < 3; d++)
+    {
+      centroids[3 * (i + 1) + d] = origin[d] + (accepted[i].center[d] + 0.5f) * spacing[d];
+    }
+    sphereRadii[i + 1] = accepted[i].radius;
+    sphereVotes[i + 1] = accepted[i].votes;
+    support[i + 1] = accepted[i].support;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer ItkHoughSpheres::newFilterInstance(bool copyFilterParameters) const
+{
+  ItkHoughSpheres::Pointer filter = ItkHoughSpheres::New();
+  if(copyFilterParameters)
+  {
+    copyFilterParameterInstanceVariables(filter.get());
+  }
+  return filter;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ItkHoughSpheres::getCompiledLibraryName() const
+{return ImageProcessingConstants::ImageProcessingBaseName;}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ItkHoughSpheres::getGroupName() const
+{return SIMPL::FilterGroups::Unsupported;}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QUuid ItkHoughSpheres::getUuid() const
+{
+  return QUuid("{5c4e6f2a-8d1b-5e93-a7c4-3f2b9d0e6a17}");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ItkHoughSpheres::getSubGroupName() const
+{return "Misc";}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ItkHoughSpheres::getHumanLabel() const
+{ return "Hough Sphere Detection (ImageProcessing)"; }
+
+// -----------------------------------------------------------------------------
+ItkHoughSpheres::Pointer ItkHoughSpheres::NullPointer()
+{
+  return Pointer(static_cast<Self*>(nullptr));
+}
+
+// -----------------------------------------------------------------------------
+std::shared_ptr<ItkHoughSpheres> ItkHoughSpheres::New()
+{
+  struct make_shared_enabler : public ItkHoughSpheres
+  {
+  };
+  std::shared_ptr<make_shared_enabler> val = std::make_shared<make_shared_enabler>();
+  val->setupFilterParameters();
+  return val;
+}
+
+// -----------------------------------------------------------------------------
+QString ItkHoughSpheres::getNameOfClass() const
+{
+  return QString("ItkHoughSpheres");
+}
+
+// -----------------------------------------------------------------------------
+QString ItkHoughSpheres::ClassName()
+{
+  return QString("ItkHoughSpheres");
+}
+
+// -----------------------------------------------------------------------------
+void ItkHoughSpheres::setSelectedCellArrayPath(const DataArrayPath& value)
+{
+  m_SelectedCellArrayPath = value;
+}
+
+// -----------------------------------------------------------------------------
+DataArrayPath ItkHoughSpheres::getSelectedCellArrayPath() const
+{
+  return m_SelectedCellArrayPath;
+}
+
+// -----------------------------------------------------------------------------
+void ItkHoughSpheres::setMinRadius(float value)
+{
+  m_MinRadius = value;
+}
+
+// -----------------------------------------------------------------------------
+float ItkHoughSpheres::getMinRadius() const
+{
+  return m_MinRadius;
+}
+
+// -----------------------------------------------------------------------------
+void ItkHoughSpheres::setMaxRadius(float value)
+{
+  m_MaxRadius = value;
+}
+
+// -----------------------------------------------------------------------------
+float ItkHoughSpheres::getMaxRadius() const
+{
+  return m_MaxRadius;
+}
+
+// -----------------------------------------------------------------------------
+void ItkHoughSpheres::setEdgeThreshold(float value)
+{
+  m_EdgeThreshold = value;
+}
+
+// -----------------------------------------------------------------------------
+float ItkHoughSpheres::getEdgeThreshold() const
+{
+  return m_EdgeThreshold;
+}
+
+// -----------------------------------------------------------------------------
+void ItkHoughSpheres::setMinimumSupport(float value)
+{
+  m_MinimumSupport = value;
+}
+
+// -----------------------------------------------------------------------------
+float ItkHoughSpheres::getMinimumSupport() const
+{
+  return m_MinimumSupport;
+}
+
+// -----------------------------------------------------------------------------
+void ItkHoughSpheres::setNumberSpheres(int value)
+{
+  m_NumberSpheres = value;
+}
+
+// -----------------------------------------------------------------------------
+int ItkHoughSpheres::getNumberSpheres() const
+{
+  return m_NumberSpheres;
+}
+
+// -----------------------------------------------------------------------------
+void ItkHoughSpheres::setSphereAttributeMatrixName(const QString& value)
+{
+  m_SphereAttributeMatrixName = value;
+}
+
+// -----------------------------------------------------------------------------
+QString ItkHoughSpheres::getSphereAttributeMatrixName() const
+{
+  return m_SphereAttributeMatrixName;
+}
@@ -0,0 +1,273 @@
+/* ============================================================================
+ * Copyright (c) 2014 William Lenthe
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of William Lenthe or any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  This code was partially written under United States Air Force Contract number
+ *                              FA8650-10-D-5210
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <memory>
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+#include "SIMPLib/DataArrays/DataArray.hpp"
+
+#include "ImageProcessing/ImageProcessingConstants.h"
+
+#include "ImageProcessing/ImageProcessingDLLExport.h"
+
+/**
+ * @class ItkHoughSpheres ItkHoughSpheres.h ImageProcessing/ImageProcessingFilters/ItkHoughSpheres.h
+ * @brief Finds spheres in a volume with a 3D hough transform that only votes along the gradient of edge voxels
+ * into a sparse accumulator
+ * @author
+ * @date
+ * @version 1.0
+ */
+class ImageProcessing_EXPORT ItkHoughSpheres : public AbstractFilter
+{
+    Q_OBJECT
+
+    // Start Python bindings declarations
+    PYB11_BEGIN_BINDINGS(ItkHoughSpheres SUPERCLASS AbstractFilter)
+    PYB11_FILTER()
+    PYB11_SHARED_POINTERS(ItkHoughSpheres)
+    PYB11_FILTER_NEW_MACRO(ItkHoughSpheres)
+    PYB11_PROPERTY(DataArrayPath SelectedCellArrayPath READ getSelectedCellArrayPath WRITE setSelectedCellArrayPath)
+    PYB11_PROPERTY(float MinRadius READ getMinRadius WRITE setMinRadius)
+    PYB11_PROPERTY(float MaxRadius READ getMaxRadius WRITE setMaxRadius)
+    PYB11_PROPERTY(float EdgeThreshold READ getEdgeThreshold WRITE setEdgeThreshold)
+    PYB11_PROPERTY(float MinimumSupport READ getMinimumSupport WRITE setMinimumSupport)
+    PYB11_PROPERTY(int NumberSpheres READ getNumberSpheres WRITE setNumberSpheres)
+    PYB11_PROPERTY(QString SphereAttributeMatrixName READ getSphereAttributeMatrixName WRITE setSphereAttributeMatrixName)
+    PYB11_END_BINDINGS()
+    // End Python bindings declarations
+
+  public:
+    using Self = ItkHoughSpheres;
+    using Pointer = std::shared_ptr<Self>;
+    using ConstPointer = std::shared_ptr<const Self>;
+    using WeakPointer = std::weak_ptr<Self>;
+    using ConstWeakPointer = std::weak_ptr<const Self>;
+    static Pointer NullPointer();
+
+    static std::shared_ptr<ItkHoughSpheres> New();
+
+    /**
+     * @brief Returns the name of the class for ItkHoughSpheres
+     */
+    QString getNameOfClass() const override;
+    /**
+     * @brief Returns the name of the class for ItkHoughSpheres
+     */
+    static QString ClassName();
+
+    ~ItkHoughSpheres() override;
+
+    /**
+     * @brief Setter property for SelectedCellArrayPath
+     */
+    void setSelectedCellArrayPath(const DataArrayPath& value);
+    /**
+     * @brief Getter property for SelectedCellArrayPath
+     * @return Value of SelectedCellArrayPath
+     */
+    DataArrayPath getSelectedCellArrayPath() const;
+
+    Q_PROPERTY(DataArrayPath SelectedCellArrayPath READ getSelectedCellArrayPath WRITE setSelectedCellArrayPath)
+
+    /**
+     * @brief Setter property for MinRadius
+     */
+    void setMinRadius(float value);
+    /**
+     * @brief Getter property for MinRadius
+     * @return Value of MinRadius
+     */
+    float getMinRadius() const;
+
+    Q_PROPERTY(float MinRadius READ getMinRadius WRITE setMinRadius)
+
+    /**
+     * @brief Setter property for MaxRadius
+     */
+    void setMaxRadius(float value);
+    /**
+     * @brief Getter property for MaxRadius
+     * @return Value of MaxRadius
+     */
+    float getMaxRadius() const;
+
+    Q_PROPERTY(float MaxRadius READ getMaxRadius WRITE setMaxRadius)
+
+    /**
+     * @brief Setter property for EdgeThreshold
+     */
+    void setEdgeThreshold(float value);
+    /**
+     * @brief Getter property for EdgeThreshold
+     * @return Value of EdgeThreshold
+     */
+    float getEdgeThreshold() const;
+
+    Q_PROPERTY(float EdgeThreshold READ getEdgeThreshold WRITE setEdgeThreshold)
+
+    /**
+     * @brief Setter property for MinimumSupport
+     */
+    void setMinimumSupport(float value);
+    /**
+     * @brief Getter property for MinimumSupport
+     * @return Value of MinimumSupport
+     */
+    float getMinimumSupport() const;
+
+    Q_PROPERTY(float MinimumSupport READ getMinimumSupport WRITE setMinimumSupport)
+
+    /**
+     * @brief Setter property for NumberSpheres
+     */
+    void setNumberSpheres(int value);
+    /**
+     * @brief Getter property for NumberSpheres
+     * @return Value of NumberSpheres
+     */
+    int getNumberSpheres() const;
+
+    Q_PROPERTY(int NumberSpheres READ getNumberSpheres WRITE setNumberSpheres)
+
+    /**
+     * @brief Setter property for SphereAttributeMatrixName
+     */
+    void setSphereAttributeMatrixName(const QString& value);
+    /**
+     * @brief Getter property for SphereAttributeMatrixName
+     * @return Value of SphereAttributeMatrixName
+     */
+    QString getSphereAttributeMatrixName() const;
+
+    Q_PROPERTY(QString SphereAttributeMatrixName READ getSphereAttributeMatrixName WRITE setSphereAttributeMatrixName)
+
+    /**
+     * @brief getCompiledLibraryName Returns the name of the Library that this filter is a part of
+     * @return
+     */
+    QString getCompiledLibraryName() const override;
+
+    /**
+    * @brief This returns a string that is displayed in the GUI. It should be readable
+    * and understandable by humans.
+    */
+    QString getHumanLabel() const override;
+
+    /**
+    * @brief This returns the group that the filter belonds to. You can select
+    * a different group if you want. The string returned here will be displayed
+    * in the GUI for the filter
+    */
+    QString getGroupName() const override;
+
+    /**
+    * @brief This returns a string that is displayed in the GUI and helps to sort the filters into
+    * a subgroup. It should be readable and understandable by humans.
+    */
+    QString getSubGroupName() const override;
+
+    /**
+     * @brief getUuid Return the unique identifier for this filter.
+     * @return A QUuid object.
+     */
+    QUuid getUuid() const override;
+
+    /**
+    * @brief This method will instantiate all the end user settable options/parameters
+    * for this filter
+    */
+    void setupFilterParameters() override;
+
+    /**
+    * @brief This method will read the options from a file
+    * @param reader The reader that is used to read the options from a file
+    * @param index The index to read the information from
+    */
+    void readFilterParameters(AbstractFilterParametersReader* reader, int index) override;
+
+    /**
+     * @brief Reimplemented from @see AbstractFilter class
+     */
+    void execute() override;
+
+
+    /**
+     * @brief newFilterInstance Returns a new instance of the filter optionally copying the filter parameters from the
+     * current filter to the new instance.
+     * @param copyFilterParameters
+     * @return
+     */
+    AbstractFilter::Pointer newFilterInstance(bool copyFilterParameters) const override;
+
+  protected:
+    ItkHoughSpheres();
+
+    /**
+     * @brief dataCheck Checks for the appropriate parameter values and availability of arrays
+     */
+    void dataCheck() override;
+
+    /**
+     * @brief Initializes all the private instance variables.
+     */
+    void initialize();
+
+
+  private:
+    std::weak_ptr<DataArray<ImageProcessingConstants::DefaultPixelType>> m_SelectedCellArrayPtr;
+    ImageProcessingConstants::DefaultPixelType* m_SelectedCellArray = nullptr;
+    std::weak_ptr<DataArray<float>> m_SphereCentroidsPtr;
+    std::weak_ptr<DataArray<float>> m_SphereRadiiPtr;
+    std::weak_ptr<DataArray<int32_t>> m_SphereVotesPtr;
+    std::weak_ptr<DataArray<float>> m_SphereSupportPtr;
+
+    DataArrayPath m_SelectedCellArrayPath = {"", "", ""};
+    float m_MinRadius = {5.0f};
+    float m_MaxRadius = {20.0f};
+    float m_EdgeThreshold = {32.0f};
+    float m_MinimumSupport = {1.0f};
+    int m_NumberSpheres = {0};
+    QString m_SphereAttributeMatrixName = {"Spheres"};
+
+  public:
+    ItkHoughSpheres(const ItkHoughSpheres&) = delete; // Copy Constructor Not Implemented
+    ItkHoughSpheres(ItkHoughSpheres&&) = delete;      // Move Constructor Not Implemented
+    ItkHoughSpheres& operator=(const ItkHoughSpheres&) = delete; // Copy Assignment Not Implemented
+    ItkHoughSpheres& operator=(ItkHoughSpheres&&) = delete;      // Move Assignment Not Implemented
+};
+
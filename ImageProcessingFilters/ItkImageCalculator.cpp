@@ -35,32 +35,29 @@
 
 #include "ItkImageCalculator.h"
 
-#include "itkAbsoluteValueDifferenceImageFilter.h"
-#include "itkAddImageFilter.h"
-#include "itkAndImageFilter.h"
-#include "itkBinaryFunctorImageFilter.h"
-#include "itkDivideImageFilter.h"
-#include "itkMaximumImageFilter.h"
-#include "itkMinimumImageFilter.h"
-#include "itkMultiplyImageFilter.h"
-#include "itkOrImageFilter.h"
-#include "itkSubtractImageFilter.h"
-#include "itkUnaryFunctorImageFilter.h"
-#include "itkXorImageFilter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <QtCore/QStringList>
 
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
 #include "SIMPLib/FilterParameters/ChoiceFilterParameter.h"
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
+#include "SIMPLib/FilterParameters/LinkedBooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/LinkedPathCreationFilterParameter.h"
+#include "SIMPLib/FilterParameters/MultiDataArraySelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
 #include "SIMPLib/Geometry/ImageGeom.h"
-#include "SIMPLib/ITK/itkBridge.h"
 #include "SIMPLib/DataContainers/DataContainerArray.h"
 #include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
 
 #include "ImageProcessing/ImageProcessingConstants.h"
-#include "ImageProcessing/ImageProcessingHelpers.hpp"
 
 /* Create Enumerations to allow the created Attribute Arrays to take part in renaming */
 enum createdPathID : RenameDataPath::DataID_t
@@ -69,6 +66,247 @@ enum createdPathID : RenameDataPath::DataID_t
   DataArrayID31 = 31,
 };
 
+namespace
+{
+/**
+ * @brief Integer type wide enough to hold the sum, difference and product of two pixels without overflow
+ */
+template <typename T>
+using WideType = typename std::conditional<sizeof(T) == 1, int32_t, int64_t>::type;
+
+struct AddOp
+{
+  template <typename W> static W apply(W a, W b) { return a + b; }
+};
+
+struct SubtractOp
+{
+  template <typename W> static W apply(W a, W b) { return a - b; }
+};
+
+struct MultiplyOp
+{
+  template <typename W> static W apply(W a, W b) { return a * b; }
+};
+
+/**
+ * @brief Rounds half up like the old float pipeline; division by zero saturates to the type maximum (which the clamp produces)
+ */
+struct DivideOp
+{
+  template <typename W> static W apply(W a, W b) { return 0 == b ? std::numeric_limits<W>::max() : (2 * a + b) / (2 * b); }
+};
+
+struct AndOp
+{
+  template <typename W> static W apply(W a, W b) { return a & b; }
+};
+
+struct OrOp
+{
+  template <typename W> static W apply(W a, W b) { return a | b; }
+};
+
+struct XorOp
+{
+  template <typename W> static W apply(W a, W b) { return a ^ b; }
+};
+
+struct MinOp
+{
+  template <typename W> static W apply(W a, W b) { return std::min(a, b); }
+};
+
+struct MaxOp
+{
+  template <typename W> static W apply(W a, W b) { return std::max(a, b); }
+};
+
+/**
+ * @brief Truncates like the old Mean functor
+ */
+struct MeanOp
+{
+  template <typename W> static W apply(W a, W b) { return (a + b) / 2; }
+};
+
+struct DifferenceOp
+{
+  template <typename W> static W apply(W a, W b) { return a > b ? a - b : b - a; }
+};
+
+/**
+ * @brief The CalculatorImpl class applies a pixelwise operator in the widened integer type and saturates straight into the output,
+ * so there is no intermediate float image and no second rounding pass. The operator is a template parameter so each loop is
+ * branch free and can be vectorized by the compiler.
+ */
+template <typename T, typename Op>
+class CalculatorImpl
+{
+public:
+  CalculatorImpl(const T* input1, const T* input2, T* output)
+  : m_Input1(input1)
+  , m_Input2(input2)
+  , m_Output(output)
+  {
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    using W = WideType<T>;
+    const W lo = static_cast<W>(std::numeric_limits<T>::min());
+    const W hi = static_cast<W>(std::numeric_limits<T>::max());
+    for(size_t i = range.min(); i < range.max(); i++)
+    {
+      const W value = Op::apply(static_cast<W>(m_Input1[i]), static_cast<W>(m_Input2[i]));
+      m_Output[i] = static_cast<T>(std::min(std::max(value, lo), hi));
+    }
+  }
+
+private:
+  const T* m_Input1;
+  const T* m_Input2;
+  T* m_Output;
+};
+
+template <typename T, typename Op>
+void Calculate(const T* input1, const T* input2, T* output, size_t count)
+{
+  ParallelDataAlgorithm dataAlg;
+  dataAlg.setRange(0, count);
+  dataAlg.execute(CalculatorImpl<T, Op>(input1, input2, output));
+}
+
+/**
+ * @brief The ReduceImpl class combines any number of arrays voxel by voxel. Voxels are handled in small blocks so every
+ * input is streamed once, sequentially, while the 64 bit accumulators for the block stay in cache.
+ */
+template <typename T>
+class ReduceImpl
+{
+public:
+  enum Reduction
+  {
+    Mean = 0,
+    Sum = 1,
+    Min = 2,
+    Max = 3,
+    Median = 4,
+    StandardDeviation = 5
+  };
+
+  ReduceImpl(const std::vector<const T*>& inputs, unsigned int reduction, T* output)
+  : m_Inputs(inputs)
+  , m_Reduction(reduction)
+  , m_Output(output)
+  {
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    static const size_t k_BlockSize = 4096;
+    const size_t n = m_Inputs.size();
+    const int64_t lo = static_cast<int64_t>(std::numeric_limits<T>::min());
+    const int64_t hi = static_cast<int64_t>(std::numeric_limits<T>::max());
+    std::vector<int64_t> acc(k_BlockSize);
+    std::vector<int64_t> accSq(StandardDeviation == m_Reduction ? k_BlockSize : 0);
+    std::vector<T> values(Median == m_Reduction ? k_BlockSize * n : 0);
+    for(size_t start = range.min(); start < range.max(); start += k_BlockSize)
+    {
+      const size_t count = std::min(k_BlockSize, range.max() - start);
+      T* output = m_Output + start;
+
+      if(Median == m_Reduction)
+      {
+        //transpose the block so each voxel's values are contiguous, then select the middle value(s)
+        for(size_t k = 0; k < n; k++)
+        {
+          const T* input = m_Inputs[k] + start;
+          for(size_t j = 0; j < count; j++)
+          {
+            values[j * n + k] = input[j];
+          }
+        }
+        const size_t half = n / 2;
+        for(size_t j = 0; j < count; j++)
+        {
+          T* first = values.data() + j * n;
+          std::nth_element(first, first + half, first + n);
+          int64_t median = static_cast<int64_t>(first[half]);
+          if(0 == n % 2)
+          {
+            //average the two middle values, rounding half up
+            median = (median + static_cast<int64_t>(*std::max_element(first, first + half)) + 1) / 2;
+          }
+          output[j] = static_cast<T>(median);
+        }
+        continue;
+      }
+
+      if(Min == m_Reduction || Max == m_Reduction)
+      {
+        std::copy(m_Inputs[0] + start, m_Inputs[0] + start + count, output);
+        for(size_t k = 1; k < n; k++)
+        {
+          const T* input = m_Inputs[k] + start;
+          for(size_t j = 0; j < count; j++)
+          {
+            output[j] = Min == m_Reduction ? std::min(output[j], input[j]) : std::max(output[j], input[j]);
+          }
+        }
+        continue;
+      }
+
+      //mean, sum and standard deviation share the accumulation pass
+      std::fill(acc.begin(), acc.begin() + count, 0);
+      if(StandardDeviation == m_Reduction)
+      {
+        std::fill(accSq.begin(), accSq.begin() + count, 0);
+      }
+      for(size_t k = 0; k < n; k++)
+      {
+        const T* input = m_Inputs[k] + start;
+        for(size_t j = 0; j < count; j++)
+        {
+          acc[j] += static_cast<int64_t>(input[j]);
+        }
+        if(StandardDeviation == m_Reduction)
+        {
+          for(size_t j = 0; j < count; j++)
+          {
+            accSq[j] += static_cast<int64_t>(input[j]) * static_cast<int64_t>(input[j]);
+          }
+        }
+      }
+
+      const int64_t count64 = static_cast<int64_t>(n);
+      for(size_t j = 0; j < count; j++)
+      {
+        int64_t value = acc[j];
+        if(Mean == m_Reduction)
+        {
+          //round half up (floor division so negative sums round the same way)
+          const int64_t num = 2 * acc[j] + count64;
+          value = num >= 0 ? num / (2 * count64) : -((-num + 2 * count64 - 1) / (2 * count64));
+        }
+        else if(StandardDeviation == m_Reduction)
+        {
+          //population standard deviation from the exact integer moments
+          const double variance = static_cast<double>(count64 * accSq[j] - acc[j] * acc[j]) / static_cast<double>(count64 * count64);
+          value = static_cast<int64_t>(std::sqrt(std::max(variance, 0.0)) + 0.5);
+        }
+        output[j] = static_cast<T>(std::min(std::max(value, lo), hi));
+      }
+    }
+  }
+
+private:
+  std::vector<const T*> m_Inputs;
+  unsigned int m_Reduction;
+  T* m_Output;
+};
+} // namespace
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -85,6 +323,30 @@ ItkImageCalculator::~ItkImageCalculator() = default;
 void ItkImageCalculator::setupFilterParameters()
 {
   FilterParameterVectorType parameters;
+  {
+    QStringList linkedProps;
+    linkedProps << "SelectedCellArrayPaths"
+                << "Reduction";
+    parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Reduce Multiple Arrays", UseMultipleArrays, FilterParameter::Category::Parameter, ItkImageCalculator, linkedProps));
+  }
+  {
+    ChoiceFilterParameter::Pointer parameter = ChoiceFilterParameter::New();
+    parameter->setHumanLabel("Reduction");
+    parameter->setPropertyName("Reduction");
+    parameter->setSetterCallback(SIMPL_BIND_SETTER(ItkImageCalculator, this, Reduction));
+    parameter->setGetterCallback(SIMPL_BIND_GETTER(ItkImageCalculator, this, Reduction));
+
+    std::vector<QString> choices;
+    choices.push_back("Mean");
+    choices.push_back("Sum");
+    choices.push_back("Min");
+    choices.push_back("Max");
+    choices.push_back("Median");
+    choices.push_back("Standard Deviation");
+    parameter->setChoices(choices);
+    parameter->setCategory(FilterParameter::Category::Parameter);
+    parameters.push_back(parameter);
+  }
   parameters.push_back(SeparatorFilterParameter::Create("Cell Data", FilterParameter::Category::RequiredArray));
   {
     DataArraySelectionFilterParameter::RequirementType req = DataArraySelectionFilterParameter::CreateCategoryRequirement(SIMPL::TypeNames::UInt8, 1, AttributeMatrix::Category::Any);
@@ -117,6 +379,11 @@ void ItkImageCalculator::setupFilterParameters()
     DataArraySelectionFilterParameter::RequirementType req = DataArraySelectionFilterParameter::CreateCategoryRequirement(SIMPL::TypeNames::UInt8, 1, AttributeMatrix::Category::Any);
     parameters.push_back(SIMPL_NEW_DA_SELECTION_FP("Second Array to Process", SelectedCellArrayPath2, FilterParameter::Category::RequiredArray, ItkImageCalculator, req));
   }
+  {
+    MultiDataArraySelectionFilterParameter::RequirementType req =
+        MultiDataArraySelectionFilterParameter::CreateCategoryRequirement(SIMPL::TypeNames::UInt8, 1, AttributeMatrix::Category::Any);
+    parameters.push_back(SIMPL_NEW_MDA_SELECTION_FP("Arrays to Reduce", SelectedCellArrayPaths, FilterParameter::Category::RequiredArray, ItkImageCalculator, req));
+  }
   parameters.push_back(SeparatorFilterParameter::Create("Cell Data", FilterParameter::Category::CreatedArray));
   parameters.push_back(
       SIMPL_NEW_DA_WITH_LINKED_AM_FP("Output Attribute Array", NewCellArrayName, SelectedCellArrayPath1, SelectedCellArrayPath1, FilterParameter::Category::CreatedArray, ItkImageCalculator));
@@ -133,6 +400,9 @@ void ItkImageCalculator::readFilterParameters(AbstractFilterParametersReader* re
   setOperator( reader->readValue( "Operator", getOperator() ) );
   setSelectedCellArrayPath2( reader->readDataArrayPath( "SelectedCellArrayPath2", getSelectedCellArrayPath2() ) );
   setNewCellArrayName( reader->readString( "NewCellArrayName", getNewCellArrayName() ) );
+  setUseMultipleArrays( reader->readValue( "UseMultipleArrays", getUseMultipleArrays() ) );
+  setSelectedCellArrayPaths( reader->readDataArrayPathVector( "SelectedCellArrayPaths", getSelectedCellArrayPaths() ) );
+  setReduction( reader->readValue( "Reduction", getReduction() ) );
   reader->closeFilterGroup();
 }
 
@@ -153,6 +423,64 @@ void ItkImageCalculator::dataCheck()
   DataArrayPath tempPath;
 
   std::vector<size_t> dims(1, 1);
+  if(m_UseMultipleArrays)
+  {
+    if(m_SelectedCellArrayPaths.size() < 2)
+    {
+      QString ss = QObject::tr("At least 2 arrays must be selected to reduce");
+      setErrorCondition(-5569, ss);
+      return;
+    }
+
+    m_SelectedCellArraysPtrs.clear();
+    for(const DataArrayPath& path : m_SelectedCellArrayPaths)
+    {
+      std::weak_ptr<DataArray<ImageProcessingConstants::DefaultPixelType>> arrayPtr =
+          getDataContainerArray()->getPrereqArrayFromPath<DataArray<ImageProcessingConstants::DefaultPixelType>>(this, path, dims);
+      if(getErrorCode() < 0)
+      {
+        return;
+      }
+      ImageGeom::Pointer image = getDataContainerArray()->getDataContainer(path.getDataContainerName())->getPrereqGeometry<ImageGeom>(this);
+      if(getErrorCode() < 0 || nullptr == image.get())
+      {
+        return;
+      }
+      if(!m_SelectedCellArraysPtrs.empty() && arrayPtr.lock()->getNumberOfTuples() != m_SelectedCellArraysPtrs.front().lock()->getNumberOfTuples())
+      {
+        QString ss = QObject::tr("The selected arrays must have the same number of tuples (%1 has %2, expected %3)")
+                         .arg(path.getDataArrayName())
+                         .arg(arrayPtr.lock()->getNumberOfTuples())
+                         .arg(m_SelectedCellArraysPtrs.front().lock()->getNumberOfTuples());
+        setErrorCondition(-5568, ss);
+        return;
+      }
+      m_SelectedCellArraysPtrs.push_back(arrayPtr);
+    }
+
+    //the output goes where the "Output Attribute Array" parameter shows it, next to the first array to process
+    AttributeMatrix::Pointer outputAM = getDataContainerArray()->getPrereqAttributeMatrixFromPath(this, getSelectedCellArrayPath1(), -5591);
+    if(getErrorCode() < 0 || nullptr == outputAM.get())
+    {
+      return;
+    }
+    if(outputAM->getNumberOfTuples() != m_SelectedCellArraysPtrs.front().lock()->getNumberOfTuples())
+    {
+      QString ss = QObject::tr("The Attribute Matrix of the output array must have as many tuples as the arrays to reduce (%1 has %2, expected %3)")
+                       .arg(getSelectedCellArrayPath1().getAttributeMatrixName())
+                       .arg(outputAM->getNumberOfTuples())
+                       .arg(m_SelectedCellArraysPtrs.front().lock()->getNumberOfTuples());
+      setErrorCondition(-5592, ss);
+      return;
+    }
+
+    tempPath.update(getSelectedCellArrayPath1().getDataContainerName(), getSelectedCellArrayPath1().getAttributeMatrixName(), getNewCellArrayName());
+    m_NewCellArrayPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<ImageProcessingConstants::DefaultPixelType>>(this, tempPath, 0, dims, "", DataArrayID31);
+    if(nullptr != m_NewCellArrayPtr.lock())
+    { m_NewCellArray = m_NewCellArrayPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
+    return;
+  }
+
   m_SelectedCellArray1Ptr = getDataContainerArray()->getPrereqArrayFromPath<DataArray<ImageProcessingConstants::DefaultPixelType>>(this, getSelectedCellArrayPath1(), dims);
   if(nullptr != m_SelectedCellArray1Ptr.lock())
   { m_SelectedCellArray1 = m_SelectedCellArray1Ptr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
@@ -181,6 +509,15 @@ void ItkImageCalculator::dataCheck()
     return;
   }
 
+  if(m_SelectedCellArray1Ptr.lock()->getNumberOfTuples() != m_SelectedCellArray2Ptr.lock()->getNumberOfTuples())
+  {
+    QString ss = QObject::tr("The selected arrays must have the same number of tuples (%1 vs %2)")
+                     .arg(m_SelectedCellArray1Ptr.lock()->getNumberOfTuples())
+                     .arg(m_SelectedCellArray2Ptr.lock()->getNumberOfTuples());
+    setErrorCondition(-5568, ss);
+    return;
+  }
+
   tempPath.update(getSelectedCellArrayPath1().getDataContainerName(), getSelectedCellArrayPath1().getAttributeMatrixName(), getNewCellArrayName() );
   m_NewCellArrayPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<ImageProcessingConstants::DefaultPixelType>>(
       this, tempPath, 0, dims, "", DataArrayID31);
@@ -200,148 +537,70 @@ void ItkImageCalculator::execute()
     return;
   }
 
-  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getSelectedCellArrayPath1().getDataContainerName());
-  QString attrMatName = getSelectedCellArrayPath1().getAttributeMatrixName();
-
-  //wrap m_RawImageData as itk::image
-  ImageProcessingConstants::DefaultImageType::Pointer inputImage1 = ITKUtilitiesType::CreateItkWrapperForDataPointer(m, attrMatName, m_SelectedCellArray1);
-  ImageProcessingConstants::DefaultImageType::Pointer inputImage2 = ITKUtilitiesType::CreateItkWrapperForDataPointer(m, attrMatName, m_SelectedCellArray2);
-
-  //define filters
-  typedef itk::AddImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType> AddType;//
-  typedef itk::SubtractImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType> SubtractType;//
-  typedef itk::MultiplyImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType> MultiplyType;//
-  typedef itk::DivideImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType> DivideType;//
-  typedef itk::AndImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::DefaultImageType> AndType;
-  typedef itk::OrImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::DefaultImageType> OrType;
-  typedef itk::XorImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::DefaultImageType> XorType;
-  typedef itk::MinimumImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::DefaultImageType> MinType;
-  typedef itk::MaximumImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::DefaultImageType> MaxType;
-  typedef itk::BinaryFunctorImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType, ImageProcessing::Functor::Mean<ImageProcessingConstants::DefaultPixelType> > MeanType;
-  typedef itk::AbsoluteValueDifferenceImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType> DifferenceType;
-
-  //set up filters to cap image ranges
-  typedef itk::UnaryFunctorImageFilter< ImageProcessingConstants::FloatImageType, ImageProcessingConstants::DefaultImageType, ImageProcessing::Functor::LimitsRound<ImageProcessingConstants::FloatPixelType, ImageProcessingConstants::DefaultPixelType> > LimitsRoundType;
-  LimitsRoundType::Pointer limitsRound = LimitsRoundType::New();
-
-  //set up and run selected filter
-  switch(m_Operator)
+  using PixelType = ImageProcessingConstants::DefaultPixelType;
+  const size_t totalPoints = m_NewCellArrayPtr.lock()->getNumberOfTuples();
+  const PixelType* input1 = m_SelectedCellArray1;
+  const PixelType* input2 = m_SelectedCellArray2;
+
+  if(m_UseMultipleArrays)
   {
-    case 0://add
+    std::vector<const PixelType*> inputs;
+    for(const std::weak_ptr<DataArray<PixelType>>& arrayPtr : m_SelectedCellArraysPtrs)
     {
-      AddType::Pointer add = AddType::New();
-      add->SetInput1(inputImage1);
-      add->SetInput2(inputImage2);
-      limitsRound->SetInput(add->GetOutput());
-      ITKUtilitiesType::SetITKFilterOutput(limitsRound->GetOutput(), m_NewCellArrayPtr.lock());
-      limitsRound->Update();
+      inputs.push_back(arrayPtr.lock()->getPointer(0));
     }
-    break;
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(0, m_NewCellArrayPtr.lock()->getNumberOfTuples());
+    dataAlg.execute(ReduceImpl<PixelType>(inputs, m_Reduction, m_NewCellArray));
+    return;
+  }
+
+  //every operator is a single saturating pass straight into the output array
+  switch(m_Operator)
+  {
+    case 0://add
+      Calculate<PixelType, AddOp>(input1, input2, m_NewCellArray, totalPoints);
+      break;
 
     case 1://subtract
-    {
-      SubtractType::Pointer subtract = SubtractType::New();
-      subtract->SetInput1(inputImage1);
-      subtract->SetInput2(inputImage2);
-      limitsRound->SetInput(subtract->GetOutput());
-      ITKUtilitiesType::SetITKFilterOutput(limitsRound->GetOutput(), m_NewCellArrayPtr.lock());
-      limitsRound->Update();
-    }
-    break;
+      Calculate<PixelType, SubtractOp>(input1, input2, m_NewCellArray, totalPoints);
+      break;
 
     case 2://multiply
-    {
-      MultiplyType::Pointer multiply = MultiplyType::New();
-      multiply->SetInput1(inputImage1);
-      multiply->SetInput2(inputImage2);
-      limitsRound->SetInput(multiply->GetOutput());
-      ITKUtilitiesType::SetITKFilterOutput(limitsRound->GetOutput(), m_NewCellArrayPtr.lock());
-      limitsRound->Update();
-    }
-    break;
+      Calculate<PixelType, MultiplyOp>(input1, input2, m_NewCellArray, totalPoints);
+      break;
 
     case 3://divide
-    {
-      DivideType::Pointer divide = DivideType::New();
-      divide->SetInput1(inputImage1);
-      divide->SetInput2(inputImage2);
-      limitsRound->SetInput(divide->GetOutput());
-      ITKUtilitiesType::SetITKFilterOutput(limitsRound->GetOutput(), m_NewCellArrayPtr.lock());
-      limitsRound->Update();
-    }
-    break;
+      Calculate<PixelType, DivideOp>(input1, input2, m_NewCellArray, totalPoints);
+      break;
 
     case 4://and
-    {
-      AndType::Pointer andfilter = AndType::New();
-      andfilter->SetInput1(inputImage1);
-      andfilter->SetInput2(inputImage2);
-      ITKUtilitiesType::SetITKFilterOutput(andfilter->GetOutput(), m_NewCellArrayPtr.lock());
-      andfilter->Update();
-    }
-    break;
+      Calculate<PixelType, AndOp>(input1, input2, m_NewCellArray, totalPoints);
+      break;
 
     case 5://or
-    {
-      OrType::Pointer orfilter = OrType::New();
-      orfilter->SetInput1(inputImage1);
-      orfilter->SetInput2(inputImage2);
-      ITKUtilitiesType::SetITKFilterOutput(orfilter->GetOutput(), m_NewCellArrayPtr.lock());
-      orfilter->Update();
-    }
-    break;
+      Calculate<PixelType, OrOp>(input1, input2, m_NewCellArray, totalPoints);
+      break;
 
     case 6://xor
-    {
-      XorType::Pointer xorfilter = XorType::New();
-      xorfilter->SetInput1(inputImage1);
-      xorfilter->SetInput2(inputImage2);
-      ITKUtilitiesType::SetITKFilterOutput(xorfilter->GetOutput(), m_NewCellArrayPtr.lock());
-      xorfilter->Update();
-    }
-    break;
+      Calculate<PixelType, XorOp>(input1, input2, m_NewCellArray, totalPoints);
+      break;
 
     case 7://min
-    {
-      MinType::Pointer minimum = MinType::New();
-      minimum->SetInput1(inputImage1);
-      minimum->SetInput2(inputImage2);
-      ITKUtilitiesType::SetITKFilterOutput(minimum->GetOutput(), m_NewCellArrayPtr.lock());
-      minimum->Update();
-    }
-    break;
+      Calculate<PixelType, MinOp>(input1, input2, m_NewCellArray, totalPoints);
+      break;
 
     case 8://max
-    {
-      MaxType::Pointer maximum = MaxType::New();
-      maximum->SetInput1(inputImage1);
-      maximum->SetInput2(inputImage2);
-      ITKUtilitiesType::SetITKFilterOutput(maximum->GetOutput(), m_NewCellArrayPtr.lock());
-      maximum->Update();
-    }
-    break;
+      Calculate<PixelType, MaxOp>(input1, input2, m_NewCellArray, totalPoints);
+      break;
 
     case 9://mean
-    {
-      MeanType::Pointer mean = MeanType::New();
-      mean->SetInput1(inputImage1);
-      mean->SetInput2(inputImage2);
-      limitsRound->SetInput(mean->GetOutput());
-      ITKUtilitiesType::SetITKFilterOutput(limitsRound->GetOutput(), m_NewCellArrayPtr.lock());
-      limitsRound->Update();
-    }
-    break;
+      Calculate<PixelType, MeanOp>(input1, input2, m_NewCellArray, totalPoints);
+      break;
 
     case 10://difference
-    {
-      DifferenceType::Pointer difference = DifferenceType::New();
-      difference->SetInput1(inputImage1);
-      difference->SetInput2(inputImage2);
-      limitsRound->SetInput(difference->GetOutput());
-      ITKUtilitiesType::SetITKFilterOutput(limitsRound->GetOutput(), m_NewCellArrayPtr.lock());
-      limitsRound->Update();
-    }
-    break;
+      Calculate<PixelType, DifferenceOp>(input1, input2, m_NewCellArray, totalPoints);
+      break;
   }
 }
 
@@ -485,3 +744,39 @@ unsigned int ItkImageCalculator::getOperator() const
 {
   return m_Operator;
 }
+
+// -----------------------------------------------------------------------------
+void ItkImageCalculator::setUseMultipleArrays(bool value)
+{
+  m_UseMultipleArrays = value;
+}
+
+// -----------------------------------------------------------------------------
+bool ItkImageCalculator::getUseMultipleArrays() const
+{
+  return m_UseMultipleArrays;
+}
+
+// -----------------------------------------------------------------------------
+void ItkImageCalculator::setSelectedCellArrayPaths(const std::vector<DataArrayPath>& value)
+{
+  m_SelectedCellArrayPaths = value;
+}
+
+// -----------------------------------------------------------------------------
+std::vector<DataArrayPath> ItkImageCalculator::getSelectedCellArrayPaths() const
+{
+  return m_SelectedCellArrayPaths;
+}
+
+// -----------------------------------------------------------------------------
+void ItkImageCalculator::setReduction(unsigned int value)
+{
+  m_Reduction = value;
+}
+
+// -----------------------------------------------------------------------------
+unsigned int ItkImageCalculator::getReduction() const
+{
+  return m_Reduction;
+}
@@ -35,6 +35,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include <QtCore/QString>
 
@@ -66,6 +67,9 @@ class ImageProcessing_EXPORT ItkImageCalculator : public AbstractFilter
     PYB11_PROPERTY(DataArrayPath SelectedCellArrayPath2 READ getSelectedCellArrayPath2 WRITE setSelectedCellArrayPath2)
     PYB11_PROPERTY(QString NewCellArrayName READ getNewCellArrayName WRITE setNewCellArrayName)
     PYB11_PROPERTY(unsigned int Operator READ getOperator WRITE setOperator)
+    PYB11_PROPERTY(bool UseMultipleArrays READ getUseMultipleArrays WRITE setUseMultipleArrays)
+    PYB11_PROPERTY(std::vector<DataArrayPath> SelectedCellArrayPaths READ getSelectedCellArrayPaths WRITE setSelectedCellArrayPaths)
+    PYB11_PROPERTY(unsigned int Reduction READ getReduction WRITE setReduction)
     PYB11_END_BINDINGS()
     // End Python bindings declarations
 
@@ -138,6 +142,42 @@ class ImageProcessing_EXPORT ItkImageCalculator : public AbstractFilter
 
     Q_PROPERTY(unsigned int Operator READ getOperator WRITE setOperator)
 
+    /**
+     * @brief Setter property for UseMultipleArrays
+     */
+    void setUseMultipleArrays(bool value);
+    /**
+     * @brief Getter property for UseMultipleArrays
+     * @return Value of UseMultipleArrays
+     */
+    bool getUseMultipleArrays() const;
+
+    Q_PROPERTY(bool UseMultipleArrays READ getUseMultipleArrays WRITE setUseMultipleArrays)
+
+    /**
+     * @brief Setter property for SelectedCellArrayPaths
+     */
+    void setSelectedCellArrayPaths(const std::vector<DataArrayPath>& value);
+    /**
+     * @brief Getter property for SelectedCellArrayPaths
+     * @return Value of SelectedCellArrayPaths
+     */
+    std::vector<DataArrayPath> getSelectedCellArrayPaths() const;
+
+    Q_PROPERTY(std::vector<DataArrayPath> SelectedCellArrayPaths READ getSelectedCellArrayPaths WRITE setSelectedCellArrayPaths)
+
+    /**
+     * @brief Setter property for Reduction
+     */
+    void setReduction(unsigned int value);
+    /**
+     * @brief Getter property for Reduction
+     * @return Value of Reduction
+     */
+    unsigned int getReduction() const;
+
+    Q_PROPERTY(unsigned int Reduction READ getReduction WRITE setReduction)
+
     /**
      * @brief getCompiledLibraryName Returns the name of the Library that this filter is a part of
      * @return
@@ -215,6 +255,7 @@ class ImageProcessing_EXPORT ItkImageCalculator : public AbstractFilter
     ImageProcessingConstants::DefaultPixelType* m_SelectedCellArray1 = nullptr;
     std::weak_ptr<DataArray<ImageProcessingConstants::DefaultPixelType>> m_SelectedCellArray2Ptr;
     ImageProcessingConstants::DefaultPixelType* m_SelectedCellArray2 = nullptr;
+    std::vector<std::weak_ptr<DataArray<ImageProcessingConstants::DefaultPixelType>>> m_SelectedCellArraysPtrs;
     std::weak_ptr<DataArray<ImageProcessingConstants::DefaultPixelType>> m_NewCellArrayPtr;
     ImageProcessingConstants::DefaultPixelType* m_NewCellArray = nullptr;
 
@@ -222,6 +263,9 @@ class ImageProcessing_EXPORT ItkImageCalculator : public AbstractFilter
     DataArrayPath m_SelectedCellArrayPath2 = {"", "", ""};
     QString m_NewCellArrayName = {""};
     unsigned int m_Operator = {0};
+    bool m_UseMultipleArrays = {false};
+    std::vector<DataArrayPath> m_SelectedCellArrayPaths = {};
+    unsigned int m_Reduction = {0};
 
   public:
     ItkImageCalculator(const ItkImageCalculator&) = delete; // Copy Constructor Not Implemented
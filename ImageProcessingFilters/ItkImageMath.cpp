@@ -35,20 +35,11 @@
 
 #include "ItkImageMath.h"
 
-#include "SIMPLib/ITK/itkBridge.h"
-#include "itkAddImageFilter.h"
-#include "itkBinaryFunctorImageFilter.h"
-#include "itkDivideImageFilter.h"
-#include "itkExpImageFilter.h"
-#include "itkInvertIntensityImageFilter.h"
-#include "itkLogImageFilter.h"
-#include "itkMaximumImageFilter.h"
-#include "itkMinimumImageFilter.h"
-#include "itkMultiplyImageFilter.h"
-#include "itkSqrtImageFilter.h"
-#include "itkSquareImageFilter.h"
-#include "itkSubtractImageFilter.h"
-#include "itkUnaryFunctorImageFilter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
 
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/DoubleFilterParameter.h"
@@ -61,6 +52,7 @@
 #include "SIMPLib/Geometry/ImageGeom.h"
 #include "SIMPLib/DataContainers/DataContainerArray.h"
 #include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
 
 #include "ImageProcessing/ImageProcessingConstants.h"
 #include "ImageProcessing/ImageProcessingHelpers.hpp"
@@ -72,6 +64,102 @@ enum createdPathID : RenameDataPath::DataID_t
   DataArrayID31 = 31,
 };
 
+namespace
+{
+/**
+ * @brief Builds the output of the operator for every possible input value, in double precision and rounded / clamped
+ * exactly as the float image pipeline was (gamma is normalized by the pixel type's maximum)
+ * @param op operator index (as listed in the Operator choices)
+ * @param value operand of the binary operators and exponent of gamma
+ * @return table indexed by input value - lowest input value
+ */
+template <typename T>
+std::vector<T> CreateLookupTable(unsigned int op, double value)
+{
+  const int64_t lowest = static_cast<int64_t>(std::numeric_limits<T>::min());
+  const int64_t highest = static_cast<int64_t>(std::numeric_limits<T>::max());
+  const double maxValue = static_cast<double>(std::numeric_limits<T>::max());
+  const double constant = static_cast<double>(static_cast<float>(value));
+  ImageProcessing::Functor::LimitsRound<double, T> limitsRound;
+  std::vector<T> lut(static_cast<size_t>(highest - lowest + 1));
+  for(int64_t i = lowest; i <= highest; i++)
+  {
+    const double a = static_cast<double>(i);
+    double result = a;
+    switch(op)
+    {
+      case 0://add
+        result = a + constant;
+        break;
+      case 1://subtract
+        result = a - constant;
+        break;
+      case 2://multiply
+        result = a * constant;
+        break;
+      case 3://divide
+        result = 0.0 == constant ? std::numeric_limits<double>::max() : a / constant;
+        break;
+      case 4://min
+        result = std::min(a, constant);
+        break;
+      case 5://max
+        result = std::max(a, constant);
+        break;
+      case 6://gamma
+        result = std::pow(a / maxValue, constant) * maxValue;
+        break;
+      case 7://log
+        result = std::log(a);
+        break;
+      case 8://exp
+        result = std::exp(a);
+        break;
+      case 9://square
+        result = a * a;
+        break;
+      case 10://squareroot
+        result = std::sqrt(a);
+        break;
+      case 11://invert
+        result = maxValue - a;
+        break;
+    }
+    lut[static_cast<size_t>(i - lowest)] = std::isnan(result) ? static_cast<T>(0) : limitsRound(result);
+  }
+  return lut;
+}
+
+/**
+ * @brief The LookupImpl class replaces every value with its table entry
+ */
+template <typename T>
+class LookupImpl
+{
+public:
+  LookupImpl(const T* input, const T* lut, T* output)
+  : m_Input(input)
+  , m_Lut(lut)
+  , m_Output(output)
+  {
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    const int64_t lowest = static_cast<int64_t>(std::numeric_limits<T>::min());
+    for(size_t i = range.min(); i < range.max(); i++)
+    {
+      m_Output[i] = m_Lut[static_cast<int64_t>(m_Input[i]) - lowest];
+    }
+  }
+
+private:
+  const T* m_Input;
+  const T* m_Lut;
+  T* m_Output;
+};
+} // namespace
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -174,15 +262,15 @@ void ItkImageMath::dataCheck()
     return;
   }
 
-  if(!m_SaveAsNewArray)
+  //the lookup only reads each voxel before writing it, so without a new array it is done in place
+  if(m_SaveAsNewArray)
   {
-    m_NewCellArrayName = "thisIsATempName";
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getSelectedCellArrayPath().getAttributeMatrixName(), getNewCellArrayName() );
+    m_NewCellArrayPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<ImageProcessingConstants::DefaultPixelType>>(
+        this, tempPath, 0, dims, "", DataArrayID31);
+    if(nullptr != m_NewCellArrayPtr.lock())
+    { m_NewCellArray = m_NewCellArrayPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
   }
-  tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getSelectedCellArrayPath().getAttributeMatrixName(), getNewCellArrayName() );
-  m_NewCellArrayPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<ImageProcessingConstants::DefaultPixelType>>(
-      this, tempPath, 0, dims, "", DataArrayID31);
-  if(nullptr != m_NewCellArrayPtr.lock())
-  { m_NewCellArray = m_NewCellArrayPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
 }
 
 // -----------------------------------------------------------------------------
@@ -197,167 +285,13 @@ void ItkImageMath::execute()
     return;
   }
 
-  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getSelectedCellArrayPath().getDataContainerName());
-  QString attrMatName = getSelectedCellArrayPath().getAttributeMatrixName();
-
-  //wrap m_RawImageData as itk::image
-  ImageProcessingConstants::DefaultImageType::Pointer inputImage = ITKUtilitiesType::CreateItkWrapperForDataPointer(m, attrMatName, m_SelectedCellArray);
-
-  //define filter types
-  typedef itk::AddImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType, ImageProcessingConstants::FloatImageType> AddType;
-  typedef itk::SubtractImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType, ImageProcessingConstants::FloatImageType> SubtractType;
-  typedef itk::MultiplyImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType, ImageProcessingConstants::FloatImageType> MultiplyType;
-  typedef itk::DivideImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType, ImageProcessingConstants::FloatImageType> DivideType;
-  typedef itk::MinimumImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType, ImageProcessingConstants::FloatImageType> MinType;
-  typedef itk::MaximumImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType, ImageProcessingConstants::FloatImageType> MaxType;
-  typedef itk::BinaryFunctorImageFilter< ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType, ImageProcessingConstants::FloatImageType, ImageProcessing::Functor::Gamma<ImageProcessingConstants::FloatPixelType> > GammaType;
-  typedef itk::LogImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType> LogType;
-  typedef itk::ExpImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType> ExpType;
-  typedef itk::SquareImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType> SquareType;
-  typedef itk::SqrtImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::FloatImageType> SqrtType;
-  typedef itk::InvertIntensityImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::DefaultImageType> InvertType;
-
-  //set up filter to cap image range + round
-  typedef itk::UnaryFunctorImageFilter< ImageProcessingConstants::FloatImageType, ImageProcessingConstants::DefaultImageType, ImageProcessing::Functor::LimitsRound<ImageProcessingConstants::FloatPixelType, ImageProcessingConstants::DefaultPixelType> > LimitsRoundType;
-  LimitsRoundType::Pointer limitsRound = LimitsRoundType::New();
-
-  //apply selected operation
-  switch(m_Operator)
-  {
-    case 0://add
-    {
-      AddType::Pointer add = AddType::New();
-      add->SetInput1(inputImage);
-      add->SetConstant2(m_Value);
-      limitsRound->SetInput(add->GetOutput());
-      ITKUtilitiesType::SetITKFilterOutput(limitsRound->GetOutput(), m_NewCellArrayPtr.lock());
-      limitsRound->Update();
-    }
-    break;
-
-    case 1://subtract
-    {
-      SubtractType::Pointer subtract = SubtractType::New();
-      subtract->SetInput1(inputImage);
-      subtract->SetConstant2(m_Value);
-      limitsRound->SetInput(subtract->GetOutput());
-      ITKUtilitiesType::SetITKFilterOutput(limitsRound->GetOutput(), m_NewCellArrayPtr.lock());
-      limitsRound->Update();
-    }
-    break;
-
-    case 2://multiply
-    {
-      MultiplyType::Pointer multiply = MultiplyType::New();
-      multiply->SetInput1(inputImage);
-      multiply->SetConstant2(m_Value);
-      limitsRound->SetInput(multiply->GetOutput());
-      ITKUtilitiesType::SetITKFilterOutput(limitsRound->GetOutput(), m_NewCellArrayPtr.lock());
-      limitsRound->Update();
-    }
-    break;
-
-    case 3://divide
-    {
-      DivideType::Pointer divide = DivideType::New();
-      divide->SetInput1(inputImage);
-      divide->SetConstant2(m_Value);
-      limitsRound->SetInput(divide->GetOutput());
-      ITKUtilitiesType::SetITKFilterOutput(limitsRound->GetOutput(), m_NewCellArrayPtr.lock());
-      limitsRound->Update();
-    }
-    break;
-
-    case 4://min
-    {
-      MinType::Pointer minimum = MinType::New();
-      minimum->SetInput1(inputImage);
-      minimum->SetConstant2(m_Value);
-      limitsRound->SetInput(minimum->GetOutput());
-      ITKUtilitiesType::SetITKFilterOutput(limitsRound->GetOutput(), m_NewCellArrayPtr.lock());
-      limitsRound->Update();
-    }
-    break;
-
-    case 5://max
-    {
-      MaxType::Pointer maximum = MaxType::New();
-      maximum->SetInput1(inputImage);
-      maximum->SetConstant2(m_Value);
-      limitsRound->SetInput(maximum->GetOutput());
-      ITKUtilitiesType::SetITKFilterOutput(limitsRound->GetOutput(), m_NewCellArrayPtr.lock());
-      limitsRound->Update();
-    }
-    break;
-
-    case 6://gamma
-    {
-      GammaType::Pointer gamma = GammaType::New();
-      gamma->SetInput1(inputImage);
-      gamma->SetConstant2(m_Value);
-      limitsRound->SetInput(gamma->GetOutput());
-      ITKUtilitiesType::SetITKFilterOutput(limitsRound->GetOutput(), m_NewCellArrayPtr.lock());
-      limitsRound->Update();
-    }
-    break;
-
-    case 7://log
-    {
-      LogType::Pointer logfilter = LogType::New();
-      logfilter->SetInput(inputImage);
-      limitsRound->SetInput(logfilter->GetOutput());
-      ITKUtilitiesType::SetITKFilterOutput(limitsRound->GetOutput(), m_NewCellArrayPtr.lock());
-      limitsRound->Update();
-    }
-    break;
-
-    case 8://exp
-    {
-      ExpType::Pointer expfilter = ExpType::New();
-      expfilter->SetInput(inputImage);
-      limitsRound->SetInput(expfilter->GetOutput());
-      ITKUtilitiesType::SetITKFilterOutput(limitsRound->GetOutput(), m_NewCellArrayPtr.lock());
-      limitsRound->Update();
-    }
-    break;
-
-    case 9://square
-    {
-      SquareType::Pointer square = SquareType::New();
-      square->SetInput(inputImage);
-      limitsRound->SetInput(square->GetOutput());
-      ITKUtilitiesType::SetITKFilterOutput(limitsRound->GetOutput(), m_NewCellArrayPtr.lock());
-      limitsRound->Update();
-    }
-    break;
-
-    case 10://squareroot
-    {
-      SqrtType::Pointer sqrtfilter = SqrtType::New();
-      sqrtfilter->SetInput(inputImage);
-      limitsRound->SetInput(sqrtfilter->GetOutput());
-      ITKUtilitiesType::SetITKFilterOutput(limitsRound->GetOutput(), m_NewCellArrayPtr.lock());
-      limitsRound->Update();
-    }
-    break;
-
-    case 11://invert
-    {
-      InvertType::Pointer invert = InvertType::New();
-      invert->SetInput(inputImage);
-      ITKUtilitiesType::SetITKFilterOutput(invert->GetOutput(), m_NewCellArrayPtr.lock());
-      invert->Update();
-    }
-    break;
-  }
-
-  //array name changing/cleanup
-  if(!m_SaveAsNewArray)
-  {
-    AttributeMatrix::Pointer attrMat = m->getAttributeMatrix(m_SelectedCellArrayPath.getAttributeMatrixName());
-    attrMat->removeAttributeArray(m_SelectedCellArrayPath.getDataArrayName());
-    attrMat->renameAttributeArray(m_NewCellArrayName, m_SelectedCellArrayPath.getDataArrayName());
-  }
+  //every operator is a function of the input value alone, so it is evaluated once per possible value
+  using PixelType = ImageProcessingConstants::DefaultPixelType;
+  std::vector<PixelType> lut = CreateLookupTable<PixelType>(m_Operator, m_Value);
+  PixelType* output = m_SaveAsNewArray ? m_NewCellArray : m_SelectedCellArray;
+  ParallelDataAlgorithm dataAlg;
+  dataAlg.setRange(0, m_SelectedCellArrayPtr.lock()->getNumberOfTuples());
+  dataAlg.execute(LookupImpl<PixelType>(m_SelectedCellArray, lut.data(), output));
 }
 
 // -----------------------------------------------------------------------------
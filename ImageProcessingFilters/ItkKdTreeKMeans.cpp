@@ -35,11 +35,16 @@
 
 #include "ItkKdTreeKMeans.h"
 
-#include "itkImageKmeansModelEstimator.h"
-#include "itkMinimumMaximumImageCalculator.h"
-#include "itkScalarImageKmeansImageFilter.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 #include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/Common/SIMPLRange.h"
 #include "SIMPLib/Common/TemplateHelpers.h"
 #include "SIMPLib/DataContainers/DataContainerArray.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
@@ -52,8 +57,10 @@
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
 #include "SIMPLib/Geometry/ImageGeom.h"
 #include "SIMPLib/ITK/itkBridge.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
 
 #include "ImageProcessing/ImageProcessingConstants.h"
+#include "ImageProcessing/ImageProcessingHelpers.hpp"
 
 /* Create Enumerations to allow the created Attribute Arrays to take part in renaming */
 enum createdPathID : RenameDataPath::DataID_t
@@ -63,16 +70,611 @@ enum createdPathID : RenameDataPath::DataID_t
 };
 
 /**
- * @brief The itkKdTreeKMeansTemplate class is a templated wrapper for the itkKdTreeBasedKmeansEstimator class
+ * @brief The ComponentRangeImpl class finds the minimum and maximum of each component of a multi-component array
  */
 template <typename DataType>
-class itkKdTreeKMeansTemplate
+class ComponentRangeImpl
+{
+public:
+  ComponentRangeImpl(const DataType* data, size_t numComps, std::vector<double>* min, std::vector<double>* max, std::mutex* mutex)
+  : m_Data(data)
+  , m_NumComps(numComps)
+  , m_Min(min)
+  , m_Max(max)
+  , m_Mutex(mutex)
+  {
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    std::vector<double> min(m_NumComps, std::numeric_limits<double>::max());
+    std::vector<double> max(m_NumComps, std::numeric_limits<double>::lowest());
+    for(size_t i = range.min(); i < range.max(); i++)
+    {
+      for(size_t c = 0; c < m_NumComps; c++)
+      {
+        const double value = static_cast<double>(m_Data[m_NumComps * i + c]);
+        min[c] = value < min[c] ? value : min[c];
+        max[c] = value > max[c] ? value : max[c];
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(*m_Mutex);
+    for(size_t c = 0; c < m_NumComps; c++)
+    {
+      (*m_Min)[c] = std::min((*m_Min)[c], min[c]);
+      (*m_Max)[c] = std::max((*m_Max)[c], max[c]);
+    }
+  }
+
+  /**
+   * @brief Compute Returns the per component range of numTuples tuples
+   */
+  static void Compute(const DataType* data, size_t numTuples, size_t numComps, std::vector<double>& min, std::vector<double>& max)
+  {
+    std::mutex mutex;
+    min.assign(numComps, std::numeric_limits<double>::max());
+    max.assign(numComps, std::numeric_limits<double>::lowest());
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(0, numTuples);
+    dataAlg.execute(ComponentRangeImpl(data, numComps, &min, &max, &mutex));
+  }
+
+private:
+  const DataType* m_Data;
+  size_t m_NumComps;
+  std::vector<double>* m_Min;
+  std::vector<double>* m_Max;
+  std::mutex* m_Mutex;
+};
+
+/**
+ * @brief The KMeansTree class runs the assignment step of Lloyd's k-means with the filtering algorithm of Kanungo et al.
+ * The points are sorted into a kd-tree (median splits along the widest extent) whose nodes keep their bounding box and
+ * weighted coordinate sum. The assignment walks the tree with a list of candidate centroids and drops every candidate
+ * that is farther than the best one from all of a node's box, so a subtree left with one candidate is credited to it
+ * from its stored sum without visiting its points. Only the leaves reached by several candidates measure point
+ * distances, sweeping the surviving centroids stored component by component (structure of arrays); NumComps fixes the
+ * number of components at compile time so the component loop is fully unrolled, 0 selects the generic path.
+ *
+ * The upper levels of the tree cut the points into blocks whose subtrees are built and walked in parallel. Every
+ * block keeps its own partial sums, which are added up in block order afterwards, and the blocks only depend on the
+ * number of points, so the centroids (and so the labels) don't depend on the number of threads or their timing.
+ */
+template <typename PointType, size_t NumComps>
+class KMeansTree
+{
+public:
+  KMeansTree(const PointType* points, const double* weights, size_t numPoints, size_t numComps)
+  : m_Points(points)
+  , m_Weights(weights)
+  , m_NumComps((NumComps > 0) ? NumComps : numComps)
+  , m_Order(numPoints)
+  {
+    for(size_t i = 0; i < numPoints; i++)
+    {
+      m_Order[i] = i;
+    }
+
+    size_t depth = 0;
+    while((size_t(1) << depth) < k_MaxBlocks && (numPoints >> depth) > 2 * k_MinBlockPoints)
+    {
+      depth++;
+    }
+    splitBlocks(0, numPoints, depth);
+
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(0, m_Blocks.size());
+    dataAlg.execute(BuildImpl(this));
+  }
+
+  size_t getNumberOfBlocks() const
+  {
+    return m_Blocks.size();
+  }
+
+  /**
+   * @brief Assign credits every point to its closest centroid
+   * @param centroids Centroids stored component by component
+   * @param numClasses Number of centroids
+   * @param blockSums Receives the weighted coordinate sums of each class per block (numClasses * numComps each)
+   * @param blockWeights Receives the weight of each class per block (numClasses each)
+   * @param labels Receives the zero based class of each point, nullptr skips writing labels
+   */
+  void assign(const double* centroids, int32_t numClasses, std::vector<std::vector<double>>& blockSums, std::vector<std::vector<double>>& blockWeights, int32_t* labels) const
+  {
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(0, m_Blocks.size());
+    dataAlg.execute(FilterImpl(this, centroids, numClasses, &blockSums, &blockWeights, labels));
+  }
+
+private:
+  //points of the leaves, blocks and the largest number of blocks
+  static const size_t k_LeafSize = 32;
+  static const size_t k_MinBlockPoints = 4096;
+  static const size_t k_MaxBlocks = 256;
+
+  /**
+   * @brief The Block struct is one subtree stored node by node, node 0 is its root. Every node has two children (0 for
+   * a leaf), the range of the ordered points it holds, the minimum and then the maximum of every component, the weighted
+   * coordinate sums and the weight of its points.
+   */
+  struct Block
+  {
+    size_t begin = 0;
+    size_t end = 0;
+    size_t depth = 0;
+    std::vector<size_t> children;
+    std::vector<size_t> range;
+    std::vector<double> bounds;
+    std::vector<double> sums;
+    std::vector<double> weights;
+  };
+
+  /**
+   * @brief The BuildImpl class builds the subtrees of a range of blocks
+   */
+  class BuildImpl
+  {
+  public:
+    BuildImpl(KMeansTree* tree)
+    : m_Tree(tree)
+    {
+    }
+
+    void operator()(const SIMPLRange& range) const
+    {
+      for(size_t b = range.min(); b < range.max(); b++)
+      {
+        m_Tree->buildBlock(m_Tree->m_Blocks[b]);
+      }
+    }
+
+  private:
+    KMeansTree* m_Tree;
+  };
+
+  /**
+   * @brief The FilterImpl class walks the subtrees of a range of blocks with all centroids as candidates, every block
+   * summing into its own slots
+   */
+  class FilterImpl
+  {
+  public:
+    FilterImpl(const KMeansTree* tree, const double* centroids, int32_t numClasses, std::vector<std::vector<double>>* blockSums, std::vector<std::vector<double>>* blockWeights, int32_t* labels)
+    : m_Tree(tree)
+    , m_Centroids(centroids)
+    , m_NumClasses(static_cast<size_t>(numClasses))
+    , m_BlockSums(blockSums)
+    , m_BlockWeights(blockWeights)
+    , m_Labels(labels)
+    {
+    }
+
+    void operator()(const SIMPLRange& range) const
+    {
+      const size_t numComps = m_Tree->m_NumComps;
+      //surviving centroids of a leaf and their distances to a point
+      std::vector<double> local(m_NumClasses * (numComps + 1));
+      for(size_t b = range.min(); b < range.max(); b++)
+      {
+        const Block& block = m_Tree->m_Blocks[b];
+        std::vector<double>& sums = (*m_BlockSums)[b];
+        std::vector<double>& weights = (*m_BlockWeights)[b];
+        sums.assign(m_NumClasses * numComps, 0.0);
+        weights.assign(m_NumClasses, 0.0);
+        if(block.range.empty())
+        {
+          continue;
+        }
+
+        //a node's candidates follow its parent's in one buffer
+        std::vector<int32_t> candidates(m_NumClasses * (block.depth + 1));
+        for(size_t k = 0; k < m_NumClasses; k++)
+        {
+          candidates[k] = static_cast<int32_t>(k);
+        }
+        filter(block, 0, candidates.data(), m_NumClasses, local.data(), sums.data(), weights.data());
+      }
+    }
+
+  private:
+    void filter(const Block& block, size_t node, int32_t* candidates, size_t numCandidates, double* local, double* sums, double* weights) const
+    {
+      const size_t numComps = (NumComps > 0) ? NumComps : m_Tree->m_NumComps;
+      const double* lo = block.bounds.data() + 2 * numComps * node;
+      const double* hi = lo + numComps;
+
+      //the candidate closest to the center of the box, then every candidate that may be closer to some point of it
+      int32_t* survivors = candidates + numCandidates;
+      size_t numSurvivors = 0;
+      if(numCandidates > 1)
+      {
+        size_t closest = 0;
+        double closestDist = std::numeric_limits<double>::max();
+        for(size_t j = 0; j < numCandidates; j++)
+        {
+          double dist = 0.0;
+          for(size_t c = 0; c < numComps; c++)
+          {
+            const double delta = 0.5 * (lo[c] + hi[c]) - m_Centroids[c * m_NumClasses + candidates[j]];
+            dist += delta * delta;
+          }
+          if(dist < closestDist)
+          {
+            closest = j;
+            closestDist = dist;
+          }
+        }
+
+        const int32_t best = candidates[closest];
+        for(size_t j = 0; j < numCandidates; j++)
+        {
+          const int32_t k = candidates[j];
+          if(k == best)
+          {
+            survivors[numSurvivors++] = k;
+            continue;
+          }
+          //the corner of the box furthest toward k is where k gains the most on the best candidate
+          double distK = 0.0;
+          double distBest = 0.0;
+          for(size_t c = 0; c < numComps; c++)
+          {
+            const double centroidK = m_Centroids[c * m_NumClasses + k];
+            const double centroidBest = m_Centroids[c * m_NumClasses + best];
+            const double corner = centroidK > centroidBest ? hi[c] : lo[c];
+            distK += (corner - centroidK) * (corner - centroidK);
+            distBest += (corner - centroidBest) * (corner - centroidBest);
+          }
+          if(distK < distBest || (distK == distBest && k < best))
+          {
+            survivors[numSurvivors++] = k;
+          }
+        }
+      }
+      else
+      {
+        survivors[numSurvivors++] = candidates[0];
+      }
+
+      const size_t begin = block.range[2 * node];
+      const size_t end = block.range[2 * node + 1];
+      if(1 == numSurvivors)
+      {
+        const size_t k = static_cast<size_t>(survivors[0]);
+        for(size_t c = 0; c < numComps; c++)
+        {
+          sums[c * m_NumClasses + k] += block.sums[numComps * node + c];
+        }
+        weights[k] += block.weights[node];
+        if(nullptr != m_Labels)
+        {
+          for(size_t i = begin; i < end; i++)
+          {
+            m_Labels[m_Tree->m_Order[i]] = static_cast<int32_t>(k);
+          }
+        }
+        return;
+      }
+
+      if(0 != block.children[2 * node])
+      {
+        filter(block, block.children[2 * node], survivors, numSurvivors, local, sums, weights);
+        filter(block, block.children[2 * node + 1], survivors, numSurvivors, local, sums, weights);
+        return;
+      }
+
+      //leaf: distances from every point to the surviving centroids, which are gathered component by component
+      for(size_t c = 0; c < numComps; c++)
+      {
+        for(size_t j = 0; j < numSurvivors; j++)
+        {
+          local[c * numSurvivors + j] = m_Centroids[c * m_NumClasses + survivors[j]];
+        }
+      }
+      double* dist = local + numComps * numSurvivors;
+      for(size_t i = begin; i < end; i++)
+      {
+        const size_t index = m_Tree->m_Order[i];
+        const PointType* point = m_Tree->m_Points + index * numComps;
+        std::fill(dist, dist + numSurvivors, 0.0);
+        for(size_t c = 0; c < numComps; c++)
+        {
+          const double value = static_cast<double>(point[c]);
+          const double* centroid = local + c * numSurvivors;
+          for(size_t j = 0; j < numSurvivors; j++)
+          {
+            const double delta = value - centroid[j];
+            dist[j] += delta * delta;
+          }
+        }
+
+        size_t best = 0;
+        for(size_t j = 1; j < numSurvivors; j++)
+        {
+          best = dist[j] < dist[best] ? j : best;
+        }
+
+        const size_t k = static_cast<size_t>(survivors[best]);
+        const double weight = (nullptr != m_Tree->m_Weights) ? m_Tree->m_Weights[index] : 1.0;
+        for(size_t c = 0; c < numComps; c++)
+        {
+          sums[c * m_NumClasses + k] += weight * static_cast<double>(point[c]);
+        }
+        weights[k] += weight;
+        if(nullptr != m_Labels)
+        {
+          m_Labels[index] = static_cast<int32_t>(k);
+        }
+      }
+    }
+
+    const KMeansTree* m_Tree;
+    const double* m_Centroids;
+    size_t m_NumClasses;
+    std::vector<std::vector<double>>* m_BlockSums;
+    std::vector<std::vector<double>>* m_BlockWeights;
+    int32_t* m_Labels;
+  };
+
+  //orders NaN after every number so sorting stays a strict weak ordering
+  static bool Less(double lhs, double rhs)
+  {
+    return lhs < rhs || (lhs == lhs && rhs != rhs);
+  }
+
+  /**
+   * @brief WidestComponent returns the component with the largest extent over a range of the ordered points (or -1 if
+   * every point in it is the same)
+   */
+  int64_t widestComponent(size_t begin, size_t end, std::vector<double>& lo, std::vector<double>& hi) const
+  {
+    lo.assign(m_NumComps, std::numeric_limits<double>::max());
+    hi.assign(m_NumComps, std::numeric_limits<double>::lowest());
+    for(size_t i = begin; i < end; i++)
+    {
+      const PointType* point = m_Points + m_Order[i] * m_NumComps;
+      for(size_t c = 0; c < m_NumComps; c++)
+      {
+        const double value = static_cast<double>(point[c]);
+        lo[c] = value < lo[c] ? value : lo[c];
+        hi[c] = value > hi[c] ? value : hi[c];
+      }
+    }
+    int64_t widest = -1;
+    double extent = 0.0;
+    for(size_t c = 0; c < m_NumComps; c++)
+    {
+      if(hi[c] - lo[c] > extent)
+      {
+        widest = static_cast<int64_t>(c);
+        extent = hi[c] - lo[c];
+      }
+    }
+    return widest;
+  }
+
+  /**
+   * @brief Split sorts a range of the ordered points around its median along a component, returning the median
+   */
+  size_t split(size_t begin, size_t end, size_t component)
+  {
+    const size_t mid = begin + (end - begin) / 2;
+    const PointType* points = m_Points;
+    const size_t numComps = m_NumComps;
+    std::nth_element(m_Order.begin() + begin, m_Order.begin() + mid, m_Order.begin() + end, [points, numComps, component](size_t lhs, size_t rhs) {
+      return Less(static_cast<double>(points[lhs * numComps + component]), static_cast<double>(points[rhs * numComps + component]));
+    });
+    return mid;
+  }
+
+  void splitBlocks(size_t begin, size_t end, size_t depth)
+  {
+    std::vector<double> lo;
+    std::vector<double> hi;
+    const int64_t widest = depth > 0 ? widestComponent(begin, end, lo, hi) : -1;
+    if(widest < 0)
+    {
+      Block block;
+      block.begin = begin;
+      block.end = end;
+      m_Blocks.push_back(block);
+      return;
+    }
+    const size_t mid = split(begin, end, static_cast<size_t>(widest));
+    splitBlocks(begin, mid, depth - 1);
+    splitBlocks(mid, end, depth - 1);
+  }
+
+  void buildBlock(Block& block)
+  {
+    if(block.end > block.begin)
+    {
+      buildNode(block, block.begin, block.end, 0);
+    }
+  }
+
+  size_t buildNode(Block& block, size_t begin, size_t end, size_t depth)
+  {
+    const size_t node = block.range.size() / 2;
+    block.depth = std::max(block.depth, depth + 1);
+    block.children.push_back(0);
+    block.children.push_back(0);
+    block.range.push_back(begin);
+    block.range.push_back(end);
+
+    std::vector<double> lo;
+    std::vector<double> hi;
+    const int64_t widest = widestComponent(begin, end, lo, hi);
+    block.bounds.insert(block.bounds.end(), lo.begin(), lo.end());
+    block.bounds.insert(block.bounds.end(), hi.begin(), hi.end());
+    double weight = 0.0;
+    std::vector<double> sums(m_NumComps, 0.0);
+    for(size_t i = begin; i < end; i++)
+    {
+      const PointType* point = m_Points + m_Order[i] * m_NumComps;
+      const double w = (nullptr != m_Weights) ? m_Weights[m_Order[i]] : 1.0;
+      for(size_t c = 0; c < m_NumComps; c++)
+      {
+        sums[c] += w * static_cast<double>(point[c]);
+      }
+      weight += w;
+    }
+    block.sums.insert(block.sums.end(), sums.begin(), sums.end());
+    block.weights.push_back(weight);
+
+    if(end - begin > k_LeafSize && widest >= 0)
+    {
+      const size_t mid = split(begin, end, static_cast<size_t>(widest));
+      const size_t left = buildNode(block, begin, mid, depth + 1);
+      const size_t right = buildNode(block, mid, end, depth + 1);
+      block.children[2 * node] = left;
+      block.children[2 * node + 1] = right;
+    }
+    return node;
+  }
+
+  const PointType* m_Points;
+  const double* m_Weights;
+  size_t m_NumComps;
+  std::vector<size_t> m_Order;
+  std::vector<Block> m_Blocks;
+};
+
+/**
+ * @brief The WeightedKMeans class runs Lloyd's k-means over a set of (optionally weighted) points, for instance the
+ * voxels of a multi-component array or the unique colors of an image with their voxel counts. Initial means are
+ * evenly spaced along the diagonal of the bounding box of the points. Every assignment step walks a kd-tree of the
+ * points and the iterations stop once the means no longer move.
+ */
+template <typename PointType, size_t NumComps>
+class WeightedKMeans
+{
+public:
+  /**
+   * @brief Cluster Partitions the points into numClasses clusters
+   * @param filter Filter to check for cancellation
+   * @param points Interleaved point coordinates (numComps values per point)
+   * @param weights Weight of each point (nullptr weights every point equally)
+   * @param numPoints Number of points
+   * @param numComps Number of components per point
+   * @param numClasses Number of clusters
+   * @param min Per component minimum of the points
+   * @param max Per component maximum of the points
+   * @param labels Receives the zero based cluster index of each point
+   */
+  static void Cluster(ItkKdTreeKMeans* filter, const PointType* points, const double* weights, size_t numPoints, size_t numComps, int32_t numClasses, const std::vector<double>& min,
+                      const std::vector<double>& max, int32_t* labels)
+  {
+    std::fill(labels, labels + numPoints, -1);
+
+    // centroids are stored component by component
+    std::vector<double> centroids(numClasses * numComps, 0.0);
+    for(int32_t k = 0; k < numClasses; k++)
+    {
+      for(size_t c = 0; c < numComps; c++)
+      {
+        centroids[c * numClasses + k] = min[c] + (max[c] - min[c]) * (k + 0.5) / numClasses;
+      }
+    }
+
+    KMeansTree<PointType, NumComps> tree(points, weights, numPoints, numComps);
+    std::vector<std::vector<double>> blockSums(tree.getNumberOfBlocks());
+    std::vector<std::vector<double>> blockWeights(tree.getNumberOfBlocks());
+    std::vector<double> sums(numClasses * numComps, 0.0);
+    std::vector<double> clusterWeights(numClasses, 0.0);
+    std::vector<double> previous(centroids.size());
+    for(int32_t iteration = 0; iteration < 1000; iteration++)
+    {
+      if(filter->getCancel())
+      {
+        return;
+      }
+
+      tree.assign(centroids.data(), numClasses, blockSums, blockWeights, nullptr);
+
+      // the blocks are added up in order so the means don't depend on how they were scheduled
+      std::fill(sums.begin(), sums.end(), 0.0);
+      std::fill(clusterWeights.begin(), clusterWeights.end(), 0.0);
+      for(size_t b = 0; b < blockSums.size(); b++)
+      {
+        for(size_t j = 0; j < sums.size(); j++)
+        {
+          sums[j] += blockSums[b][j];
+        }
+        for(int32_t k = 0; k < numClasses; k++)
+        {
+          clusterWeights[k] += blockWeights[b][k];
+        }
+      }
+
+      // empty clusters keep their previous mean
+      previous = centroids;
+      for(int32_t k = 0; k < numClasses; k++)
+      {
+        if(clusterWeights[k] > 0.0)
+        {
+          for(size_t c = 0; c < numComps; c++)
+          {
+            centroids[c * numClasses + k] = sums[c * numClasses + k] / clusterWeights[k];
+          }
+        }
+      }
+
+      // the means didn't move so no point can switch clusters any more
+      if(0 == std::memcmp(previous.data(), centroids.data(), centroids.size() * sizeof(double)))
+      {
+        break;
+      }
+    }
+
+    tree.assign(centroids.data(), numClasses, blockSums, blockWeights, labels);
+  }
+};
+
+/**
+ * @brief ClusterPoints Runs the k-means kernel specialized for the number of components (1, 2, 3, 4 and 8) or the
+ * generic kernel for any other count
+ */
+template <typename PointType>
+void ClusterPoints(ItkKdTreeKMeans* filter, const PointType* points, const double* weights, size_t numPoints, size_t numComps, int32_t numClasses, const std::vector<double>& min,
+                   const std::vector<double>& max, int32_t* labels)
+{
+  switch(numComps)
+  {
+  case 1:
+    WeightedKMeans<PointType, 1>::Cluster(filter, points, weights, numPoints, numComps, numClasses, min, max, labels);
+    break;
+  case 2:
+    WeightedKMeans<PointType, 2>::Cluster(filter, points, weights, numPoints, numComps, numClasses, min, max, labels);
+    break;
+  case 3:
+    WeightedKMeans<PointType, 3>::Cluster(filter, points, weights, numPoints, numComps, numClasses, min, max, labels);
+    break;
+  case 4:
+    WeightedKMeans<PointType, 4>::Cluster(filter, points, weights, numPoints, numComps, numClasses, min, max, labels);
+    break;
+  case 8:
+    WeightedKMeans<PointType, 8>::Cluster(filter, points, weights, numPoints, numComps, numClasses, min, max, labels);
+    break;
+  default:
+    WeightedKMeans<PointType, 0>::Cluster(filter, points, weights, numPoints, numComps, numClasses, min, max, labels);
+    break;
+  }
+}
+
+/**
+ * @brief The KMeansTemplate class clusters every tuple of an array with any number of components
+ */
+template <typename DataType>
+class KMeansTemplate
 {
 public:
   typedef DataArray<DataType> DataArrayType;
 
-  itkKdTreeKMeansTemplate() = default;
-  virtual ~itkKdTreeKMeansTemplate() = default;
+  KMeansTemplate() = default;
+  virtual ~KMeansTemplate() = default;
 
   // -----------------------------------------------------------------------------
   //
@@ -85,92 +687,321 @@ public:
   // -----------------------------------------------------------------------------
   //
   // -----------------------------------------------------------------------------
-  void Execute(IDataArray::Pointer inputIDataArray, Int32ArrayType::Pointer classLabelsArray, int32_t numClasses)
+  void Execute(ItkKdTreeKMeans* filter, IDataArray::Pointer inputIDataArray, Int32ArrayType::Pointer classLabelsArray, int32_t numClasses)
   {
     typename DataArrayType::Pointer inputDataPtr = std::dynamic_pointer_cast<DataArrayType>(inputIDataArray);
 
     DataType* inputData = inputDataPtr->getPointer(0);
     int32_t* classLabels = classLabelsArray->getPointer(0);
     size_t numTuples = inputDataPtr->getNumberOfTuples();
+    size_t numComps = inputDataPtr->getNumberOfComponents();
+    if(0 == numTuples)
+    {
+      return;
+    }
 
-    typedef itk::Vector<DataType, 3> MeasurementVectorType;
-    typedef itk::Statistics::ListSample<MeasurementVectorType> SampleType;
-    typename SampleType::Pointer sample = SampleType::New();
-    sample->SetMeasurementVectorSize(3);
+    std::vector<double> min;
+    std::vector<double> max;
+    ComponentRangeImpl<DataType>::Compute(inputData, numTuples, numComps, min, max);
 
-    MeasurementVectorType mv;
+    filter->notifyStatusMessage("Clustering");
+    ClusterPoints<DataType>(filter, inputData, nullptr, numTuples, numComps, numClasses, min, max, classLabels);
 
+    // class labels start at 1
     for(size_t i = 0; i < numTuples; i++)
     {
-      mv[0] = inputData[3 * i + 0];
-      mv[1] = inputData[3 * i + 1];
-      mv[2] = inputData[3 * i + 2];
-      sample->PushBack(mv);
+      classLabels[i]++;
     }
+  }
+};
 
-    typedef itk::Statistics::KdTreeGenerator<SampleType> TreeGeneratorType;
-    typename TreeGeneratorType::Pointer treeGenerator = TreeGeneratorType::New();
+/**
+ * @brief The ColorHistogramKMeansTemplate class collapses a 3 component array into its unique (or quantized) colors
+ * with voxel counts, runs a weighted k-means over that compact set and maps the class labels back onto the voxels
+ * in a single gather pass. Run time and memory scale with the number of distinct colors instead of the number of voxels.
+ */
+template <typename DataType>
+class ColorHistogramKMeansTemplate
+{
+public:
+  typedef DataArray<DataType> DataArrayType;
 
-    treeGenerator->SetSample(sample);
-    treeGenerator->SetBucketSize(numTuples);
-    treeGenerator->Update();
+  /**
+   * @brief The ColorBin struct accumulates the voxels that fall into a histogram bin
+   */
+  struct ColorBin
+  {
+    uint64_t count = 0;
+    double sum[3] = {0.0, 0.0, 0.0};
+    int32_t label = 0;
+  };
+  using ColorHistogram = std::unordered_map<uint64_t, ColorBin>;
+
+  /**
+   * @brief The ColorKey class packs a color into a 64 bit histogram key. Narrow integer types are packed exactly,
+   * everything else is quantized into 2^bits levels between the per channel minimum and maximum.
+   */
+  class ColorKey
+  {
+  public:
+    ColorKey(uint32_t bits, bool exact, const std::vector<double>& min, const std::vector<double>& max)
+    : m_Bits(bits)
+    , m_MaxLevel((uint64_t(1) << bits) - 1)
+    {
+      for(size_t c = 0; c < 3; c++)
+      {
+        m_Offset[c] = exact ? static_cast<double>(std::numeric_limits<DataType>::lowest()) : min[c];
+        m_Scale[c] = 1.0;
+        if(!exact)
+        {
+          m_Scale[c] = max[c] > min[c] ? static_cast<double>(m_MaxLevel) / (max[c] - min[c]) : 0.0;
+        }
+      }
+    }
+
+    inline uint64_t operator()(const DataType* color) const
+    {
+      uint64_t key = 0;
+      for(size_t c = 0; c < 3; c++)
+      {
+        const double level = (static_cast<double>(color[c]) - m_Offset[c]) * m_Scale[c];
+        uint64_t bin = level > 0.0 ? static_cast<uint64_t>(level) : 0;
+        if(bin > m_MaxLevel)
+        {
+          bin = m_MaxLevel;
+        }
+        key = (key << m_Bits) | bin;
+      }
+      return key;
+    }
+
+  private:
+    uint32_t m_Bits;
+    uint64_t m_MaxLevel;
+    double m_Offset[3];
+    double m_Scale[3];
+  };
+
+  /**
+   * @brief The HistogramImpl class bins a range of chunks of voxels, every chunk into its own maps, one per partition of
+   * the histogram, so chunks never share a map
+   */
+  class HistogramImpl
+  {
+  public:
+    HistogramImpl(const DataType* data, size_t numTuples, const ColorKey& key, std::vector<std::vector<ColorHistogram>>* chunks)
+    : m_Data(data)
+    , m_NumTuples(numTuples)
+    , m_Key(key)
+    , m_Chunks(chunks)
+    {
+    }
+
+    void operator()(const SIMPLRange& range) const
+    {
+      const size_t numChunks = m_Chunks->size();
+      for(size_t chunk = range.min(); chunk < range.max(); chunk++)
+      {
+        std::vector<ColorHistogram>& maps = (*m_Chunks)[chunk];
+        maps.assign(numChunks, ColorHistogram());
+        for(size_t i = m_NumTuples * chunk / numChunks; i < m_NumTuples * (chunk + 1) / numChunks; i++)
+        {
+          const DataType* color = m_Data + 3 * i;
+          const uint64_t key = m_Key(color);
+          ColorBin& bin = maps[ImageProcessing::HashPartition(key, numChunks)][key];
+          bin.count++;
+          bin.sum[0] += static_cast<double>(color[0]);
+          bin.sum[1] += static_cast<double>(color[1]);
+          bin.sum[2] += static_cast<double>(color[2]);
+        }
+      }
+    }
+
+  private:
+    const DataType* m_Data;
+    size_t m_NumTuples;
+    ColorKey m_Key;
+    std::vector<std::vector<ColorHistogram>>* m_Chunks;
+  };
+
+  /**
+   * @brief The MergeImpl class sums the bins of every chunk for a range of histogram partitions, since a partition is
+   * only ever touched by one task no locking is needed
+   */
+  class MergeImpl
+  {
+  public:
+    MergeImpl(std::vector<std::vector<ColorHistogram>>* chunks, std::vector<ColorHistogram>* histogram)
+    : m_Chunks(chunks)
+    , m_Histogram(histogram)
+    {
+    }
 
-    typedef typename TreeGeneratorType::KdTreeType TreeType;
-    typedef itk::Statistics::KdTreeBasedKmeansEstimator<TreeType> EstimatorType;
-    typename EstimatorType::Pointer estimator = EstimatorType::New();
+    void operator()(const SIMPLRange& range) const
+    {
+      for(size_t p = range.min(); p < range.max(); p++)
+      {
+        ColorHistogram& partition = (*m_Histogram)[p];
+        for(size_t chunk = 0; chunk < m_Chunks->size(); chunk++)
+        {
+          ColorHistogram& local = (*m_Chunks)[chunk][p];
+          if(partition.empty())
+          {
+            partition.swap(local);
+            continue;
+          }
+          for(const auto& entry : local)
+          {
+            ColorBin& bin = partition[entry.first];
+            bin.count += entry.second.count;
+            bin.sum[0] += entry.second.sum[0];
+            bin.sum[1] += entry.second.sum[1];
+            bin.sum[2] += entry.second.sum[2];
+          }
+          ColorHistogram().swap(local);
+        }
+      }
+    }
+
+  private:
+    std::vector<std::vector<ColorHistogram>>* m_Chunks;
+    std::vector<ColorHistogram>* m_Histogram;
+  };
 
-    typename EstimatorType::ParametersType initialMeans(numClasses * 3);
-    initialMeans.Fill(0.0);
+  /**
+   * @brief The GatherImpl class copies the class label of each voxel's histogram bin into the output array
+   */
+  class GatherImpl
+  {
+  public:
+    GatherImpl(const DataType* data, const ColorKey& key, const std::vector<ColorHistogram>* histogram, int32_t* classLabels)
+    : m_Data(data)
+    , m_Key(key)
+    , m_Histogram(histogram)
+    , m_ClassLabels(classLabels)
+    {
+    }
 
-    estimator->SetParameters(initialMeans);
-    estimator->SetKdTree(treeGenerator->GetOutput());
-    estimator->SetMaximumIteration(1000);
-    estimator->SetCentroidPositionChangesThreshold(0.0);
-    estimator->StartOptimization();
+    void operator()(const SIMPLRange& range) const
+    {
+      for(size_t i = range.min(); i < range.max(); i++)
+      {
+        const uint64_t key = m_Key(m_Data + 3 * i);
+        m_ClassLabels[i] = (*m_Histogram)[ImageProcessing::HashPartition(key, m_Histogram->size())].find(key)->second.label;
+      }
+    }
 
-    typedef itk::Statistics::SampleClassifierFilter<SampleType> ClassifierType;
-    typename ClassifierType::Pointer classifier = ClassifierType::New();
+  private:
+    const DataType* m_Data;
+    ColorKey m_Key;
+    const std::vector<ColorHistogram>* m_Histogram;
+    int32_t* m_ClassLabels;
+  };
 
-    typedef itk::Statistics::MinimumDecisionRule DecisionRuleType;
-    DecisionRuleType::Pointer decisionRule = DecisionRuleType::New();
+  ColorHistogramKMeansTemplate() = default;
+  virtual ~ColorHistogramKMeansTemplate() = default;
 
-    classifier->SetDecisionRule(decisionRule);
-    classifier->SetNumberOfClasses(numClasses);
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  bool operator()(IDataArray::Pointer p)
+  {
+    return (std::dynamic_pointer_cast<DataArrayType>(p).get() != nullptr);
+  }
 
-    typedef typename ClassifierType::ClassLabelVectorObjectType ClassLabelVectorObjectType;
-    typedef typename ClassifierType::ClassLabelVectorType ClassLabelVectorType;
-    //      typedef typename ClassifierType::MembershipFunctionVectorObjectType MembershipFunctionVectorObjectType;
-    //      typedef typename ClassifierType::MembershipFunctionVectorType MembershipFunctionVectorType;
-    // typedef itk::Statistics::DistanceToCentroidMembershipFunction<MeasurementVectorType> MembershipFunctionType;
-    // typedef typename MembershipFunctionType::Pointer MembershipFunctionPointer;
-    //      typedef std::vector<MembershipFunctionPointer> MembershipFunctionVectorPointer;
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void Execute(ItkKdTreeKMeans* filter, IDataArray::Pointer inputIDataArray, Int32ArrayType::Pointer classLabelsArray, int32_t numClasses, int32_t quantizationBits)
+  {
+    typename DataArrayType::Pointer inputDataPtr = std::dynamic_pointer_cast<DataArrayType>(inputIDataArray);
 
-    const typename EstimatorType::MembershipFunctionVectorObjectType* kMeansMembershipFunctions = estimator->GetOutput();
-    classifier->SetMembershipFunctions(kMeansMembershipFunctions);
+    DataType* inputData = inputDataPtr->getPointer(0);
+    int32_t* classLabels = classLabelsArray->getPointer(0);
+    size_t numTuples = inputDataPtr->getNumberOfTuples();
+    if(0 == numTuples)
+    {
+      return;
+    }
 
-    typename ClassLabelVectorObjectType::Pointer classLabelsObject = ClassLabelVectorObjectType::New();
-    ClassLabelVectorType& classLabelsVector = classLabelsObject->Get();
+    // find the range of each channel
+    std::vector<double> min;
+    std::vector<double> max;
+    ComponentRangeImpl<DataType>::Compute(inputData, numTuples, 3, min, max);
 
-    for(size_t i = 0; i < numClasses; i++)
+    // 8 and 16 bit colors can be binned exactly, wider types are quantized to 8 bits per channel unless told otherwise,
+    // finer levels leave nearly every voxel of a float image in a bin of its own
+    const bool narrowType = std::numeric_limits<DataType>::is_integer && sizeof(DataType) <= 2;
+    const bool exact = (0 == quantizationBits && narrowType);
+    uint32_t bits = static_cast<uint32_t>(quantizationBits);
+    if(exact)
+    {
+      bits = 8 * sizeof(DataType);
+    }
+    else if(0 == bits)
     {
-      classLabelsVector.push_back(i + 1);
+      bits = 8;
     }
+    ColorKey key(bits, exact, min, max);
 
-    classifier->SetClassLabels(classLabelsObject);
-    classifier->SetInput(sample);
-    classifier->Update();
+    // collapse the voxels into a histogram of colors
+    filter->notifyStatusMessage("Building Color Histogram");
+    const size_t numChunks = std::min(std::max<size_t>(1, 2 * std::thread::hardware_concurrency()), numTuples);
+    std::vector<ColorHistogram> histogram(numChunks);
+    {
+      std::vector<std::vector<ColorHistogram>> chunks(numChunks);
+      ParallelDataAlgorithm dataAlg;
+      dataAlg.setRange(0, numChunks);
+      dataAlg.execute(HistogramImpl(inputData, numTuples, key, &chunks));
+      dataAlg.execute(MergeImpl(&chunks, &histogram));
+    }
+    size_t numBins = 0;
+    for(const ColorHistogram& partition : histogram)
+    {
+      numBins += partition.size();
+    }
 
-    const typename ClassifierType::MembershipSampleType* membershipSample = classifier->GetOutput();
-    typename ClassifierType::MembershipSampleType::ConstIterator membershipIterator = membershipSample->Begin();
+    // each bin is represented by the mean color of its voxels and weighted by its voxel count
+    std::vector<double> points;
+    std::vector<double> weights;
+    points.reserve(3 * numBins);
+    weights.reserve(numBins);
+    for(const ColorHistogram& partition : histogram)
+    {
+      for(const auto& entry : partition)
+      {
+        const double count = static_cast<double>(entry.second.count);
+        points.push_back(entry.second.sum[0] / count);
+        points.push_back(entry.second.sum[1] / count);
+        points.push_back(entry.second.sum[2] / count);
+        weights.push_back(count);
+      }
+    }
 
-    int32_t index = 0;
+    QString ss = QObject::tr("Clustering %1 Unique Colors").arg(numBins);
+    filter->notifyStatusMessage(ss);
+    std::vector<int32_t> labels(weights.size());
+    ClusterPoints<double>(filter, points.data(), weights.data(), weights.size(), 3, numClasses, min, max, labels.data());
+    if(filter->getCancel())
+    {
+      return;
+    }
 
-    while(membershipIterator != membershipSample->End())
+    // labels follow the histogram's iteration order
+    size_t index = 0;
+    for(ColorHistogram& partition : histogram)
     {
-      classLabels[index] = membershipIterator.GetClassLabel();
-      ++index;
-      ++membershipIterator;
+      for(auto& entry : partition)
+      {
+        entry.second.label = labels[index] + 1;
+        index++;
+      }
     }
+
+    filter->notifyStatusMessage("Labeling Voxels");
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(0, numTuples);
+    dataAlg.execute(GatherImpl(inputData, key, &histogram, classLabels));
   }
 };
 
@@ -191,6 +1022,10 @@ void ItkKdTreeKMeans::setupFilterParameters()
 {
   FilterParameterVectorType parameters;
   parameters.push_back(SIMPL_NEW_INTEGER_FP("Number of Classes", Classes, FilterParameter::Category::Parameter, ItkKdTreeKMeans));
+  std::vector<QString> linkedProps;
+  linkedProps.push_back("ColorQuantizationBits");
+  parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Compact to Color Histogram", CompactColors, FilterParameter::Category::Parameter, ItkKdTreeKMeans, linkedProps));
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Quantization Bits per Channel (0 = Automatic)", ColorQuantizationBits, FilterParameter::Category::Parameter, ItkKdTreeKMeans));
   DataArraySelectionFilterParameter::RequirementType req;
   parameters.push_back(SIMPL_NEW_DA_SELECTION_FP("Attribute Array to Classify", SelectedCellArrayPath, FilterParameter::Category::RequiredArray, ItkKdTreeKMeans, req));
   parameters.push_back(SIMPL_NEW_DA_WITH_LINKED_AM_FP("Class Labels", NewCellArrayName, SelectedCellArrayPath, SelectedCellArrayPath, FilterParameter::Category::CreatedArray, ItkKdTreeKMeans));
@@ -206,6 +1041,8 @@ void ItkKdTreeKMeans::readFilterParameters(AbstractFilterParametersReader* reade
   setSelectedCellArrayPath(reader->readDataArrayPath("SelectedCellArrayPath", getSelectedCellArrayPath()));
   setNewCellArrayName(reader->readString("NewCellArrayName", getNewCellArrayName()));
   setClasses(reader->readValue("Classes", getClasses()));
+  setCompactColors(reader->readValue("CompactColors", getCompactColors()));
+  setColorQuantizationBits(reader->readValue("ColorQuantizationBits", getColorQuantizationBits()));
   reader->closeFilterGroup();
 }
 
@@ -231,6 +1068,12 @@ void ItkKdTreeKMeans::dataCheck()
     setErrorCondition(-5555, "Must have at least 2 classes");
   }
 
+  if(getCompactColors() && (getColorQuantizationBits() < 0 || getColorQuantizationBits() > 21))
+  {
+    QString ss = QObject::tr("Quantization bits per channel must be between 0 and 21 (%1 requested)").arg(getColorQuantizationBits());
+    setErrorCondition(-5556, ss);
+  }
+
   m_SelectedCellArrayPtr = getDataContainerArray()->getPrereqIDataArrayFromPath(this, getSelectedCellArrayPath());
   if(getErrorCode() < 0)
   {
@@ -239,10 +1082,10 @@ void ItkKdTreeKMeans::dataCheck()
 
   int32_t numComps = m_SelectedCellArrayPtr.lock()->getNumberOfComponents();
 
-  if(numComps != 3)
+  if(getCompactColors() && numComps != 3)
   {
-    QString ss = QObject::tr("Input data has total components %1, but the data must be 3-vectors").arg(numComps);
-    setErrorCondition(-5555, ss);
+    QString ss = QObject::tr("Input data has total components %1, but only 3 component colors can be compacted to a color histogram. All tuples will be clustered directly").arg(numComps);
+    setWarningCondition(-5557, ss);
   }
 
   std::vector<size_t> cDims(1, 1);
@@ -266,7 +1109,14 @@ void ItkKdTreeKMeans::execute()
     return;
   }
 
-  EXECUTE_TEMPLATE(this, itkKdTreeKMeansTemplate, m_SelectedCellArrayPtr.lock(), m_SelectedCellArrayPtr.lock(), m_NewCellArrayPtr.lock(), m_Classes)
+  if(m_CompactColors && m_SelectedCellArrayPtr.lock()->getNumberOfComponents() == 3)
+  {
+    EXECUTE_TEMPLATE(this, ColorHistogramKMeansTemplate, m_SelectedCellArrayPtr.lock(), this, m_SelectedCellArrayPtr.lock(), m_NewCellArrayPtr.lock(), m_Classes, m_ColorQuantizationBits)
+  }
+  else
+  {
+    EXECUTE_TEMPLATE(this, KMeansTemplate, m_SelectedCellArrayPtr.lock(), this, m_SelectedCellArrayPtr.lock(), m_NewCellArrayPtr.lock(), m_Classes)
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -386,3 +1236,27 @@ int ItkKdTreeKMeans::getClasses() const
 {
   return m_Classes;
 }
+
+// -----------------------------------------------------------------------------
+void ItkKdTreeKMeans::setCompactColors(bool value)
+{
+  m_CompactColors = value;
+}
+
+// -----------------------------------------------------------------------------
+bool ItkKdTreeKMeans::getCompactColors() const
+{
+  return m_CompactColors;
+}
+
+// -----------------------------------------------------------------------------
+void ItkKdTreeKMeans::setColorQuantizationBits(int value)
+{
+  m_ColorQuantizationBits = value;
+}
+
+// -----------------------------------------------------------------------------
+int ItkKdTreeKMeans::getColorQuantizationBits() const
+{
+  return m_ColorQuantizationBits;
+}
@@ -69,6 +69,8 @@ class ImageProcessing_EXPORT ItkKdTreeKMeans : public AbstractFilter
   PYB11_PROPERTY(DataArrayPath SelectedCellArrayPath READ getSelectedCellArrayPath WRITE setSelectedCellArrayPath)
   PYB11_PROPERTY(QString NewCellArrayName READ getNewCellArrayName WRITE setNewCellArrayName)
   PYB11_PROPERTY(int Classes READ getClasses WRITE setClasses)
+  PYB11_PROPERTY(bool CompactColors READ getCompactColors WRITE setCompactColors)
+  PYB11_PROPERTY(int ColorQuantizationBits READ getColorQuantizationBits WRITE setColorQuantizationBits)
   PYB11_END_BINDINGS()
   // End Python bindings declarations
 
@@ -129,6 +131,30 @@ public:
 
   Q_PROPERTY(int Classes READ getClasses WRITE setClasses)
 
+  /**
+   * @brief Setter property for CompactColors
+   */
+  void setCompactColors(bool value);
+  /**
+   * @brief Getter property for CompactColors
+   * @return Value of CompactColors
+   */
+  bool getCompactColors() const;
+
+  Q_PROPERTY(bool CompactColors READ getCompactColors WRITE setCompactColors)
+
+  /**
+   * @brief Setter property for ColorQuantizationBits
+   */
+  void setColorQuantizationBits(int value);
+  /**
+   * @brief Getter property for ColorQuantizationBits
+   * @return Value of ColorQuantizationBits
+   */
+  int getColorQuantizationBits() const;
+
+  Q_PROPERTY(int ColorQuantizationBits READ getColorQuantizationBits WRITE setColorQuantizationBits)
+
   /**
    * @brief getCompiledLibraryName Returns the name of the Library that this filter is a part of
    * @return
@@ -208,6 +234,8 @@ private:
   DataArrayPath m_SelectedCellArrayPath = {"", "", ""};
   QString m_NewCellArrayName = {"ClassLabels"};
   int m_Classes = {2};
+  bool m_CompactColors = {true};
+  int m_ColorQuantizationBits = {0};
 
 public:
   ItkKdTreeKMeans(const ItkKdTreeKMeans&) = delete;            // Copy Constructor Not Implemented
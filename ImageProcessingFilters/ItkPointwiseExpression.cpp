@@ -0,0 +1,916 @@
+/* ============================================================================
+ * Copyright (c) 2014 William Lenthe
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of William Lenthe or any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  This code was partially written under United States Air Force Contract number
+ *                              FA8650-10-D-5210
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ItkPointwiseExpression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <QtCore/QLocale>
+#include <QtCore/QString>
+
+#include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
+#include "SIMPLib/FilterParameters/MultiDataArraySelectionFilterParameter.h"
+#include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
+#include "SIMPLib/FilterParameters/StringFilterParameter.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
+
+#include "ImageProcessing/ImageProcessingConstants.h"
+
+/* Create Enumerations to allow the created Attribute Arrays to take part in renaming */
+enum createdPathID : RenameDataPath::DataID_t
+{
+  DataArrayID31 = 31,
+};
+
+namespace
+{
+/**
+ * @brief The Expression class compiles an infix expression into a postfix program. The program is evaluated a block of
+ * voxels at a time: every instruction is a simple loop over the block, so the loops vectorize and the whole expression
+ * reads each input voxel once with all intermediate values staying in cache. Subexpressions of constants are folded
+ * while compiling.
+ */
+class Expression
+{
+public:
+  enum OpCode
+  {
+    Constant,
+    Variable,
+    Negate,
+    Not,
+    Abs,
+    Sqrt,
+    Log,
+    Exp,
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+    Equal,
+    NotEqual,
+    And,
+    Or,
+    Min,
+    Max,
+    Pow,
+    Clamp,
+    Select
+  };
+
+  struct Instruction
+  {
+    OpCode op;
+    float value;
+    size_t variable;
+  };
+
+  static const size_t k_BlockSize = 1024;
+
+  /**
+   * @brief compiles the expression, variables are the letters a, b, c... in the order of the inputs
+   * @param text expression
+   * @param numVariables number of inputs
+   * @param error description of the first problem (if any)
+   * @return true if the expression compiled
+   */
+  bool compile(const std::string& text, size_t numVariables, std::string& error)
+  {
+    m_Text = text;
+    m_Position = 0;
+    m_NumVariables = numVariables;
+    m_Error.clear();
+    m_Program.clear();
+    m_Depth = 0;
+    m_MaxDepth = 0;
+    parseOr();
+    skipSpace();
+    if(m_Error.empty() && m_Position < m_Text.size())
+    {
+      fail("unexpected '" + m_Text.substr(m_Position, 1) + "'");
+    }
+    error = m_Error;
+    return m_Error.empty();
+  }
+
+  /**
+   * @brief number of block buffers needed to evaluate the program
+   */
+  size_t depth() const
+  {
+    return m_MaxDepth;
+  }
+
+  /**
+   * @brief evaluates count (<= k_BlockSize) voxels starting at start
+   * @param inputs input arrays
+   * @param start first voxel
+   * @param count number of voxels
+   * @param stack depth() * k_BlockSize scratch values
+   * @return values of the expression (points into stack)
+   */
+  template <typename T>
+  const float* evaluate(const T* const* inputs, size_t start, size_t count, float* stack) const
+  {
+    size_t top = 0;
+    for(const Instruction& instruction : m_Program)
+    {
+      Execute(instruction, inputs, start, count, stack, top);
+    }
+    return stack;
+  }
+
+private:
+  template <typename T>
+  static void Execute(const Instruction& instruction, const T* const* inputs, size_t start, size_t count, float* stack, size_t& top)
+  {
+    float* x = stack + (top - (top > 0 ? 1 : 0)) * k_BlockSize;
+    switch(instruction.op)
+    {
+      case Constant:
+        std::fill(stack + top * k_BlockSize, stack + top * k_BlockSize + count, instruction.value);
+        top++;
+        return;
+      case Variable:
+      {
+        const T* input = inputs[instruction.variable] + start;
+        float* output = stack + top * k_BlockSize;
+        for(size_t j = 0; j < count; j++)
+        {
+          output[j] = static_cast<float>(input[j]);
+        }
+        top++;
+        return;
+      }
+      case Negate:
+        for(size_t j = 0; j < count; j++) { x[j] = -x[j]; }
+        return;
+      case Not:
+        for(size_t j = 0; j < count; j++) { x[j] = 0.0f == x[j] ? 1.0f : 0.0f; }
+        return;
+      case Abs:
+        for(size_t j = 0; j < count; j++) { x[j] = std::fabs(x[j]); }
+        return;
+      case Sqrt:
+        for(size_t j = 0; j < count; j++) { x[j] = std::sqrt(x[j]); }
+        return;
+      case Log:
+        for(size_t j = 0; j < count; j++) { x[j] = std::log(x[j]); }
+        return;
+      case Exp:
+        for(size_t j = 0; j < count; j++) { x[j] = std::exp(x[j]); }
+        return;
+      default:
+        break;
+    }
+
+    if(Clamp == instruction.op || Select == instruction.op)
+    {
+      top -= 2;
+      float* a = stack + (top - 1) * k_BlockSize;
+      const float* b = a + k_BlockSize;
+      const float* c = b + k_BlockSize;
+      if(Clamp == instruction.op)
+      {
+        for(size_t j = 0; j < count; j++) { a[j] = std::min(std::max(a[j], b[j]), c[j]); }
+      }
+      else
+      {
+        for(size_t j = 0; j < count; j++) { a[j] = 0.0f != a[j] ? b[j] : c[j]; }
+      }
+      return;
+    }
+
+    top--;
+    float* a = stack + (top - 1) * k_BlockSize;
+    const float* b = a + k_BlockSize;
+    switch(instruction.op)
+    {
+      case Add:
+        for(size_t j = 0; j < count; j++) { a[j] += b[j]; }
+        break;
+      case Subtract:
+        for(size_t j = 0; j < count; j++) { a[j] -= b[j]; }
+        break;
+      case Multiply:
+        for(size_t j = 0; j < count; j++) { a[j] *= b[j]; }
+        break;
+      case Divide:
+        for(size_t j = 0; j < count; j++) { a[j] /= b[j]; }
+        break;
+      case Less:
+        for(size_t j = 0; j < count; j++) { a[j] = a[j] < b[j] ? 1.0f : 0.0f; }
+        break;
+      case LessEqual:
+        for(size_t j = 0; j < count; j++) { a[j] = a[j] <= b[j] ? 1.0f : 0.0f; }
+        break;
+      case Greater:
+        for(size_t j = 0; j < count; j++) { a[j] = a[j] > b[j] ? 1.0f : 0.0f; }
+        break;
+      case GreaterEqual:
+        for(size_t j = 0; j < count; j++) { a[j] = a[j] >= b[j] ? 1.0f : 0.0f; }
+        break;
+      case Equal:
+        for(size_t j = 0; j < count; j++) { a[j] = a[j] == b[j] ? 1.0f : 0.0f; }
+        break;
+      case NotEqual:
+        for(size_t j = 0; j < count; j++) { a[j] = a[j] != b[j] ? 1.0f : 0.0f; }
+        break;
+      case And:
+        for(size_t j = 0; j < count; j++) { a[j] = (0.0f != a[j] && 0.0f != b[j]) ? 1.0f : 0.0f; }
+        break;
+      case Or:
+        for(size_t j = 0; j < count; j++) { a[j] = (0.0f != a[j] || 0.0f != b[j]) ? 1.0f : 0.0f; }
+        break;
+      case Min:
+        for(size_t j = 0; j < count; j++) { a[j] = std::min(a[j], b[j]); }
+        break;
+      case Max:
+        for(size_t j = 0; j < count; j++) { a[j] = std::max(a[j], b[j]); }
+        break;
+      case Pow:
+        for(size_t j = 0; j < count; j++) { a[j] = std::pow(a[j], b[j]); }
+        break;
+      default:
+        break;
+    }
+  }
+
+  static size_t Arity(OpCode op)
+  {
+    if(Constant == op || Variable == op)
+    {
+      return 0;
+    }
+    if(op <= Exp)
+    {
+      return 1;
+    }
+    return op < Clamp ? 2 : 3;
+  }
+
+  /**
+   * @brief appends an instruction, folding it into a constant if all of its operands are constants
+   */
+  void emit(OpCode op, float value = 0.0f, size_t variable = 0)
+  {
+    if(!m_Error.empty())
+    {
+      return;
+    }
+    const size_t arity = Arity(op);
+    m_Depth = m_Depth + 1 - arity;
+    m_MaxDepth = std::max(m_MaxDepth, m_Depth);
+    bool constant = arity > 0 && m_Program.size() >= arity;
+    for(size_t i = 0; i < arity && constant; i++)
+    {
+      constant = Constant == m_Program[m_Program.size() - 1 - i].op;
+    }
+    if(!constant)
+    {
+      m_Program.push_back({op, value, variable});
+      return;
+    }
+
+    //run the instruction on a one voxel block of the constants
+    std::vector<float> stack(3 * k_BlockSize);
+    for(size_t i = 0; i < arity; i++)
+    {
+      stack[i * k_BlockSize] = m_Program[m_Program.size() - arity + i].value;
+    }
+    size_t top = arity;
+    const uint8_t* const* noInputs = nullptr;
+    Execute({op, value, variable}, noInputs, 0, 1, stack.data(), top);
+    m_Program.resize(m_Program.size() - arity);
+    m_Program.push_back({Constant, stack[0], 0});
+  }
+
+  void fail(const std::string& message)
+  {
+    if(m_Error.empty())
+    {
+      m_Error = message + " at position " + std::to_string(m_Position + 1);
+    }
+  }
+
+  void skipSpace()
+  {
+    while(m_Position < m_Text.size() && std::isspace(static_cast<unsigned char>(m_Text[m_Position])))
+    {
+      m_Position++;
+    }
+  }
+
+  void skipDigits()
+  {
+    while(m_Position < m_Text.size() && std::isdigit(static_cast<unsigned char>(m_Text[m_Position])))
+    {
+      m_Position++;
+    }
+  }
+
+  bool accept(const char* token)
+  {
+    skipSpace();
+    const size_t length = std::char_traits<char>::length(token);
+    if(0 == m_Text.compare(m_Position, length, token))
+    {
+      m_Position += length;
+      return true;
+    }
+    return false;
+  }
+
+  void expect(const char* token)
+  {
+    if(m_Error.empty() && !accept(token))
+    {
+      fail(std::string("expected '") + token + "'");
+    }
+  }
+
+  void parseOr()
+  {
+    parseAnd();
+    while(m_Error.empty() && accept("||"))
+    {
+      parseAnd();
+      emit(Or);
+    }
+  }
+
+  void parseAnd()
+  {
+    parseComparison();
+    while(m_Error.empty() && accept("&&"))
+    {
+      parseComparison();
+      emit(And);
+    }
+  }
+
+  void parseComparison()
+  {
+    parseSum();
+    if(!m_Error.empty())
+    {
+      return;
+    }
+    //two character operators first so '<' doesn't swallow '<='
+    OpCode op = Constant;
+    if(accept("<="))
+    {
+      op = LessEqual;
+    }
+    else if(accept(">="))
+    {
+      op = GreaterEqual;
+    }
+    else if(accept("=="))
+    {
+      op = Equal;
+    }
+    else if(accept("!="))
+    {
+      op = NotEqual;
+    }
+    else if(accept("<"))
+    {
+      op = Less;
+    }
+    else if(accept(">"))
+    {
+      op = Greater;
+    }
+    if(Constant != op)
+    {
+      parseSum();
+      emit(op);
+    }
+  }
+
+  void parseSum()
+  {
+    parseProduct();
+    while(m_Error.empty())
+    {
+      if(accept("+"))
+      {
+        parseProduct();
+        emit(Add);
+      }
+      else if(accept("-"))
+      {
+        parseProduct();
+        emit(Subtract);
+      }
+      else
+      {
+        return;
+      }
+    }
+  }
+
+  void parseProduct()
+  {
+    parseUnary();
+    while(m_Error.empty())
+    {
+      if(accept("*"))
+      {
+        parseUnary();
+        emit(Multiply);
+      }
+      else if(accept("/"))
+      {
+        parseUnary();
+        emit(Divide);
+      }
+      else
+      {
+        return;
+      }
+    }
+  }
+
+  void parseUnary()
+  {
+    if(accept("-"))
+    {
+      parseUnary();
+      emit(Negate);
+    }
+    else if(accept("!") )
+    {
+      parseUnary();
+      emit(Not);
+    }
+    else
+    {
+      parsePrimary();
+    }
+  }
+
+  void parsePrimary()
+  {
+    skipSpace();
+    if(m_Position >= m_Text.size())
+    {
+      fail("unexpected end of expression");
+      return;
+    }
+
+    const char c = m_Text[m_Position];
+    if(accept("("))
+    {
+      parseOr();
+      expect(")");
+      return;
+    }
+
+    if(std::isdigit(static_cast<unsigned char>(c)) || '.' == c)
+    {
+      //the token is scanned here and converted in the C locale, strtod would follow the application's locale and stop
+      //at the '.' wherever the decimal separator is a comma
+      const size_t begin = m_Position;
+      skipDigits();
+      if(m_Position < m_Text.size() && '.' == m_Text[m_Position])
+      {
+        m_Position++;
+        skipDigits();
+      }
+      if(m_Position < m_Text.size() && ('e' == m_Text[m_Position] || 'E' == m_Text[m_Position]))
+      {
+        size_t exponent = m_Position + 1;
+        if(exponent < m_Text.size() && ('+' == m_Text[exponent] || '-' == m_Text[exponent]))
+        {
+          exponent++;
+        }
+        if(exponent < m_Text.size() && std::isdigit(static_cast<unsigned char>(m_Text[exponent])))
+        {
+          m_Position = exponent;
+          skipDigits();
+        }
+      }
+      bool ok = false;
+      const double value = QLocale::c().toDouble(QString::fromLatin1(m_Text.c_str() + begin, static_cast<int>(m_Position - begin)), &ok);
+      if(!ok)
+      {
+        m_Position = begin;
+        fail("invalid number");
+        return;
+      }
+      emit(Constant, static_cast<float>(value));
+      return;
+    }
+
+    if(!std::isalpha(static_cast<unsigned char>(c)))
+    {
+      fail(std::string("unexpected '") + c + "'");
+      return;
+    }
+    const size_t begin = m_Position;
+    while(m_Position < m_Text.size() && (std::isalnum(static_cast<unsigned char>(m_Text[m_Position])) || '_' == m_Text[m_Position]))
+    {
+      m_Position++;
+    }
+    const std::string name = m_Text.substr(begin, m_Position - begin);
+
+    if(!accept("("))
+    {
+      //a lone letter is an input
+      if(1 == name.size() && std::islower(static_cast<unsigned char>(name[0])))
+      {
+        const size_t variable = static_cast<size_t>(name[0] - 'a');
+        if(variable >= m_NumVariables)
+        {
+          m_Position = begin;
+          fail("'" + name + "' doesn't refer to a selected array");
+          return;
+        }
+        emit(Variable, 0.0f, variable);
+        return;
+      }
+      m_Position = begin;
+      fail("unknown name '" + name + "'");
+      return;
+    }
+
+    struct Function
+    {
+      const char* name;
+      OpCode op;
+    };
+    static const Function k_Functions[] = {{"abs", Abs}, {"sqrt", Sqrt}, {"log", Log}, {"exp", Exp}, {"min", Min}, {"max", Max}, {"pow", Pow}, {"clamp", Clamp}, {"if", Select}};
+    for(const Function& function : k_Functions)
+    {
+      if(name == function.name)
+      {
+        const size_t arity = Arity(function.op);
+        for(size_t i = 0; i < arity && m_Error.empty(); i++)
+        {
+          if(i > 0)
+          {
+            expect(",");
+          }
+          parseOr();
+        }
+        expect(")");
+        if(m_Error.empty())
+        {
+          emit(function.op);
+        }
+        return;
+      }
+    }
+    m_Position = begin;
+    fail("unknown function '" + name + "'");
+  }
+
+  std::string m_Text;
+  size_t m_Position = 0;
+  size_t m_NumVariables = 0;
+  std::string m_Error;
+  std::vector<Instruction> m_Program;
+  size_t m_Depth = 0;
+  size_t m_MaxDepth = 0;
+};
+
+/**
+ * @brief The ExpressionImpl class evaluates the program block by block and rounds / clamps straight into the output
+ */
+template <typename T>
+class ExpressionImpl
+{
+public:
+  ExpressionImpl(const Expression& expression, const std::vector<const T*>& inputs, T* output)
+  : m_Expression(expression)
+  , m_Inputs(inputs)
+  , m_Output(output)
+  {
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    const float maxValue = static_cast<float>(std::numeric_limits<T>::max());
+    const float minValue = static_cast<float>(std::numeric_limits<T>::lowest());
+    std::vector<float> stack(std::max<size_t>(1, m_Expression.depth()) * Expression::k_BlockSize);
+    for(size_t start = range.min(); start < range.max(); start += Expression::k_BlockSize)
+    {
+      const size_t count = std::min(Expression::k_BlockSize, range.max() - start);
+      const float* values = m_Expression.evaluate(m_Inputs.data(), start, count, stack.data());
+      T* output = m_Output + start;
+      for(size_t j = 0; j < count; j++)
+      {
+        //nan (e.g. 0/0) becomes 0, everything else is rounded half up and clamped
+        const float value = values[j] == values[j] ? std::min(std::max(values[j], minValue), maxValue) : 0.0f;
+        output[j] = static_cast<T>(std::floor(value + 0.5f));
+      }
+    }
+  }
+
+private:
+  const Expression& m_Expression;
+  const std::vector<const T*>& m_Inputs;
+  T* m_Output;
+};
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ItkPointwiseExpression::ItkPointwiseExpression() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ItkPointwiseExpression::~ItkPointwiseExpression() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkPointwiseExpression::setupFilterParameters()
+{
+  FilterParameterVectorType parameters;
+
+  parameters.push_back(SIMPL_NEW_STRING_FP("Expression", Expression, FilterParameter::Category::Parameter, ItkPointwiseExpression));
+  parameters.push_back(SeparatorFilterParameter::Create("Cell Data", FilterParameter::Category::RequiredArray));
+  {
+    MultiDataArraySelectionFilterParameter::RequirementType req =
+        MultiDataArraySelectionFilterParameter::CreateCategoryRequirement(SIMPL::TypeNames::UInt8, 1, AttributeMatrix::Category::Any);
+    parameters.push_back(SIMPL_NEW_MDA_SELECTION_FP("Input Arrays (a, b, c, ...)", SelectedCellArrayPaths, FilterParameter::Category::RequiredArray, ItkPointwiseExpression, req));
+  }
+  parameters.push_back(SeparatorFilterParameter::Create("Cell Data", FilterParameter::Category::CreatedArray));
+  parameters.push_back(SIMPL_NEW_STRING_FP("Output Attribute Array", NewCellArrayName, FilterParameter::Category::CreatedArray, ItkPointwiseExpression));
+
+  setFilterParameters(parameters);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkPointwiseExpression::readFilterParameters(AbstractFilterParametersReader* reader, int index)
+{
+  reader->openFilterGroup(this, index);
+  setSelectedCellArrayPaths( reader->readDataArrayPathVector( "SelectedCellArrayPaths", getSelectedCellArrayPaths() ) );
+  setExpression( reader->readString( "Expression", getExpression() ) );
+  setNewCellArrayName( reader->readString( "NewCellArrayName", getNewCellArrayName() ) );
+  reader->closeFilterGroup();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkPointwiseExpression::initialize()
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkPointwiseExpression::dataCheck()
+{
+  clearErrorCode();
+  clearWarningCode();
+  DataArrayPath tempPath;
+
+  if(m_SelectedCellArrayPaths.empty())
+  {
+    QString ss = QObject::tr("At least 1 input array must be selected");
+    setErrorCondition(-5572, ss);
+    return;
+  }
+  if(m_SelectedCellArrayPaths.size() > 26)
+  {
+    QString ss = QObject::tr("At most 26 input arrays (a-z) can be used");
+    setErrorCondition(-5572, ss);
+    return;
+  }
+
+  std::vector<size_t> dims(1, 1);
+  m_SelectedCellArraysPtrs.clear();
+  for(const DataArrayPath& path : m_SelectedCellArrayPaths)
+  {
+    std::weak_ptr<DataArray<ImageProcessingConstants::DefaultPixelType>> arrayPtr =
+        getDataContainerArray()->getPrereqArrayFromPath<DataArray<ImageProcessingConstants::DefaultPixelType>>(this, path, dims);
+    if(getErrorCode() < 0)
+    {
+      return;
+    }
+    if(!m_SelectedCellArraysPtrs.empty() && arrayPtr.lock()->getNumberOfTuples() != m_SelectedCellArraysPtrs.front().lock()->getNumberOfTuples())
+    {
+      QString ss = QObject::tr("The selected arrays must have the same number of tuples (%1 has %2, expected %3)")
+                       .arg(path.getDataArrayName())
+                       .arg(arrayPtr.lock()->getNumberOfTuples())
+                       .arg(m_SelectedCellArraysPtrs.front().lock()->getNumberOfTuples());
+      setErrorCondition(-5573, ss);
+      return;
+    }
+    m_SelectedCellArraysPtrs.push_back(arrayPtr);
+  }
+
+  ImageGeom::Pointer image = getDataContainerArray()->getDataContainer(m_SelectedCellArrayPaths.front().getDataContainerName())->getPrereqGeometry<ImageGeom>(this);
+  if(getErrorCode() < 0 || nullptr == image.get())
+  {
+    return;
+  }
+
+  Expression expression;
+  std::string error;
+  if(!expression.compile(m_Expression.toStdString(), m_SelectedCellArrayPaths.size(), error))
+  {
+    QString ss = QObject::tr("Invalid expression: %1").arg(QString::fromStdString(error));
+    setErrorCondition(-5574, ss);
+    return;
+  }
+
+  tempPath.update(m_SelectedCellArrayPaths.front().getDataContainerName(), m_SelectedCellArrayPaths.front().getAttributeMatrixName(), getNewCellArrayName());
+  m_NewCellArrayPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<ImageProcessingConstants::DefaultPixelType>>(this, tempPath, 0, dims, "", DataArrayID31);
+  if(nullptr != m_NewCellArrayPtr.lock())
+  { m_NewCellArray = m_NewCellArrayPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkPointwiseExpression::execute()
+{
+  dataCheck();
+  if(getErrorCode() < 0)
+  {
+    return;
+  }
+
+  using PixelType = ImageProcessingConstants::DefaultPixelType;
+  Expression expression;
+  std::string error;
+  expression.compile(m_Expression.toStdString(), m_SelectedCellArrayPaths.size(), error);
+
+  std::vector<const PixelType*> inputs;
+  for(const std::weak_ptr<DataArray<PixelType>>& arrayPtr : m_SelectedCellArraysPtrs)
+  {
+    inputs.push_back(arrayPtr.lock()->getPointer(0));
+  }
+  ParallelDataAlgorithm dataAlg;
+  dataAlg.setRange(0, m_NewCellArrayPtr.lock()->getNumberOfTuples());
+  dataAlg.execute(ExpressionImpl<PixelType>(expression, inputs, m_NewCellArray));
+}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer ItkPointwiseExpression::newFilterInstance(bool copyFilterParameters) const
+{
+  ItkPointwiseExpression::Pointer filter = ItkPointwiseExpression::New();
+  if(copyFilterParameters)
+  {
+    copyFilterParameterInstanceVariables(filter.get());
+  }
+  return filter;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ItkPointwiseExpression::getCompiledLibraryName() const
+{return ImageProcessingConstants::ImageProcessingBaseName;}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ItkPointwiseExpression::getGroupName() const
+{return SIMPL::FilterGroups::Unsupported;}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QUuid ItkPointwiseExpression::getUuid() const
+{
+  return QUuid("{e2a7c4d9-5b13-5f8e-8c06-1d9f3b7a2e54}");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ItkPointwiseExpression::getSubGroupName() const
+{return "Misc";}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ItkPointwiseExpression::getHumanLabel() const
+{ return "Pointwise Expression (ImageProcessing)"; }
+
+// -----------------------------------------------------------------------------
+ItkPointwiseExpression::Pointer ItkPointwiseExpression::NullPointer()
+{
+  return Pointer(static_cast<Self*>(nullptr));
+}
+
+// -----------------------------------------------------------------------------
+std::shared_ptr<ItkPointwiseExpression> ItkPointwiseExpression::New()
+{
+  struct make_shared_enabler : public ItkPointwiseExpression
+  {
+  };
+  std::shared_ptr<make_shared_enabler> val = std::make_shared<make_shared_enabler>();
+  val->setupFilterParameters();
+  return val;
+}
+
+// -----------------------------------------------------------------------------
+QString ItkPointwiseExpression::getNameOfClass() const
+{
+  return QString("ItkPointwiseExpression");
+}
+
+// -----------------------------------------------------------------------------
+QString ItkPointwiseExpression::ClassName()
+{
+  return QString("ItkPointwiseExpression");
+}
+
+// -----------------------------------------------------------------------------
+void ItkPointwiseExpression::setSelectedCellArrayPaths(const std::vector<DataArrayPath>& value)
+{
+  m_SelectedCellArrayPaths = value;
+}
+
+// -----------------------------------------------------------------------------
+std::vector<DataArrayPath> ItkPointwiseExpression::getSelectedCellArrayPaths() const
+{
+  return m_SelectedCellArrayPaths;
+}
+
+// -----------------------------------------------------------------------------
+void ItkPointwiseExpression::setExpression(const QString& value)
+{
+  m_Expression = value;
+}
+
+// -----------------------------------------------------------------------------
+QString ItkPointwiseExpression::getExpression() const
+{
+  return m_Expression;
+}
+
+// -----------------------------------------------------------------------------
+void ItkPointwiseExpression::setNewCellArrayName(const QString& value)
+{
+  m_NewCellArrayName = value;
+}
+
+// -----------------------------------------------------------------------------
+QString ItkPointwiseExpression::getNewCellArrayName() const
+{
+  return m_NewCellArrayName;
+}
@@ -0,0 +1,496 @@
+/* ============================================================================
+ * Copyright (c) 2014 William Lenthe
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of William Lenthe or any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  This code was partially written under United States Air Force Contract number
+ *                              FA8650-10-D-5210
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "ItkRGBToGray.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include "SIMPLib/Common/TemplateHelpers.h"
+#include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
+#include "SIMPLib/FilterParameters/FloatVec3FilterParameter.h"
+#include "SIMPLib/FilterParameters/MultiDataArraySelectionFilterParameter.h"
+#include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
+#include "SIMPLib/FilterParameters/StringFilterParameter.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
+
+#include "ImageProcessing/ImageProcessingConstants.h"
+
+/* Create Enumerations to allow the created Attribute Arrays to take part in renaming */
+enum createdPathID : RenameDataPath::DataID_t
+{
+  AttributeMatrixID21 = 21,
+};
+
+namespace
+{
+/**
+ * @brief The LuminanceImpl class computes the weighted sum of the first 3 components of each tuple (any alpha component
+ * is skipped). 8 and 16 bit integer pixels use 16 bit fixed point weights with 64 bit integer accumulation, other types
+ * are summed in double precision. Integer results are rounded and clamped to the pixel type.
+ */
+template <typename PixelType, size_t Components>
+class LuminanceImpl
+{
+public:
+  LuminanceImpl(const PixelType* input, const float weights[3], PixelType* output)
+  : m_Input(input)
+  , m_Output(output)
+  {
+    for(size_t c = 0; c < 3; c++)
+    {
+      m_Weights[c] = static_cast<double>(weights[c]);
+      m_FixedWeights[c] = static_cast<int64_t>(std::llround(m_Weights[c] * 65536.0));
+    }
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    const bool fixedPoint = std::is_integral<PixelType>::value && sizeof(PixelType) <= 2;
+    if(fixedPoint)
+    {
+      const int64_t lo = static_cast<int64_t>(std::numeric_limits<PixelType>::lowest());
+      const int64_t hi = static_cast<int64_t>(std::numeric_limits<PixelType>::max());
+      for(size_t i = range.min(); i < range.max(); i++)
+      {
+        const PixelType* rgb = m_Input + Components * i;
+        const int64_t sum = static_cast<int64_t>(rgb[0]) * m_FixedWeights[0] + static_cast<int64_t>(rgb[1]) * m_FixedWeights[1] + static_cast<int64_t>(rgb[2]) * m_FixedWeights[2];
+        const int64_t value = (sum + 32768) >> 16;
+        m_Output[i] = static_cast<PixelType>(std::min(std::max(value, lo), hi));
+      }
+      return;
+    }
+
+    const double lo = static_cast<double>(std::numeric_limits<PixelType>::lowest());
+    const double hi = static_cast<double>(std::numeric_limits<PixelType>::max());
+    for(size_t i = range.min(); i < range.max(); i++)
+    {
+      const PixelType* rgb = m_Input + Components * i;
+      double value = static_cast<double>(rgb[0]) * m_Weights[0] + static_cast<double>(rgb[1]) * m_Weights[1] + static_cast<double>(rgb[2]) * m_Weights[2];
+      if(std::is_integral<PixelType>::value)
+      {
+        value = std::floor(std::min(std::max(value, lo), hi) + 0.5);
+      }
+      m_Output[i] = static_cast<PixelType>(value);
+    }
+  }
+
+private:
+  const PixelType* m_Input;
+  PixelType* m_Output;
+  double m_Weights[3];
+  int64_t m_FixedWeights[3];
+};
+} // namespace
+
+/**
+ * @brief This is a private implementation for the filter that handles the actual algorithm implementation details
+ * for us like figuring out if we can use this private implementation with the data array that is assigned.
+ */
+template <typename PixelType>
+class RGBToGrayPrivate
+{
+  public:
+    typedef DataArray<PixelType> DataArrayType;
+
+    RGBToGrayPrivate() = default;
+    virtual ~RGBToGrayPrivate() = default;
+
+    // -----------------------------------------------------------------------------
+    // Determine if this is the proper type of an array to downcast from the IDataArray
+    // -----------------------------------------------------------------------------
+    bool operator()(IDataArray::Pointer p)
+    {
+      return (std::dynamic_pointer_cast<DataArrayType>(p).get() != nullptr);
+    }
+
+    // -----------------------------------------------------------------------------
+    // This is the actual templated algorithm
+    // -----------------------------------------------------------------------------
+    void static Execute(ItkRGBToGray* /*filter*/, IDataArray::Pointer inputIDataArray, IDataArray::Pointer outputIDataArray, const float weights[3])
+    {
+      const PixelType* inputData = std::dynamic_pointer_cast<DataArrayType>(inputIDataArray)->getPointer(0);
+      PixelType* outputData = std::dynamic_pointer_cast<DataArrayType>(outputIDataArray)->getPointer(0);
+
+      ParallelDataAlgorithm dataAlg;
+      dataAlg.setRange(0, inputIDataArray->getNumberOfTuples());
+      if(4 == inputIDataArray->getNumberOfComponents())
+      {
+        dataAlg.execute(LuminanceImpl<PixelType, 4>(inputData, weights, outputData));
+      }
+      else
+      {
+        dataAlg.execute(LuminanceImpl<PixelType, 3>(inputData, weights, outputData));
+      }
+    }
+
+  private:
+    RGBToGrayPrivate(const RGBToGrayPrivate&) = delete; // Copy Constructor Not Implemented
+    void operator=(const RGBToGrayPrivate&) = delete;   // Move assignment Not Implemented
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ItkRGBToGray::ItkRGBToGray() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ItkRGBToGray::~ItkRGBToGray() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkRGBToGray::setupFilterParameters()
+{
+  FilterParameterVectorType parameters;
+
+  parameters.push_back(SIMPL_NEW_FLOAT_VEC3_FP("Color Weighting", ColorWeights, FilterParameter::Category::Parameter, ItkRGBToGray));
+  parameters.push_back(SeparatorFilterParameter::Create("Cell Data", FilterParameter::Category::RequiredArray));
+  {
+    MultiDataArraySelectionFilterParameter::RequirementType req;
+    req.amTypes = {AttributeMatrix::Type::Cell};
+    req.componentDimensions = {std::vector<size_t>(1, 3), std::vector<size_t>(1, 4)};
+    parameters.push_back(SIMPL_NEW_MDA_SELECTION_FP("Input Attribute Arrays", InputDataArrayVector, FilterParameter::Category::RequiredArray, ItkRGBToGray, req));
+  }
+  parameters.push_back(SeparatorFilterParameter::Create("Cell Data", FilterParameter::Category::CreatedArray));
+  parameters.push_back(SIMPL_NEW_STRING_FP("Output Array Prefix", OutputArrayPrefix, FilterParameter::Category::CreatedArray, ItkRGBToGray));
+  parameters.push_back(SIMPL_NEW_STRING_FP("Output Cell Attribute Matrix", OutputAttributeMatrixName, FilterParameter::Category::CreatedArray, ItkRGBToGray));
+
+  setFilterParameters(parameters);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkRGBToGray::readFilterParameters(AbstractFilterParametersReader* reader, int index)
+{
+  reader->openFilterGroup(this, index);
+  setInputDataArrayVector( reader->readDataArrayPathVector( "InputDataArrayVector", getInputDataArrayVector() ) );
+  setColorWeights( reader->readFloatVec3( "ColorWeights", getColorWeights() ) );
+  setOutputArrayPrefix( reader->readString( "OutputArrayPrefix", getOutputArrayPrefix() ) );
+  setOutputAttributeMatrixName( reader->readString( "OutputAttributeMatrixName", getOutputAttributeMatrixName() ) );
+  reader->closeFilterGroup();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkRGBToGray::initialize()
+{
+  m_InputArrays.clear();
+  m_OutputArrays.clear();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkRGBToGray::dataCheck()
+{
+  clearErrorCode();
+  clearWarningCode();
+  initialize();
+  DataArrayPath tempPath;
+
+  if(m_InputDataArrayVector.empty())
+  {
+    QString ss = QObject::tr("At least one Attribute Array must be selected");
+    setErrorCondition(-5576, ss);
+    return;
+  }
+  if(!DataArrayPath::ValidateVector(m_InputDataArrayVector))
+  {
+    QString ss = QObject::tr("All Attribute Arrays must belong to the same Data Container and Attribute Matrix");
+    setErrorCondition(-5577, ss);
+    return;
+  }
+
+  const DataArrayPath& first = m_InputDataArrayVector.front();
+  DataContainer::Pointer m = getDataContainerArray()->getPrereqDataContainer(this, first.getDataContainerName());
+  if(getErrorCode() < 0)
+  {
+    return;
+  }
+  ImageGeom::Pointer image = m->getPrereqGeometry<ImageGeom>(this);
+  if(getErrorCode() < 0 || nullptr == image.get())
+  {
+    return;
+  }
+  AttributeMatrix::Pointer inputAttrMat = m->getPrereqAttributeMatrix(this, first.getAttributeMatrixName(), -5577);
+  if(getErrorCode() < 0)
+  {
+    return;
+  }
+
+  for(const DataArrayPath& path : m_InputDataArrayVector)
+  {
+    IDataArray::Pointer inputArray = getDataContainerArray()->getPrereqIDataArrayFromPath(this, path);
+    if(getErrorCode() < 0)
+    {
+      return;
+    }
+    if(inputArray->getNumberOfComponents() != 3 && inputArray->getNumberOfComponents() != 4)
+    {
+      QString ss = QObject::tr("'%1' must have 3 (RGB) or 4 (RGBA) components").arg(path.getDataArrayName());
+      setErrorCondition(-5578, ss);
+      return;
+    }
+    m_InputArrays.push_back(inputArray);
+  }
+
+  //one gray array per input, in a new cell attribute matrix with the same dimensions
+  m->createNonPrereqAttributeMatrix(this, getOutputAttributeMatrixName(), inputAttrMat->getTupleDimensions(), AttributeMatrix::Type::Cell, AttributeMatrixID21);
+  if(getErrorCode() < 0)
+  {
+    return;
+  }
+  std::vector<size_t> compDims(1, 1);
+  for(size_t i = 0; i < m_InputDataArrayVector.size(); i++)
+  {
+    tempPath.update(first.getDataContainerName(), getOutputAttributeMatrixName(), getOutputArrayPrefix() + m_InputDataArrayVector[i].getDataArrayName());
+    IDataArrayWkPtrType outputArray = TemplateHelpers::CreateNonPrereqArrayFromArrayType()(this, tempPath, compDims, m_InputArrays[i].lock());
+    if(getErrorCode() < 0)
+    {
+      return;
+    }
+    m_OutputArrays.push_back(outputArray);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkRGBToGray::execute()
+{
+  dataCheck();
+  if(getErrorCode() < 0)
+  {
+    return;
+  }
+
+  const float weights[3] = {m_ColorWeights[0], m_ColorWeights[1], m_ColorWeights[2]};
+  for(size_t i = 0; i < m_InputArrays.size(); i++)
+  {
+    if(getCancel())
+    {
+      return;
+    }
+    notifyStatusMessage(QObject::tr("Converting %1").arg(m_InputDataArrayVector[i].getDataArrayName()));
+
+    //execute type dependant portion using a Private Implementation that takes care of figuring out if
+    // we can work on the correct type and actually handling the algorithm execution.
+    IDataArray::Pointer inputData = m_InputArrays[i].lock();
+    IDataArray::Pointer outputData = m_OutputArrays[i].lock();
+    if(RGBToGrayPrivate<int8_t>()(inputData))
+    {
+      RGBToGrayPrivate<int8_t>::Execute(this, inputData, outputData, weights);
+    }
+    else if(RGBToGrayPrivate<uint8_t>()(inputData))
+    {
+      RGBToGrayPrivate<uint8_t>::Execute(this, inputData, outputData, weights);
+    }
+    else if(RGBToGrayPrivate<int16_t>()(inputData))
+    {
+      RGBToGrayPrivate<int16_t>::Execute(this, inputData, outputData, weights);
+    }
+    else if(RGBToGrayPrivate<uint16_t>()(inputData))
+    {
+      RGBToGrayPrivate<uint16_t>::Execute(this, inputData, outputData, weights);
+    }
+    else if(RGBToGrayPrivate<int32_t>()(inputData))
+    {
+      RGBToGrayPrivate<int32_t>::Execute(this, inputData, outputData, weights);
+    }
+    else if(RGBToGrayPrivate<uint32_t>()(inputData))
+    {
+      RGBToGrayPrivate<uint32_t>::Execute(this, inputData, outputData, weights);
+    }
+    else if(RGBToGrayPrivate<int64_t>()(inputData))
+    {
+      RGBToGrayPrivate<int64_t>::Execute(this, inputData, outputData, weights);
+    }
+    else if(RGBToGrayPrivate<uint64_t>()(inputData))
+    {
+      RGBToGrayPrivate<uint64_t>::Execute(this, inputData, outputData, weights);
+    }
+    else if(RGBToGrayPrivate<float>()(inputData))
+    {
+      RGBToGrayPrivate<float>::Execute(this, inputData, outputData, weights);
+    }
+    else if(RGBToGrayPrivate<double>()(inputData))
+    {
+      RGBToGrayPrivate<double>::Execute(this, inputData, outputData, weights);
+    }
+    else
+    {
+      QString ss = QObject::tr("A Supported DataArray type was not used for an input array.");
+      setErrorCondition(-10001, ss);
+      return;
+    }
+  }
+}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer ItkRGBToGray::newFilterInstance(bool copyFilterParameters) const
+{
+  ItkRGBToGray::Pointer filter = ItkRGBToGray::New();
+  if(copyFilterParameters)
+  {
+    copyFilterParameterInstanceVariables(filter.get());
+  }
+  return filter;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ItkRGBToGray::getCompiledLibraryName() const
+{return ImageProcessingConstants::ImageProcessingBaseName;}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ItkRGBToGray::getGroupName() const
+{return SIMPL::FilterGroups::Unsupported;}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QUuid ItkRGBToGray::getUuid() const
+{
+  return QUuid("{3f1c9a6e-7d24-5b8f-a053-9e6b2d4c1f87}");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ItkRGBToGray::getSubGroupName() const
+{return "Misc";}
+
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString ItkRGBToGray::getHumanLabel() const
+{ return "Convert RGB to Grayscale (ImageProcessing)"; }
+
+// -----------------------------------------------------------------------------
+ItkRGBToGray::Pointer ItkRGBToGray::NullPointer()
+{
+  return Pointer(static_cast<Self*>(nullptr));
+}
+
+// -----------------------------------------------------------------------------
+std::shared_ptr<ItkRGBToGray> ItkRGBToGray::New()
+{
+  struct make_shared_enabler : public ItkRGBToGray
+  {
+  };
+  std::shared_ptr<make_shared_enabler> val = std::make_shared<make_shared_enabler>();
+  val->setupFilterParameters();
+  return val;
+}
+
+// -----------------------------------------------------------------------------
+QString ItkRGBToGray::getNameOfClass() const
+{
+  return QString("ItkRGBToGray");
+}
+
+// -----------------------------------------------------------------------------
+QString ItkRGBToGray::ClassName()
+{
+  return QString("ItkRGBToGray");
+}
+
+// -----------------------------------------------------------------------------
+void ItkRGBToGray::setInputDataArrayVector(const std::vector<DataArrayPath>& value)
+{
+  m_InputDataArrayVector = value;
+}
+
+// -----------------------------------------------------------------------------
+std::vector<DataArrayPath> ItkRGBToGray::getInputDataArrayVector() const
+{
+  return m_InputDataArrayVector;
+}
+
+// -----------------------------------------------------------------------------
+void ItkRGBToGray::setColorWeights(const FloatVec3Type& value)
+{
+  m_ColorWeights = value;
+}
+
+// -----------------------------------------------------------------------------
+FloatVec3Type ItkRGBToGray::getColorWeights() const
+{
+  return m_ColorWeights;
+}
+
+// -----------------------------------------------------------------------------
+void ItkRGBToGray::setOutputArrayPrefix(const QString& value)
+{
+  m_OutputArrayPrefix = value;
+}
+
+// -----------------------------------------------------------------------------
+QString ItkRGBToGray::getOutputArrayPrefix() const
+{
+  return m_OutputArrayPrefix;
+}
+
+// -----------------------------------------------------------------------------
+void ItkRGBToGray::setOutputAttributeMatrixName(const QString& value)
+{
+  m_OutputAttributeMatrixName = value;
+}
+
+// -----------------------------------------------------------------------------
+QString ItkRGBToGray::getOutputAttributeMatrixName() const
+{
+  return m_OutputAttributeMatrixName;
+}
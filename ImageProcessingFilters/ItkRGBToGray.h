@@ -0,0 +1,230 @@
+/* ============================================================================
+ * Copyright (c) 2014 William Lenthe
+ * Copyright (c) 2014 DREAM3D Consortium
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of William Lenthe or any of the DREAM3D Consortium contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *  This code was partially written under United States Air Force Contract number
+ *                              FA8650-10-D-5210
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "SIMPLib/SIMPLib.h"
+#include "SIMPLib/Common/SIMPLArray.hpp"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+#include "SIMPLib/DataArrays/DataArray.hpp"
+
+using IDataArrayWkPtrType = std::weak_ptr<IDataArray>;
+
+#include "ImageProcessing/ImageProcessingConstants.h"
+
+#include "ImageProcessing/ImageProcessingDLLExport.h"
+
+/**
+ * @class ItkRGBToGray ItkRGBToGray.h ImageProcessing/ImageProcessingFilters/ItkRGBToGray.h
+ * @brief Converts 3 (RGB) or 4 (RGBA) component arrays to grayscale with a weighted sum of the color channels
+ * @author
+ * @date
+ * @version 1.0
+ */
+class ImageProcessing_EXPORT ItkRGBToGray : public AbstractFilter
+{
+    Q_OBJECT
+
+    // Start Python bindings declarations
+    PYB11_BEGIN_BINDINGS(ItkRGBToGray SUPERCLASS AbstractFilter)
+    PYB11_FILTER()
+    PYB11_SHARED_POINTERS(ItkRGBToGray)
+    PYB11_FILTER_NEW_MACRO(ItkRGBToGray)
+    PYB11_PROPERTY(std::vector<DataArrayPath> InputDataArrayVector READ getInputDataArrayVector WRITE setInputDataArrayVector)
+    PYB11_PROPERTY(FloatVec3Type ColorWeights READ getColorWeights WRITE setColorWeights)
+    PYB11_PROPERTY(QString OutputArrayPrefix READ getOutputArrayPrefix WRITE setOutputArrayPrefix)
+    PYB11_PROPERTY(QString OutputAttributeMatrixName READ getOutputAttributeMatrixName WRITE setOutputAttributeMatrixName)
+    PYB11_END_BINDINGS()
+    // End Python bindings declarations
+
+  public:
+    using Self = ItkRGBToGray;
+    using Pointer = std::shared_ptr<Self>;
+    using ConstPointer = std::shared_ptr<const Self>;
+    using WeakPointer = std::weak_ptr<Self>;
+    using ConstWeakPointer = std::weak_ptr<const Self>;
+    static Pointer NullPointer();
+
+    static std::shared_ptr<ItkRGBToGray> New();
+
+    /**
+     * @brief Returns the name of the class for ItkRGBToGray
+     */
+    QString getNameOfClass() const override;
+    /**
+     * @brief Returns the name of the class for ItkRGBToGray
+     */
+    static QString ClassName();
+
+    ~ItkRGBToGray() override;
+
+    /**
+     * @brief Setter property for InputDataArrayVector
+     */
+    void setInputDataArrayVector(const std::vector<DataArrayPath>& value);
+    /**
+     * @brief Getter property for InputDataArrayVector
+     * @return Value of InputDataArrayVector
+     */
+    std::vector<DataArrayPath> getInputDataArrayVector() const;
+
+    Q_PROPERTY(std::vector<DataArrayPath> InputDataArrayVector READ getInputDataArrayVector WRITE setInputDataArrayVector)
+
+    /**
+     * @brief Setter property for ColorWeights
+     */
+    void setColorWeights(const FloatVec3Type& value);
+    /**
+     * @brief Getter property for ColorWeights
+     * @return Value of ColorWeights
+     */
+    FloatVec3Type getColorWeights() const;
+
+    Q_PROPERTY(FloatVec3Type ColorWeights READ getColorWeights WRITE setColorWeights)
+
+    /**
+     * @brief Setter property for OutputArrayPrefix
+     */
+    void setOutputArrayPrefix(const QString& value);
+    /**
+     * @brief Getter property for OutputArrayPrefix
+     * @return Value of OutputArrayPrefix
+     */
+    QString getOutputArrayPrefix() const;
+
+    Q_PROPERTY(QString OutputArrayPrefix READ getOutputArrayPrefix WRITE setOutputArrayPrefix)
+
+    /**
+     * @brief Setter property for OutputAttributeMatrixName
+     */
+    void setOutputAttributeMatrixName(const QString& value);
+    /**
+     * @brief Getter property for OutputAttributeMatrixName
+     * @return Value of OutputAttributeMatrixName
+     */
+    QString getOutputAttributeMatrixName() const;
+
+    Q_PROPERTY(QString OutputAttributeMatrixName READ getOutputAttributeMatrixName WRITE setOutputAttributeMatrixName)
+
+    /**
+     * @brief getCompiledLibraryName Returns the name of the Library that this filter is a part of
+     * @return
+     */
+    QString getCompiledLibraryName() const override;
+
+    /**
+    * @brief This returns a string that is displayed in the GUI. It should be readable
+    * and understandable by humans.
+    */
+    QString getHumanLabel() const override;
+
+    /**
+    * @brief This returns the group that the filter belonds to. You can select
+    * a different group if you want. The string returned here will be displayed
+    * in the GUI for the filter
+    */
+    QString getGroupName() const override;
+
+    /**
+    * @brief This returns a string that is displayed in the GUI and helps to sort the filters into
+    * a subgroup. It should be readable and understandable by humans.
+    */
+    QString getSubGroupName() const override;
+
+    /**
+     * @brief getUuid Return the unique identifier for this filter.
+     * @return A QUuid object.
+     */
+    QUuid getUuid() const override;
+
+    /**
+    * @brief This method will instantiate all the end user settable options/parameters
+    * for this filter
+    */
+    void setupFilterParameters() override;
+
+    /**
+    * @brief This method will read the options from a file
+    * @param reader The reader that is used to read the options from a file
+    * @param index The index to read the information from
+    */
+    void readFilterParameters(AbstractFilterParametersReader* reader, int index) override;
+
+    /**
+     * @brief Reimplemented from @see AbstractFilter class
+     */
+    void execute() override;
+
+
+    /**
+     * @brief newFilterInstance Returns a new instance of the filter optionally copying the filter parameters from the
+     * current filter to the new instance.
+     * @param copyFilterParameters
+     * @return
+     */
+    AbstractFilter::Pointer newFilterInstance(bool copyFilterParameters) const override;
+
+  protected:
+    ItkRGBToGray();
+
+    /**
+     * @brief dataCheck Checks for the appropriate parameter values and availability of arrays
+     */
+    void dataCheck() override;
+
+    /**
+     * @brief Initializes all the private instance variables.
+     */
+    void initialize();
+
+
+  private:
+    std::vector<IDataArrayWkPtrType> m_InputArrays;
+    std::vector<IDataArrayWkPtrType> m_OutputArrays;
+
+    std::vector<DataArrayPath> m_InputDataArrayVector = {};
+    FloatVec3Type m_ColorWeights = {0.2125f, 0.7154f, 0.0721f};
+    QString m_OutputArrayPrefix = {"GrayScale_"};
+    QString m_OutputAttributeMatrixName = {"GrayScaleData"};
+
+  public:
+    ItkRGBToGray(const ItkRGBToGray&) = delete; // Copy Constructor Not Implemented
+    ItkRGBToGray(ItkRGBToGray&&) = delete;      // Move Constructor Not Implemented
+    ItkRGBToGray& operator=(const ItkRGBToGray&) = delete; // Copy Assignment Not Implemented
+    ItkRGBToGray& operator=(ItkRGBToGray&&) = delete;      // Move Assignment Not Implemented
+};
+
@@ -34,25 +34,37 @@
 
 #include "ItkStitchImages.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+
+#include <hdf5.h>
+
+#include "H5Support/H5ScopedSentinel.h"
+
 #include "SIMPLib/Common/SIMPLArray.hpp"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
 #include "SIMPLib/FilterParameters/AttributeMatrixSelectionFilterParameter.h"
+#include "SIMPLib/FilterParameters/ChoiceFilterParameter.h"
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/DataContainerCreationFilterParameter.h"
+#include "SIMPLib/FilterParameters/IntFilterParameter.h"
+#include "SIMPLib/FilterParameters/LinkedBooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/LinkedPathCreationFilterParameter.h"
+#include "SIMPLib/FilterParameters/OutputFileFilterParameter.h"
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
 #include "SIMPLib/Geometry/ImageGeom.h"
-#include "SIMPLib/ITK/itkBridge.h"
 #include "SIMPLib/DataContainers/DataContainerArray.h"
 #include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
 
 #include "itkMaskedFFTNormalizedCorrelationImageFilter.h"
 
-#include "itkImage.h"
-#include "itkImageFileWriter.h"
-#include "itkPasteImageFilter.h"
-
 #include "ImageProcessing/ImageProcessingConstants.h"
 #include "ImageProcessing/ImageProcessingHelpers.hpp"
 
@@ -65,6 +77,269 @@ enum createdPathID : RenameDataPath::DataID_t
   DataContainerID = 1
 };
 
+namespace
+{
+//montage rows are written in bands of this many rows, one band per task
+const size_t k_BandRows = 64;
+
+/**
+ * @brief The BlitImpl class assembles bands of montage rows. A band clears its rows and then copies the row segments
+ * of the tiles that cross it, in tile order, so overlapping pixels hold the last tile (as a paste in tile order would)
+ * and no two tasks ever write the same pixel. The output holds the montage rows from 'firstRow' on, which is the whole
+ * montage or one block of it.
+ */
+class BlitImpl
+{
+public:
+  BlitImpl(const std::vector<const uint8_t*>& tiles, const std::vector<size_t>& offsets, const size_t tileDims[2], const size_t montageDims[2], const std::vector<std::vector<size_t>>& bandTiles,
+           size_t firstRow, ImageProcessingConstants::DefaultPixelType* montage)
+  : m_Tiles(tiles)
+  , m_Offsets(offsets)
+  , m_TileDims(tileDims)
+  , m_MontageDims(montageDims)
+  , m_BandTiles(bandTiles)
+  , m_FirstRow(firstRow)
+  , m_Montage(montage)
+  {
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    for(size_t band = range.min(); band < range.max(); band++)
+    {
+      const size_t bandStart = band * k_BandRows;
+      const size_t bandEnd = std::min(bandStart + k_BandRows, m_MontageDims[1]);
+      std::fill(m_Montage + (bandStart - m_FirstRow) * m_MontageDims[0], m_Montage + (bandEnd - m_FirstRow) * m_MontageDims[0], 0);
+
+      const std::vector<size_t>& tiles = m_BandTiles[band];
+      for(size_t i = 0; i < tiles.size(); i++)
+      {
+        const size_t tile = tiles[i];
+        const size_t x = m_Offsets[2 * tile];
+        const size_t y = m_Offsets[2 * tile + 1];
+        const size_t rowStart = std::max(bandStart, y);
+        const size_t rowEnd = std::min(bandEnd, y + m_TileDims[1]);
+        for(size_t row = rowStart; row < rowEnd; row++)
+        {
+          const uint8_t* source = m_Tiles[tile] + (row - y) * m_TileDims[0];
+          std::copy(source, source + m_TileDims[0], m_Montage + (row - m_FirstRow) * m_MontageDims[0] + x);
+        }
+      }
+    }
+  }
+
+private:
+  const std::vector<const uint8_t*>& m_Tiles;
+  const std::vector<size_t>& m_Offsets;
+  const size_t* m_TileDims;
+  const size_t* m_MontageDims;
+  const std::vector<std::vector<size_t>>& m_BandTiles;
+  size_t m_FirstRow;
+  ImageProcessingConstants::DefaultPixelType* m_Montage;
+};
+
+enum Blending
+{
+  Overwrite = 0,
+  LinearFeather = 1,
+  CosineFeather = 2
+};
+
+/**
+ * @brief FeatherRamp returns the weight (16 bit fixed point, never 0) of every pixel along one axis of a tile. The
+ * weight rises from the tile edge to 1 at 'width' pixels in, or at the tile center for a width of 0.
+ */
+std::vector<uint32_t> FeatherRamp(size_t length, size_t width, bool cosine)
+{
+  const double pi = std::acos(-1.0);
+  const double span = static_cast<double>(width > 0 ? width : (length + 1) / 2);
+  std::vector<uint32_t> ramp(length);
+  for(size_t i = 0; i < length; i++)
+  {
+    const double t = std::min(1.0, static_cast<double>(std::min(i + 1, length - i)) / span);
+    const double value = cosine ? 0.5 - 0.5 * std::cos(pi * t) : t;
+    ramp[i] = std::max<uint32_t>(1, static_cast<uint32_t>(value * 65535.0 + 0.5));
+  }
+  return ramp;
+}
+
+/**
+ * @brief The FeatherImpl class assembles bands of montage rows as the weighted mean of every tile covering a pixel. A
+ * pixel's weight is the exact product of its tile's 16 bit axis ramps, and the weighted sums are 64 bit integers, which
+ * leaves room for millions of overlapping 8 bit tiles. Each row is accumulated and normalized in buffers of one
+ * montage row, and like BlitImpl the output starts at montage row 'firstRow'.
+ */
+class FeatherImpl
+{
+public:
+  FeatherImpl(const std::vector<const uint8_t*>& tiles, const std::vector<size_t>& offsets, const size_t tileDims[2], const size_t montageDims[2], const std::vector<std::vector<size_t>>& bandTiles,
+              const std::vector<uint32_t>& rampX, const std::vector<uint32_t>& rampY, size_t firstRow, ImageProcessingConstants::DefaultPixelType* montage)
+  : m_Tiles(tiles)
+  , m_Offsets(offsets)
+  , m_TileDims(tileDims)
+  , m_MontageDims(montageDims)
+  , m_BandTiles(bandTiles)
+  , m_RampX(rampX)
+  , m_RampY(rampY)
+  , m_FirstRow(firstRow)
+  , m_Montage(montage)
+  {
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    const size_t width = m_MontageDims[0];
+    std::vector<uint64_t> sums(width);
+    std::vector<uint64_t> weights(width);
+    for(size_t band = range.min(); band < range.max(); band++)
+    {
+      const size_t bandStart = band * k_BandRows;
+      const size_t bandEnd = std::min(bandStart + k_BandRows, m_MontageDims[1]);
+      const std::vector<size_t>& tiles = m_BandTiles[band];
+      for(size_t row = bandStart; row < bandEnd; row++)
+      {
+        std::fill(sums.begin(), sums.end(), 0);
+        std::fill(weights.begin(), weights.end(), 0);
+        for(size_t i = 0; i < tiles.size(); i++)
+        {
+          const size_t tile = tiles[i];
+          const size_t x = m_Offsets[2 * tile];
+          const size_t y = m_Offsets[2 * tile + 1];
+          if(row < y || row >= y + m_TileDims[1])
+          {
+            continue;
+          }
+          const uint8_t* source = m_Tiles[tile] + (row - y) * m_TileDims[0];
+          const uint64_t rowWeight = m_RampY[row - y];
+          uint64_t* sum = sums.data() + x;
+          uint64_t* weight = weights.data() + x;
+          for(size_t col = 0; col < m_TileDims[0]; col++)
+          {
+            const uint64_t w = m_RampX[col] * rowWeight;
+            sum[col] += source[col] * w;
+            weight[col] += w;
+          }
+        }
+
+        ImageProcessingConstants::DefaultPixelType* output = m_Montage + (row - m_FirstRow) * width;
+        for(size_t col = 0; col < width; col++)
+        {
+          output[col] = static_cast<ImageProcessingConstants::DefaultPixelType>(0 == weights[col] ? 0 : (sums[col] + weights[col] / 2) / weights[col]);
+        }
+      }
+    }
+  }
+
+private:
+  const std::vector<const uint8_t*>& m_Tiles;
+  const std::vector<size_t>& m_Offsets;
+  const size_t* m_TileDims;
+  const size_t* m_MontageDims;
+  const std::vector<std::vector<size_t>>& m_BandTiles;
+  const std::vector<uint32_t>& m_RampX;
+  const std::vector<uint32_t>& m_RampY;
+  size_t m_FirstRow;
+  ImageProcessingConstants::DefaultPixelType* m_Montage;
+};
+
+/**
+ * @brief PixelMemType returns the native HDF5 type matching the montage pixel type.
+ */
+hid_t PixelMemType()
+{
+  if(std::is_same<ImageProcessingConstants::DefaultPixelType, float>::value)
+  {
+    return H5T_NATIVE_FLOAT;
+  }
+  if(std::is_same<ImageProcessingConstants::DefaultPixelType, uint16_t>::value)
+  {
+    return H5T_NATIVE_UINT16;
+  }
+  return H5T_NATIVE_UINT8;
+}
+
+/**
+ * @brief The MontageFile class is a chunked 2D HDF5 dataset (rows by columns) the montage is streamed into block by
+ * block. Chunks span k_BandRows rows, so blocks made of whole bands only ever write complete chunks. The file is
+ * closed, and the HDF5 error printing it turned off restored, when the object goes out of scope; failures are reported
+ * through the return values instead.
+ */
+class MontageFile
+{
+public:
+  MontageFile()
+  : m_Sentinel(&m_File, true)
+  {
+  }
+
+  ~MontageFile()
+  {
+    if(m_Dataset >= 0)
+    {
+      H5Dclose(m_Dataset);
+    }
+  }
+
+  MontageFile(const MontageFile&) = delete;
+  MontageFile& operator=(const MontageFile&) = delete;
+
+  bool create(const QString& filePath, const QString& datasetName, const size_t montageDims[2])
+  {
+    m_Dims[0] = montageDims[1];
+    m_Dims[1] = montageDims[0];
+    m_File = H5Fcreate(filePath.toLocal8Bit().constData(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    if(m_File < 0)
+    {
+      return false;
+    }
+
+    const hsize_t chunk[2] = {std::min<hsize_t>(k_BandRows, m_Dims[0]), std::min<hsize_t>(4096, m_Dims[1])};
+    const hid_t space = H5Screate_simple(2, m_Dims, nullptr);
+    if(space < 0)
+    {
+      return false;
+    }
+    const hid_t plist = H5Pcreate(H5P_DATASET_CREATE);
+    if(plist >= 0 && H5Pset_chunk(plist, 2, chunk) >= 0)
+    {
+      m_Dataset = H5Dcreate2(m_File, datasetName.toLocal8Bit().constData(), PixelMemType(), space, H5P_DEFAULT, plist, H5P_DEFAULT);
+    }
+    if(plist >= 0)
+    {
+      H5Pclose(plist);
+    }
+    H5Sclose(space);
+    return m_Dataset >= 0;
+  }
+
+  bool writeRows(size_t firstRow, size_t numRows, const ImageProcessingConstants::DefaultPixelType* rows)
+  {
+    const hsize_t start[2] = {firstRow, 0};
+    const hsize_t count[2] = {numRows, m_Dims[1]};
+    const hid_t fileSpace = H5Dget_space(m_Dataset);
+    if(fileSpace < 0)
+    {
+      return false;
+    }
+    herr_t err = H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, start, nullptr, count, nullptr);
+    const hid_t memSpace = err >= 0 ? H5Screate_simple(2, count, nullptr) : -1;
+    if(memSpace >= 0)
+    {
+      err = H5Dwrite(m_Dataset, PixelMemType(), memSpace, fileSpace, H5P_DEFAULT, rows);
+      H5Sclose(memSpace);
+    }
+    H5Sclose(fileSpace);
+    return memSpace >= 0 && err >= 0;
+  }
+
+private:
+  hid_t m_File = -1;
+  hid_t m_Dataset = -1;
+  hsize_t m_Dims[2] = {0, 0};
+  H5ScopedFileSentinel m_Sentinel;
+};
+} // namespace
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -81,6 +356,28 @@ ItkStitchImages::~ItkStitchImages() = default;
 void ItkStitchImages::setupFilterParameters()
 {
   FilterParameterVectorType parameters;
+  {
+    ChoiceFilterParameter::Pointer parameter = ChoiceFilterParameter::New();
+    parameter->setHumanLabel("Overlap Blending");
+    parameter->setPropertyName("Blending");
+    parameter->setSetterCallback(SIMPL_BIND_SETTER(ItkStitchImages, this, Blending));
+    parameter->setGetterCallback(SIMPL_BIND_GETTER(ItkStitchImages, this, Blending));
+
+    std::vector<QString> choices;
+    choices.push_back("Overwrite");
+    choices.push_back("Linear Feather");
+    choices.push_back("Cosine Feather");
+    parameter->setChoices(choices);
+    parameter->setCategory(FilterParameter::Category::Parameter);
+    parameters.push_back(parameter);
+  }
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Feather Width (Pixels, 0 for Tile Center)", FeatherWidth, FilterParameter::Category::Parameter, ItkStitchImages));
+  QStringList linkedProps;
+  linkedProps << "MontageFilePath"
+              << "BlockRows";
+  parameters.push_back(SIMPL_NEW_LINKED_BOOL_FP("Write Montage to File", WriteMontageToFile, FilterParameter::Category::Parameter, ItkStitchImages, linkedProps));
+  parameters.push_back(SIMPL_NEW_OUTPUT_FILE_FP("Montage File", MontageFilePath, FilterParameter::Category::Parameter, ItkStitchImages, "*.h5", "HDF5"));
+  parameters.push_back(SIMPL_NEW_INTEGER_FP("Block Height (Rows)", BlockRows, FilterParameter::Category::Parameter, ItkStitchImages));
   parameters.push_back(SeparatorFilterParameter::Create("Cell Data", FilterParameter::Category::RequiredArray));
 
   {
@@ -119,6 +416,11 @@ void ItkStitchImages::readFilterParameters(AbstractFilterParametersReader* reade
   setStitchedImagesArrayName(reader->readString("StitchedImagesArrayName", getStitchedImagesArrayName()));
   setStitchedAttributeMatrixName(reader->readString("StitchedAttributeMatrixName", getStitchedAttributeMatrixName()));
   setAttributeArrayNamesPath(reader->readDataArrayPath("AttributeArrayNamesPath", getAttributeArrayNamesPath()));
+  setBlending(reader->readValue("Blending", getBlending()));
+  setFeatherWidth(reader->readValue("FeatherWidth", getFeatherWidth()));
+  setWriteMontageToFile(reader->readValue("WriteMontageToFile", getWriteMontageToFile()));
+  setMontageFilePath(reader->readString("MontageFilePath", getMontageFilePath()));
+  setBlockRows(reader->readValue("BlockRows", getBlockRows()));
   reader->closeFilterGroup();
 
 }
@@ -140,6 +442,31 @@ void ItkStitchImages::dataCheck()
 
   DataArrayPath tempPath;
 
+  if(m_FeatherWidth < 0)
+  {
+    setErrorCondition(-5581, QObject::tr("The feather width cannot be negative"));
+    return;
+  }
+
+  if(m_WriteMontageToFile)
+  {
+    if(m_MontageFilePath.isEmpty())
+    {
+      setErrorCondition(-5585, QObject::tr("The montage file must be set"));
+      return;
+    }
+    if(!QFileInfo(m_MontageFilePath).absoluteDir().exists())
+    {
+      setErrorCondition(-5586, QObject::tr("The directory of the montage file '%1' does not exist").arg(m_MontageFilePath));
+      return;
+    }
+    if(m_BlockRows < 1)
+    {
+      setErrorCondition(-5587, QObject::tr("The block height must be at least 1 row"));
+      return;
+    }
+  }
+
   AttributeMatrix::Pointer am = getDataContainerArray()->getAttributeMatrix(m_AttributeMatrixName);
 
   if (am.get() == nullptr)
@@ -208,6 +535,11 @@ void ItkStitchImages::dataCheck()
   if(getErrorCode() < 0) { return; }
   dims[0] = 1;
 
+  //a montage written to file is never held in memory, so no array is created for it
+  if(m_WriteMontageToFile)
+  {
+    return;
+  }
 
   tempPath.update(getStitchedVolumeDataContainerName().getDataContainerName(), getStitchedAttributeMatrixName(), getStitchedImagesArrayName() );
   m_StitchedImageArrayPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<ImageProcessingConstants::DefaultPixelType>>(
@@ -223,154 +555,131 @@ void ItkStitchImages::dataCheck()
 // -----------------------------------------------------------------------------
 void ItkStitchImages::execute()
 {
-
-  int err = 0;
-  // typically run your dataCheck function to make sure you can get that far and all your variables are initialized
   dataCheck();
-  // Check to make sure you made it through the data check. Errors would have been reported already so if something
-  // happens to fail in the dataCheck() then we simply return
   if(getErrorCode() < 0)
   {
     return;
   }
-  clearErrorCode();
-  clearWarningCode();
-
-  /* If some error occurs this code snippet can report the error up the call chain*/
-  if (err < 0)
-  {
-    QString ss = QObject::tr("Error Importing a Zeiss AxioVision file set.");
-    setErrorCondition(-90000, ss);
-    return;
-  }
-
-  float minx = 1000000.0f;
-  float maxx = 0.0f;
-  float miny = 1000000.0f;
-  float maxy = 0.0f;
-  float value;
 
   AttributeMatrix::Pointer am = getDataContainerArray()->getAttributeMatrix(m_AttributeMatrixName);
+  DataContainer::Pointer m2 = getDataContainerArray()->getDataContainer(getStitchedVolumeDataContainerName());
+  StringDataArray::Pointer namesPtr = m_AttributeArrayNamesPtr.lock();
+  const size_t numTiles = namesPtr->getNumberOfTuples();
 
-  size_t numArrays = m_AttributeArrayNamesPtr.lock()->getNumberOfTuples();
-  QList<QString> names;
+  std::vector<size_t> udims = am->getTupleDimensions();
+  const size_t tileDims[2] = {udims[0], udims[1]};
 
-  for (size_t i = 0; i < numArrays; i++)
+  //tiles are placed at their (truncated) origin relative to the lowest origin, the montage is their bounding box
+  float minx = std::numeric_limits<float>::max();
+  float miny = std::numeric_limits<float>::max();
+  for(size_t i = 0; i < numTiles; i++)
   {
-    QString tmpName = m_AttributeArrayNamesPtr.lock()->getValue(i);
-    names.append(tmpName);
+    minx = std::min(minx, m_StitchedCoordinates[2 * i]);
+    miny = std::min(miny, m_StitchedCoordinates[2 * i + 1]);
   }
 
-  UInt8ArrayType::Pointer imagePtr = UInt8ArrayType::NullPointer();
-  IDataArray::Pointer iDataArray = IDataArray::NullPointer();
-  uint8_t* image = nullptr;
+  std::vector<size_t> offsets(2 * numTiles, 0);
+  size_t montageDims[2] = {0, 0};
+  for(size_t i = 0; i < numTiles; i++)
+  {
+    offsets[2 * i] = static_cast<size_t>(std::floor(m_StitchedCoordinates[2 * i]) - std::floor(minx));
+    offsets[2 * i + 1] = static_cast<size_t>(std::floor(m_StitchedCoordinates[2 * i + 1]) - std::floor(miny));
+    montageDims[0] = std::max(montageDims[0], offsets[2 * i] + tileDims[0]);
+    montageDims[1] = std::max(montageDims[1], offsets[2 * i + 1] + tileDims[1]);
+  }
 
   DataArrayPath tempPath;
-
-  // getting the fist data container just to get the dimensions of each image.
-  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getAttributeMatrixName().getDataContainerName());
-  DataContainer::Pointer m2 = getDataContainerArray()->getDataContainer(getStitchedVolumeDataContainerName());
-
-  std::vector<size_t> udims;
-  udims = am->getTupleDimensions();
-
-  for (size_t i = 0; i < names.size(); i++)
+  std::vector<size_t> cDims(1, 1);
+  std::vector<const uint8_t*> tiles(numTiles, nullptr);
+  for(size_t i = 0; i < numTiles; i++)
   {
-    value = m_StitchedCoordinates[2 * i];
-    if(value > maxx) { maxx = value; }
-    if(value < minx) { minx = value; }
-
-    value = m_StitchedCoordinates[2 * i + 1];
-    if(value > maxy) { maxy = value; }
-    if(value < miny) { miny = value; }
+    tempPath.update(getAttributeMatrixName().getDataContainerName(), getAttributeMatrixName().getAttributeMatrixName(), namesPtr->getValue(i));
+    UInt8ArrayType::Pointer imagePtr = getDataContainerArray()->getPrereqArrayFromPath<UInt8ArrayType>(this, tempPath, cDims);
+    if(getErrorCode() < 0 || nullptr == imagePtr)
+    {
+      return;
+    }
+    tiles[i] = imagePtr->getPointer(0);
   }
 
+  //every band lists the tiles crossing it so each montage row is visited once, whatever the number of tiles
+  const size_t numBands = (montageDims[1] + k_BandRows - 1) / k_BandRows;
+  std::vector<std::vector<size_t>> bandTiles(numBands);
+  for(size_t i = 0; i < numTiles; i++)
+  {
+    const size_t y = offsets[2 * i + 1];
+    for(size_t band = y / k_BandRows; band < numBands && band * k_BandRows < y + tileDims[1]; band++)
+    {
+      bandTiles[band].push_back(i);
+    }
+  }
 
-  //    ImageProcessingConstants::UInt8ImageType* image2 = ImageProcessingConstants::UInt8ImageType::New();
-  ImageProcessingConstants::UInt8ImageType::Pointer image2 = ImageProcessingConstants::UInt8ImageType::New();
-  ImageProcessingConstants::UInt8ImageType::RegionType region;
-  ImageProcessingConstants::UInt8ImageType::IndexType start;
-  start[0] = 0;
-  start[1] = 0;
-  start[2] = 0;
-
-  ImageProcessingConstants::UInt8ImageType::SizeType size;
-  unsigned int NumRows = udims[0] + abs(int(maxx)) + abs(int(minx));
-  unsigned int NumCols = udims[1] + abs(int(maxy)) + abs(int(miny));
-  size[0] = NumRows;
-  size[1] = NumCols;
-  size[2] = 1;
-
-  region.SetSize(size);
-  region.SetIndex(start);
-
-
-  image2->SetRegions(region);
-  image2->Allocate();
-
-  using PasteImageFilterType = itk::PasteImageFilter<ImageProcessingConstants::UInt8ImageType, ImageProcessingConstants::UInt8ImageType>;
-  PasteImageFilterType::Pointer pasteFilter = PasteImageFilterType::New ();
-
-  using WriterType = itk::ImageFileWriter<ImageProcessingConstants::UInt8ImageType>;
-  WriterType::Pointer writer = WriterType::New();
+  //all tiles share their size, so the ramps are computed once
+  const bool cosine = CosineFeather == m_Blending;
+  std::vector<uint32_t> rampX;
+  std::vector<uint32_t> rampY;
+  if(Overwrite != m_Blending)
+  {
+    rampX = FeatherRamp(tileDims[0], static_cast<size_t>(m_FeatherWidth), cosine);
+    rampY = FeatherRamp(tileDims[1], static_cast<size_t>(m_FeatherWidth), cosine);
+  }
 
-  ImageProcessingConstants::UInt8ImageType::IndexType destinationIndex;
+  //assembles the bands [firstBand, lastBand) into 'rows', which holds the montage from the first row of firstBand on
+  auto assembleBands = [&](size_t firstBand, size_t lastBand, ImageProcessingConstants::DefaultPixelType* rows) {
+    ParallelDataAlgorithm dataAlg;
+    dataAlg.setRange(firstBand, lastBand);
+    if(Overwrite == m_Blending)
+    {
+      dataAlg.execute(BlitImpl(tiles, offsets, tileDims, montageDims, bandTiles, firstBand * k_BandRows, rows));
+    }
+    else
+    {
+      dataAlg.execute(FeatherImpl(tiles, offsets, tileDims, montageDims, bandTiles, rampX, rampY, firstBand * k_BandRows, rows));
+    }
+  };
 
   std::vector<size_t> tDims(3);
-  tDims[0] = NumRows;
-  tDims[1] = NumCols;
+  tDims[0] = montageDims[0];
+  tDims[1] = montageDims[1];
   tDims[2] = 1;
-
   m2->getAttributeMatrix(getStitchedAttributeMatrixName())->resizeAttributeArrays(tDims);
   m2->getGeometryAs<ImageGeom>()->setDimensions(tDims[0], tDims[1], tDims[2]);
 
-  std::vector<size_t> cDims(1, 1);
-
-  // run through all the data containers (images)
-  for(size_t i = 0; i < names.size(); i++)
+  if(!m_WriteMontageToFile)
   {
-    tempPath.update(getAttributeMatrixName().getDataContainerName(), getAttributeMatrixName().getAttributeMatrixName(), names[i]);
-    iDataArray = getDataContainerArray()->getPrereqArrayFromPath<UInt8ArrayType>(this, tempPath, cDims);
+    m_StitchedImageArray = m_StitchedImageArrayPtr.lock()->getPointer(0);
+    assembleBands(0, numBands, m_StitchedImageArray);
+    return;
+  }
 
-    imagePtr = std::dynamic_pointer_cast<UInt8ArrayType>(iDataArray);
+  //the montage is assembled in blocks of whole bands, only one of which is ever in memory, and each finished block is
+  //written to the file before the next one starts; the geometry still describes the montage but holds no array
+  MontageFile file;
+  if(!file.create(m_MontageFilePath, m_StitchedImagesArrayName, montageDims))
+  {
+    setErrorCondition(-5588, QObject::tr("Could not create the montage dataset '%1' in '%2'").arg(m_StitchedImagesArrayName).arg(m_MontageFilePath));
+    return;
+  }
 
-    if(nullptr != imagePtr.get())
+  const size_t blockBands = (static_cast<size_t>(m_BlockRows) + k_BandRows - 1) / k_BandRows;
+  std::vector<ImageProcessingConstants::DefaultPixelType> block(std::min(blockBands * k_BandRows, montageDims[1]) * montageDims[0]);
+  for(size_t firstBand = 0; firstBand < numBands; firstBand += blockBands)
+  {
+    if(getCancel())
     {
-      image = imagePtr->getPointer(0);
-      ImageProcessingConstants::ImportUInt8FilterType::Pointer importFilter = ITKUtilitiesType::Dream3DtoITKImportFilter<ImageProcessingConstants::DefaultPixelType>(m, getAttributeMatrixName().getAttributeMatrixName(), image);
-      ImageProcessingConstants::UInt8ImageType* currentImage = importFilter->GetOutput();
-
-
-      destinationIndex[0] = m_StitchedCoordinates[2 * i] + abs(int(minx));
-      destinationIndex[1] = m_StitchedCoordinates[2 * i + 1] + abs(int(miny));;
-      destinationIndex[2] = 0;
-
-      pasteFilter->InPlaceOn();
-      pasteFilter->SetSourceImage(currentImage);
-      pasteFilter->SetDestinationImage(image2);
-      pasteFilter->SetSourceRegion(currentImage->GetLargestPossibleRegion());
-      pasteFilter->SetDestinationIndex(destinationIndex);
-      pasteFilter->Update();
-      image2 = pasteFilter->GetOutput();
-      image2->DisconnectPipeline();
-      ITKUtilitiesType::SetITKFilterOutput(pasteFilter->GetOutput(), m_StitchedImageArrayPtr.lock());
-      pasteFilter->Update();
+      return;
     }
+    const size_t lastBand = std::min(firstBand + blockBands, numBands);
+    const size_t firstRow = firstBand * k_BandRows;
+    const size_t numRows = std::min(lastBand * k_BandRows, montageDims[1]) - firstRow;
+    assembleBands(firstBand, lastBand, block.data());
+    if(!file.writeRows(firstRow, numRows, block.data()))
+    {
+      setErrorCondition(-5589, QObject::tr("Could not write montage rows %1 to %2 to '%3'").arg(firstRow).arg(firstRow + numRows - 1).arg(m_MontageFilePath));
+      return;
+    }
+    notifyStatusMessage(QObject::tr("Wrote %1 of %2 Montage Rows").arg(firstRow + numRows).arg(montageDims[1]));
   }
-
-#if 0
-  writer->SetFileName( "/Users/megnashah/Desktop/testImage.tiff");
-  writer->SetInput( image2 );
-  writer->Update();
-#endif
-
-
-
-
-
-
-
-
 }
 
 // -----------------------------------------------------------------------------
@@ -522,3 +831,63 @@ QString ItkStitchImages::getStitchedAttributeMatrixName() const
 {
   return m_StitchedAttributeMatrixName;
 }
+
+// -----------------------------------------------------------------------------
+void ItkStitchImages::setBlending(unsigned int value)
+{
+  m_Blending = value;
+}
+
+// -----------------------------------------------------------------------------
+unsigned int ItkStitchImages::getBlending() const
+{
+  return m_Blending;
+}
+
+// -----------------------------------------------------------------------------
+void ItkStitchImages::setFeatherWidth(int value)
+{
+  m_FeatherWidth = value;
+}
+
+// -----------------------------------------------------------------------------
+int ItkStitchImages::getFeatherWidth() const
+{
+  return m_FeatherWidth;
+}
+
+// -----------------------------------------------------------------------------
+void ItkStitchImages::setWriteMontageToFile(bool value)
+{
+  m_WriteMontageToFile = value;
+}
+
+// -----------------------------------------------------------------------------
+bool ItkStitchImages::getWriteMontageToFile() const
+{
+  return m_WriteMontageToFile;
+}
+
+// -----------------------------------------------------------------------------
+void ItkStitchImages::setMontageFilePath(const QString& value)
+{
+  m_MontageFilePath = value;
+}
+
+// -----------------------------------------------------------------------------
+QString ItkStitchImages::getMontageFilePath() const
+{
+  return m_MontageFilePath;
+}
+
+// -----------------------------------------------------------------------------
+void ItkStitchImages::setBlockRows(int value)
+{
+  m_BlockRows = value;
+}
+
+// -----------------------------------------------------------------------------
+int ItkStitchImages::getBlockRows() const
+{
+  return m_BlockRows;
+}
@@ -68,6 +68,11 @@ class ImageProcessing_EXPORT ItkStitchImages : public AbstractFilter
     PYB11_PROPERTY(DataArrayPath StitchedVolumeDataContainerName READ getStitchedVolumeDataContainerName WRITE setStitchedVolumeDataContainerName)
     PYB11_PROPERTY(QString StitchedImagesArrayName READ getStitchedImagesArrayName WRITE setStitchedImagesArrayName)
     PYB11_PROPERTY(QString StitchedAttributeMatrixName READ getStitchedAttributeMatrixName WRITE setStitchedAttributeMatrixName)
+    PYB11_PROPERTY(unsigned int Blending READ getBlending WRITE setBlending)
+    PYB11_PROPERTY(int FeatherWidth READ getFeatherWidth WRITE setFeatherWidth)
+    PYB11_PROPERTY(bool WriteMontageToFile READ getWriteMontageToFile WRITE setWriteMontageToFile)
+    PYB11_PROPERTY(QString MontageFilePath READ getMontageFilePath WRITE setMontageFilePath)
+    PYB11_PROPERTY(int BlockRows READ getBlockRows WRITE setBlockRows)
     PYB11_END_BINDINGS()
     // End Python bindings declarations
 
@@ -164,6 +169,66 @@ class ImageProcessing_EXPORT ItkStitchImages : public AbstractFilter
 
     Q_PROPERTY(QString StitchedAttributeMatrixName READ getStitchedAttributeMatrixName WRITE setStitchedAttributeMatrixName)
 
+    /**
+     * @brief Setter property for Blending
+     */
+    void setBlending(unsigned int value);
+    /**
+     * @brief Getter property for Blending
+     * @return Value of Blending
+     */
+    unsigned int getBlending() const;
+
+    Q_PROPERTY(unsigned int Blending READ getBlending WRITE setBlending)
+
+    /**
+     * @brief Setter property for FeatherWidth
+     */
+    void setFeatherWidth(int value);
+    /**
+     * @brief Getter property for FeatherWidth
+     * @return Value of FeatherWidth
+     */
+    int getFeatherWidth() const;
+
+    Q_PROPERTY(int FeatherWidth READ getFeatherWidth WRITE setFeatherWidth)
+
+    /**
+     * @brief Setter property for WriteMontageToFile
+     */
+    void setWriteMontageToFile(bool value);
+    /**
+     * @brief Getter property for WriteMontageToFile
+     * @return Value of WriteMontageToFile
+     */
+    bool getWriteMontageToFile() const;
+
+    Q_PROPERTY(bool WriteMontageToFile READ getWriteMontageToFile WRITE setWriteMontageToFile)
+
+    /**
+     * @brief Setter property for MontageFilePath
+     */
+    void setMontageFilePath(const QString& value);
+    /**
+     * @brief Getter property for MontageFilePath
+     * @return Value of MontageFilePath
+     */
+    QString getMontageFilePath() const;
+
+    Q_PROPERTY(QString MontageFilePath READ getMontageFilePath WRITE setMontageFilePath)
+
+    /**
+     * @brief Setter property for BlockRows
+     */
+    void setBlockRows(int value);
+    /**
+     * @brief Getter property for BlockRows
+     * @return Value of BlockRows
+     */
+    int getBlockRows() const;
+
+    Q_PROPERTY(int BlockRows READ getBlockRows WRITE setBlockRows)
+
     /**
      * @brief getCompiledLibraryName Returns the name of the Library that this filter is a part of
      * @return
@@ -250,6 +315,11 @@ class ImageProcessing_EXPORT ItkStitchImages : public AbstractFilter
     DataArrayPath m_StitchedVolumeDataContainerName = {"MontagedImageDataContainer", "", ""};
     QString m_StitchedImagesArrayName = {"Montage"};
     QString m_StitchedAttributeMatrixName = {"MontageAttributeMatrix"};
+    unsigned int m_Blending = {0};
+    int m_FeatherWidth = {0};
+    bool m_WriteMontageToFile = {false};
+    QString m_MontageFilePath = {""};
+    int m_BlockRows = {1024};
 
     StringDataArray::WeakPointer    m_AttributeArrayNamesPtr;
 
@@ -35,33 +35,178 @@
 
 #include "ItkWatershed.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <vector>
+
 #include <QtCore/QString>
 
 #include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/Common/SIMPLRange.h"
 #include "SIMPLib/FilterParameters/DataArraySelectionFilterParameter.h"
 #include "SIMPLib/FilterParameters/StringFilterParameter.h"
 #include "SIMPLib/FilterParameters/FloatFilterParameter.h"
 #include "SIMPLib/FilterParameters/LinkedPathCreationFilterParameter.h"
 #include "SIMPLib/FilterParameters/AbstractFilterParametersReader.h"
+#include "SIMPLib/FilterParameters/BooleanFilterParameter.h"
 #include "SIMPLib/FilterParameters/SeparatorFilterParameter.h"
 #include "SIMPLib/Geometry/ImageGeom.h"
 #include "SIMPLib/ITK/itkBridge.h"
 #include "SIMPLib/DataContainers/DataContainerArray.h"
 #include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
 
 #include "ImageProcessing/ImageProcessingConstants.h"
-
-//ITK Includes
-#include "itkGradientMagnitudeImageFilter.h"
-#include "itkWatershedImageFilter.h"
+#include "ImageProcessing/ImageProcessingHelpers.hpp"
 
 /* Create Enumerations to allow the created Attribute Arrays to take part in renaming */
 enum createdPathID : RenameDataPath::DataID_t
 {
+  AttributeMatrixID21 = 21,
+
   DataArrayID30 = 30,
   DataArrayID31 = 31,
+  DataArrayID32 = 32,
+  DataArrayID33 = 33,
+  DataArrayID34 = 34,
+};
+
+namespace
+{
+//arrays of the merge tree attribute matrix (one tuple per join of two basins)
+const QString k_MergeBasinsArrayName("MergeBasins");
+const QString k_MergeDepthsArrayName("MergeDepths");
+
+/**
+ * @brief The GradientMagnitudeImpl class computes the central difference gradient magnitude (replicating edge voxels) for
+ * a range of rows and tracks the range of the result
+ */
+template <typename T>
+class GradientMagnitudeImpl
+{
+public:
+  GradientMagnitudeImpl(const T* input, const size_t dims[3], const float spacing[3], float* output, float* minMax, std::mutex* mutex)
+  : m_Input(input)
+  , m_Dims(dims)
+  , m_Spacing(spacing)
+  , m_Output(output)
+  , m_MinMax(minMax)
+  , m_Mutex(mutex)
+  {
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    const size_t strides[3] = {1, m_Dims[0], m_Dims[0] * m_Dims[1]};
+    float localMin = std::numeric_limits<float>::max();
+    float localMax = std::numeric_limits<float>::lowest();
+    for(size_t row = range.min(); row < range.max(); row++)
+    {
+      const size_t coords[3] = {0, row % m_Dims[1], row / m_Dims[1]};
+      const size_t rowStart = row * m_Dims[0];
+      for(size_t x = 0; x < m_Dims[0]; x++)
+      {
+        const size_t index = rowStart + x;
+        float sumSquares = 0.0f;
+        for(size_t d = 0; d < 3; d++)
+        {
+          const size_t c = 0 == d ? x : coords[d];
+          const size_t prev = c > 0 ? index - strides[d] : index;
+          const size_t next = c + 1 < m_Dims[d] ? index + strides[d] : index;
+          const float derivative = (static_cast<float>(m_Input[next]) - static_cast<float>(m_Input[prev])) / (2.0f * m_Spacing[d]);
+          sumSquares += derivative * derivative;
+        }
+        const float magnitude = std::sqrt(sumSquares);
+        m_Output[index] = magnitude;
+        localMin = std::min(localMin, magnitude);
+        localMax = std::max(localMax, magnitude);
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(*m_Mutex);
+    m_MinMax[0] = std::min(m_MinMax[0], localMin);
+    m_MinMax[1] = std::max(m_MinMax[1], localMax);
+  }
+
+private:
+  const T* m_Input;
+  const size_t* m_Dims;
+  const float* m_Spacing;
+  float* m_Output;
+  float* m_MinMax;
+  std::mutex* m_Mutex;
+};
+
+/**
+ * @brief The ThresholdImpl class raises every value below the threshold to the threshold so shallow minima flood together
+ */
+class ThresholdImpl
+{
+public:
+  ThresholdImpl(float* data, float threshold)
+  : m_Data(data)
+  , m_Threshold(threshold)
+  {
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    for(size_t i = range.min(); i < range.max(); i++)
+    {
+      m_Data[i] = std::max(m_Data[i], m_Threshold);
+    }
+  }
+
+private:
+  float* m_Data;
+  float m_Threshold;
 };
 
+/**
+ * @brief The MergeTreeRelabelImpl class writes the feature of every basin id in one pass. Ids outside of 1 - maxBasin
+ * are left out and the lowest offending cell is kept so it can be reported once the pass is done
+ */
+class MergeTreeRelabelImpl
+{
+public:
+  MergeTreeRelabelImpl(const int32_t* basinIds, const std::vector<int32_t>& features, int32_t maxBasin, int32_t* featureIds, std::atomic<size_t>* badCell)
+  : m_BasinIds(basinIds)
+  , m_Features(features)
+  , m_MaxBasin(maxBasin)
+  , m_FeatureIds(featureIds)
+  , m_BadCell(badCell)
+  {
+  }
+
+  void operator()(const SIMPLRange& range) const
+  {
+    for(size_t i = range.min(); i < range.max(); i++)
+    {
+      const int32_t basin = m_BasinIds[i];
+      if(basin < 1 || basin > m_MaxBasin)
+      {
+        size_t bad = m_BadCell->load();
+        while(i < bad && !m_BadCell->compare_exchange_weak(bad, i))
+        {
+        }
+        return;
+      }
+      m_FeatureIds[i] = m_Features[basin];
+    }
+  }
+
+private:
+  const int32_t* m_BasinIds;
+  const std::vector<int32_t>& m_Features;
+  int32_t m_MaxBasin;
+  int32_t* m_FeatureIds;
+  std::atomic<size_t>* m_BadCell;
+};
+} // namespace
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -87,6 +232,10 @@ void ItkWatershed::setupFilterParameters()
   parameters.push_back(SIMPL_NEW_DA_WITH_LINKED_AM_FP("Feature Ids", FeatureIdsArrayName, SelectedCellArrayPath, SelectedCellArrayPath, FilterParameter::Category::CreatedArray, ItkWatershed));
   parameters.push_back(SIMPL_NEW_FLOAT_FP("Threshold", Threshold, FilterParameter::Category::Parameter, ItkWatershed));
   parameters.push_back(SIMPL_NEW_FLOAT_FP("Level", Level, FilterParameter::Category::Parameter, ItkWatershed));
+  parameters.push_back(SIMPL_NEW_BOOL_FP("Save Merge Tree", SaveMergeTree, FilterParameter::Category::Parameter, ItkWatershed));
+  parameters.push_back(SIMPL_NEW_BOOL_FP("Relabel From Saved Merge Tree", RelabelFromMergeTree, FilterParameter::Category::Parameter, ItkWatershed));
+  parameters.push_back(SIMPL_NEW_STRING_FP("Basin Ids", BasinIdsArrayName, FilterParameter::Category::CreatedArray, ItkWatershed));
+  parameters.push_back(SIMPL_NEW_STRING_FP("Merge Tree Attribute Matrix", MergeTreeAttributeMatrixName, FilterParameter::Category::CreatedArray, ItkWatershed));
   setFilterParameters(parameters);
 }
 
@@ -100,6 +249,10 @@ void ItkWatershed::readFilterParameters(AbstractFilterParametersReader* reader,
   setFeatureIdsArrayName( reader->readString( "FeatureIdsArrayName", getFeatureIdsArrayName() ) );
   setThreshold( reader->readValue( "Threshold", getThreshold() ) );
   setLevel( reader->readValue( "Level", getLevel() ) );
+  setSaveMergeTree( reader->readValue( "SaveMergeTree", getSaveMergeTree() ) );
+  setRelabelFromMergeTree( reader->readValue( "RelabelFromMergeTree", getRelabelFromMergeTree() ) );
+  setBasinIdsArrayName( reader->readString( "BasinIdsArrayName", getBasinIdsArrayName() ) );
+  setMergeTreeAttributeMatrixName( reader->readString( "MergeTreeAttributeMatrixName", getMergeTreeAttributeMatrixName() ) );
   reader->closeFilterGroup();
 }
 
@@ -119,16 +272,41 @@ void ItkWatershed::dataCheck()
   clearWarningCode();
   DataArrayPath tempPath;
 
+  if(m_SaveMergeTree && m_RelabelFromMergeTree)
+  {
+    QString ss = QObject::tr("The merge tree cannot be saved while relabeling from a saved merge tree");
+    setErrorCondition(-5558, ss);
+    return;
+  }
+
   std::vector<size_t> dims(1, 1);
-  m_SelectedCellArrayPtr = getDataContainerArray()->getPrereqArrayFromPath<DataArray<ImageProcessingConstants::DefaultPixelType>>(this, getSelectedCellArrayPath(), dims);
-  if(nullptr != m_SelectedCellArrayPtr.lock())
-  { m_SelectedCellArray = m_SelectedCellArrayPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
+  if(m_RelabelFromMergeTree)
+  {
+    //the image isn't needed, only the basins and how they merge
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getSelectedCellArrayPath().getAttributeMatrixName(), getBasinIdsArrayName());
+    m_BasinIdsPtr = getDataContainerArray()->getPrereqArrayFromPath<DataArray<int32_t>>(this, tempPath, dims);
+    if(nullptr != m_BasinIdsPtr.lock())
+    { m_BasinIds = m_BasinIdsPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
+
+    std::vector<size_t> mergeDims(1, 2);
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getMergeTreeAttributeMatrixName(), k_MergeBasinsArrayName);
+    m_MergeBasinsPtr = getDataContainerArray()->getPrereqArrayFromPath<DataArray<int32_t>>(this, tempPath, mergeDims);
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getMergeTreeAttributeMatrixName(), k_MergeDepthsArrayName);
+    m_MergeDepthsPtr = getDataContainerArray()->getPrereqArrayFromPath<DataArray<float>>(this, tempPath, dims);
+  }
+  else
+  {
+    m_SelectedCellArrayPtr = getDataContainerArray()->getPrereqArrayFromPath<DataArray<ImageProcessingConstants::DefaultPixelType>>(this, getSelectedCellArrayPath(), dims);
+    if(nullptr != m_SelectedCellArrayPtr.lock())
+    { m_SelectedCellArray = m_SelectedCellArrayPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
+  }
   if(getErrorCode() < 0)
   {
     return;
   }
 
-  ImageGeom::Pointer image = getDataContainerArray()->getDataContainer(getSelectedCellArrayPath().getDataContainerName())->getPrereqGeometry<ImageGeom>(this);
+  DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getSelectedCellArrayPath().getDataContainerName());
+  ImageGeom::Pointer image = m->getPrereqGeometry<ImageGeom>(this);
   if(getErrorCode() < 0 || nullptr == image.get())
   {
     return;
@@ -138,6 +316,28 @@ void ItkWatershed::dataCheck()
   m_FeatureIdsPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<int32_t>>(this, tempPath, 0, dims, "", DataArrayID31);
   if(nullptr != m_FeatureIdsPtr.lock())
   { m_FeatureIds = m_FeatureIdsPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
+
+  if(m_SaveMergeTree)
+  {
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getSelectedCellArrayPath().getAttributeMatrixName(), getBasinIdsArrayName());
+    m_BasinIdsPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<int32_t>>(this, tempPath, 0, dims, "", DataArrayID32);
+    if(nullptr != m_BasinIdsPtr.lock())
+    { m_BasinIds = m_BasinIdsPtr.lock()->getPointer(0); } /* Now assign the raw pointer to data from the DataArray<T> object */
+
+    //the number of joins is only known after flooding
+    std::vector<size_t> tDims(1, 0);
+    m->createNonPrereqAttributeMatrix(this, getMergeTreeAttributeMatrixName(), tDims, AttributeMatrix::Type::Generic, AttributeMatrixID21);
+    if(getErrorCode() < 0)
+    {
+      return;
+    }
+
+    std::vector<size_t> mergeDims(1, 2);
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getMergeTreeAttributeMatrixName(), k_MergeBasinsArrayName);
+    m_MergeBasinsPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<int32_t>>(this, tempPath, 0, mergeDims, "", DataArrayID33);
+    tempPath.update(getSelectedCellArrayPath().getDataContainerName(), getMergeTreeAttributeMatrixName(), k_MergeDepthsArrayName);
+    m_MergeDepthsPtr = getDataContainerArray()->createNonPrereqArrayFromPath<DataArray<float>>(this, tempPath, 0, dims, "", DataArrayID34);
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -152,52 +352,114 @@ void ItkWatershed::execute()
     return;
   }
 
+  if(m_RelabelFromMergeTree)
+  {
+    relabelFromMergeTree();
+    return;
+  }
+
   DataContainer::Pointer m = getDataContainerArray()->getDataContainer(getSelectedCellArrayPath().getDataContainerName());
-  QString attrMatName = getSelectedCellArrayPath().getAttributeMatrixName();
 
-  //wrap m_RawImageData as itk::image
-  ImageProcessingConstants::DefaultImageType::Pointer inputImage = ITKUtilitiesType::CreateItkWrapperForDataPointer(m, attrMatName, m_SelectedCellArray);
+  ImageGeom::Pointer image = m->getGeometryAs<ImageGeom>();
+  SizeVec3Type udims = image->getDimensions();
+  FloatVec3Type res = image->getSpacing();
+  const size_t dims[3] = {udims[0], udims[1], udims[2]};
+  const float spacing[3] = {res[0], res[1], res[2]};
+  const size_t totalPoints = m_SelectedCellArrayPtr.lock()->getNumberOfTuples();
 
-  //create gradient magnitude filter
+  //compute gradient magnitude
   notifyStatusMessage("Calculating Gradient Magnitude");
-  typedef itk::GradientMagnitudeImageFilter<ImageProcessingConstants::DefaultImageType, ImageProcessingConstants::DefaultImageType >  GradientMagnitudeImageFilterType;
-  GradientMagnitudeImageFilterType::Pointer gradientMagnitudeImageFilter = GradientMagnitudeImageFilterType::New();
-  gradientMagnitudeImageFilter->SetInput(inputImage);
-  gradientMagnitudeImageFilter->Update();
+  std::vector<float> gradient(totalPoints);
+  float minMax[2] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest()};
+  std::mutex mutex;
+  ParallelDataAlgorithm dataAlg;
+  dataAlg.setRange(0, dims[1] * dims[2]);
+  dataAlg.execute(GradientMagnitudeImpl<ImageProcessingConstants::DefaultPixelType>(m_SelectedCellArray, dims, spacing, gradient.data(), minMax, &mutex));
+  if(getCancel())
+  {
+    return;
+  }
 
-  //watershed image
+  //threshold and level are fractions of the gradient range
+  const float depth = minMax[1] - minMax[0];
+  dataAlg.setRange(0, totalPoints);
+  dataAlg.execute(ThresholdImpl(gradient.data(), minMax[0] + m_Threshold * depth));
+
+  //flood directly into the feature ids (or the basin ids when they are kept)
   notifyStatusMessage("Watershedding");
-  typedef itk::WatershedImageFilter<ImageProcessingConstants::DefaultImageType> WatershedFilterType;
-  WatershedFilterType::Pointer watershed = WatershedFilterType::New();
-  watershed->SetThreshold(m_Threshold);
-  watershed->SetLevel(m_Level);
-  watershed->SetInput(gradientMagnitudeImageFilter->GetOutput());
-
-  //execute filter
-  try
+  int32_t* basinIds = m_SaveMergeTree ? m_BasinIds : m_FeatureIds;
+  ImageProcessing::Watershed<float> watershed(gradient.data(), dims, basinIds);
+  watershed.flood();
+  gradient = std::vector<float>();
+  std::vector<ImageProcessing::Watershed<float>::Merge> tree = watershed.mergeTree();
+  std::vector<int32_t> features = ImageProcessing::Watershed<float>::Cut(tree, watershed.getNumberOfBasins(), m_Level * depth);
+  if(m_SaveMergeTree)
   {
-    watershed->Update();
+    //depths are stored as fractions of the gradient range so they compare directly against the level
+    std::vector<size_t> tDims(1, tree.size());
+    m->getAttributeMatrix(getMergeTreeAttributeMatrixName())->resizeAttributeArrays(tDims);
+    int32_t* mergeBasins = m_MergeBasinsPtr.lock()->getPointer(0);
+    float* mergeDepths = m_MergeDepthsPtr.lock()->getPointer(0);
+    for(size_t i = 0; i < tree.size(); i++)
+    {
+      mergeBasins[2 * i] = tree[i].a;
+      mergeBasins[2 * i + 1] = tree[i].b;
+      mergeDepths[i] = depth > 0.0f ? tree[i].depth / depth : 0.0f;
+    }
+    std::copy(basinIds, basinIds + totalPoints, m_FeatureIds);
   }
-  catch( itk::ExceptionObject& err )
+  ImageProcessing::Watershed<float>::Relabel(m_FeatureIds, totalPoints, features);
+  int32_t numFeatures = *std::max_element(features.begin(), features.end());
+
+  QString ss = QObject::tr("Segmented %1 basins into %2 features").arg(watershed.getNumberOfBasins()).arg(numFeatures);
+  notifyStatusMessage(ss);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void ItkWatershed::relabelFromMergeTree()
+{
+  DataArray<int32_t>::Pointer mergeBasinsPtr = m_MergeBasinsPtr.lock();
+  DataArray<float>::Pointer mergeDepthsPtr = m_MergeDepthsPtr.lock();
+  const size_t numMerges = mergeBasinsPtr->getNumberOfTuples();
+  const size_t totalPoints = m_BasinIdsPtr.lock()->getNumberOfTuples();
+  const int32_t* mergeBasins = mergeBasinsPtr->getPointer(0);
+  const float* mergeDepths = mergeDepthsPtr->getPointer(0);
+
+  //a tree over n basins has n - 1 joins
+  std::vector<ImageProcessing::Watershed<float>::Merge> tree(numMerges);
+  int32_t maxBasin = static_cast<int32_t>(numMerges + 1);
+  for(size_t i = 0; i < numMerges; i++)
   {
-    QString ss = QObject::tr("Failed to execute itk::GradientMagnitudeImageFilter filter. Error Message returned from ITK:\n   %1").arg(err.GetDescription());
-    setErrorCondition(-5, ss);
+    tree[i].a = mergeBasins[2 * i];
+    tree[i].b = mergeBasins[2 * i + 1];
+    tree[i].depth = mergeDepths[i];
+    if(tree[i].a < 1 || tree[i].b < 1)
+    {
+      QString ss = QObject::tr("The merge tree references basin %1, basin ids start at 1").arg(std::min(tree[i].a, tree[i].b));
+      setErrorCondition(-5559, ss);
+      return;
+    }
+    maxBasin = std::max(maxBasin, std::max(tree[i].a, tree[i].b));
   }
-
-  //get output and copy to grainids
-  typedef itk::Image<ImageProcessingConstants::UInt64PixelType, ImageProcessingConstants::ImageDimension>   WatershedImageType;
-  WatershedFilterType::OutputImageType* output = watershed->GetOutput();
-  WatershedImageType::RegionType filterRegion = output->GetLargestPossibleRegion();
-  typedef itk::ImageRegionConstIterator< WatershedFilterType::OutputImageType > WatershedIteratorType;
-  WatershedIteratorType it(output, filterRegion);
-  it.GoToBegin();
-  int index = 0;
-  while(!it.IsAtEnd())
+  std::vector<int32_t> features = ImageProcessing::Watershed<float>::Cut(tree, static_cast<size_t>(maxBasin), m_Level);
+
+  //range check, basin id read and feature id write in a single pass, a bad id is reported afterwards
+  std::atomic<size_t> badCell(totalPoints);
+  ParallelDataAlgorithm dataAlg;
+  dataAlg.setRange(0, totalPoints);
+  dataAlg.execute(MergeTreeRelabelImpl(m_BasinIds, features, maxBasin, m_FeatureIds, &badCell));
+  const size_t cell = badCell.load();
+  if(cell < totalPoints)
   {
-    m_FeatureIds[index] = it.Get();
-    ++it;
-    ++index;
+    QString ss = QObject::tr("Basin id %1 at cell %2 is not part of the merge tree").arg(m_BasinIds[cell]).arg(cell);
+    setErrorCondition(-5560, ss);
+    return;
   }
+
+  QString ss = QObject::tr("Relabeled %1 basins into %2 features").arg(maxBasin).arg(*std::max_element(features.begin(), features.end()));
+  notifyStatusMessage(ss);
 }
 
 // -----------------------------------------------------------------------------
@@ -325,3 +587,51 @@ float ItkWatershed::getLevel() const
 {
   return m_Level;
 }
+
+// -----------------------------------------------------------------------------
+void ItkWatershed::setSaveMergeTree(bool value)
+{
+  m_SaveMergeTree = value;
+}
+
+// -----------------------------------------------------------------------------
+bool ItkWatershed::getSaveMergeTree() const
+{
+  return m_SaveMergeTree;
+}
+
+// -----------------------------------------------------------------------------
+void ItkWatershed::setRelabelFromMergeTree(bool value)
+{
+  m_RelabelFromMergeTree = value;
+}
+
+// -----------------------------------------------------------------------------
+bool ItkWatershed::getRelabelFromMergeTree() const
+{
+  return m_RelabelFromMergeTree;
+}
+
+// -----------------------------------------------------------------------------
+void ItkWatershed::setBasinIdsArrayName(const QString& value)
+{
+  m_BasinIdsArrayName = value;
+}
+
+// -----------------------------------------------------------------------------
+QString ItkWatershed::getBasinIdsArrayName() const
+{
+  return m_BasinIdsArrayName;
+}
+
+// -----------------------------------------------------------------------------
+void ItkWatershed::setMergeTreeAttributeMatrixName(const QString& value)
+{
+  m_MergeTreeAttributeMatrixName = value;
+}
+
+// -----------------------------------------------------------------------------
+QString ItkWatershed::getMergeTreeAttributeMatrixName() const
+{
+  return m_MergeTreeAttributeMatrixName;
+}
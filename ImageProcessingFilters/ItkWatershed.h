@@ -67,6 +67,10 @@ class ImageProcessing_EXPORT ItkWatershed : public AbstractFilter
     PYB11_PROPERTY(QString FeatureIdsArrayName READ getFeatureIdsArrayName WRITE setFeatureIdsArrayName)
     PYB11_PROPERTY(float Threshold READ getThreshold WRITE setThreshold)
     PYB11_PROPERTY(float Level READ getLevel WRITE setLevel)
+    PYB11_PROPERTY(bool SaveMergeTree READ getSaveMergeTree WRITE setSaveMergeTree)
+    PYB11_PROPERTY(bool RelabelFromMergeTree READ getRelabelFromMergeTree WRITE setRelabelFromMergeTree)
+    PYB11_PROPERTY(QString BasinIdsArrayName READ getBasinIdsArrayName WRITE setBasinIdsArrayName)
+    PYB11_PROPERTY(QString MergeTreeAttributeMatrixName READ getMergeTreeAttributeMatrixName WRITE setMergeTreeAttributeMatrixName)
     PYB11_END_BINDINGS()
     // End Python bindings declarations
 
@@ -138,6 +142,54 @@ class ImageProcessing_EXPORT ItkWatershed : public AbstractFilter
 
     Q_PROPERTY(float Level READ getLevel WRITE setLevel)
 
+    /**
+     * @brief Setter property for SaveMergeTree
+     */
+    void setSaveMergeTree(bool value);
+    /**
+     * @brief Getter property for SaveMergeTree
+     * @return Value of SaveMergeTree
+     */
+    bool getSaveMergeTree() const;
+
+    Q_PROPERTY(bool SaveMergeTree READ getSaveMergeTree WRITE setSaveMergeTree)
+
+    /**
+     * @brief Setter property for RelabelFromMergeTree
+     */
+    void setRelabelFromMergeTree(bool value);
+    /**
+     * @brief Getter property for RelabelFromMergeTree
+     * @return Value of RelabelFromMergeTree
+     */
+    bool getRelabelFromMergeTree() const;
+
+    Q_PROPERTY(bool RelabelFromMergeTree READ getRelabelFromMergeTree WRITE setRelabelFromMergeTree)
+
+    /**
+     * @brief Setter property for BasinIdsArrayName
+     */
+    void setBasinIdsArrayName(const QString& value);
+    /**
+     * @brief Getter property for BasinIdsArrayName
+     * @return Value of BasinIdsArrayName
+     */
+    QString getBasinIdsArrayName() const;
+
+    Q_PROPERTY(QString BasinIdsArrayName READ getBasinIdsArrayName WRITE setBasinIdsArrayName)
+
+    /**
+     * @brief Setter property for MergeTreeAttributeMatrixName
+     */
+    void setMergeTreeAttributeMatrixName(const QString& value);
+    /**
+     * @brief Getter property for MergeTreeAttributeMatrixName
+     * @return Value of MergeTreeAttributeMatrixName
+     */
+    QString getMergeTreeAttributeMatrixName() const;
+
+    Q_PROPERTY(QString MergeTreeAttributeMatrixName READ getMergeTreeAttributeMatrixName WRITE setMergeTreeAttributeMatrixName)
+
     /**
      * @brief getCompiledLibraryName Returns the name of the Library that this filter is a part of
      * @return
@@ -215,11 +267,24 @@ class ImageProcessing_EXPORT ItkWatershed : public AbstractFilter
     ImageProcessingConstants::DefaultPixelType* m_SelectedCellArray = nullptr;
     std::weak_ptr<DataArray<int32_t>> m_FeatureIdsPtr;
     int32_t* m_FeatureIds = nullptr;
+    std::weak_ptr<DataArray<int32_t>> m_BasinIdsPtr;
+    int32_t* m_BasinIds = nullptr;
+    std::weak_ptr<DataArray<int32_t>> m_MergeBasinsPtr;
+    std::weak_ptr<DataArray<float>> m_MergeDepthsPtr;
 
     DataArrayPath m_SelectedCellArrayPath = {"", "", ""};
     QString m_FeatureIdsArrayName = {SIMPL::CellData::FeatureIds};
     float m_Threshold = {0.005f};
     float m_Level = {0.5f};
+    bool m_SaveMergeTree = {false};
+    bool m_RelabelFromMergeTree = {false};
+    QString m_BasinIdsArrayName = {"BasinIds"};
+    QString m_MergeTreeAttributeMatrixName = {"MergeTree"};
+
+    /**
+     * @brief relabelFromMergeTree Cuts the saved merge tree at the current level and writes the feature ids
+     */
+    void relabelFromMergeTree();
 
   public:
     ItkWatershed(const ItkWatershed&) = delete;   // Copy Constructor Not Implemented
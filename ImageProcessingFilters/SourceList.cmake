@@ -22,11 +22,14 @@ set(_PublicFilters
   ItkBinaryWatershedLabeled
   ItkConvertArrayTo8BitImage
   ItkConvertArrayTo8BitImageAttributeMatrix
+  ItkDetermineStitching
   ItkDiscreteGaussianBlur
   ItkFindMaxima
+  ItkFlatFieldCorrection
   ItkGaussianBlur
   ItkGrayToRGB
   ItkHoughCircles
+  ItkHoughSpheres
   ItkImageCalculator
   ItkImageMath
   ItkKdTreeKMeans
@@ -35,6 +38,8 @@ set(_PublicFilters
   ItkMeanKernel
   ItkMedianKernel
   ItkMultiOtsuThreshold
+  ItkPointwiseExpression
+  ItkRGBToGray
   ItkSobelEdge
   ItkStitchImages
   ItkWatershed
@@ -31,7 +31,16 @@
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <limits>
+#include <memory>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 #include "itkImage.h"
 
 #include "itkRegionalMaximaImageFilter.h"
@@ -43,155 +52,2151 @@
 #include "itkFloodFilledImageFunctionConditionalIterator.h"
 #include "itkImageFileWriter.h"
 
+#include "SIMPLib/Common/SIMPLRange.h"
+#include "SIMPLib/Utilities/ParallelDataAlgorithm.h"
+
 
 namespace ImageProcessing
 {
 
-  //this class emulates imagej's "find maxima" algorithm
+  //partition of a hash table split for parallel merging that holds a key. the key is mixed first so neighboring keys
+  //(adjacent colors, accumulator cells, ...) are scattered over all partitions and the per partition work stays balanced
+  inline size_t HashPartition(uint64_t key, size_t numPartitions)
+  {
+    key ^= key >> 31;
+    key *= 0x7fb5d329728ea185ULL;
+    key ^= key >> 27;
+    return static_cast<size_t>(key % numPartitions);
+  }
+
+  //face (or face, edge and corner) neighbors of a pixel, offsets are computed once and only border pixels check bounds
+  class Neighborhood
+  {
+    public:
+      Neighborhood(const size_t dims[3], bool fullyConnected) : m_Dims(dims), m_Count(0)
+      {
+        for(int dz = -1; dz <= 1; dz++)
+        {
+          for(int dy = -1; dy <= 1; dy++)
+          {
+            for(int dx = -1; dx <= 1; dx++)
+            {
+              const int directions[3] = {dx, dy, dz};
+              const int distance = std::abs(dx) + std::abs(dy) + std::abs(dz);
+              bool flat = false;//steps along an axis with a single pixel
+              for(size_t d = 0; d < 3; d++)
+              {
+                flat = flat || (0 != directions[d] && 1 == dims[d]);
+              }
+              if(0 == distance || (!fullyConnected && distance > 1) || flat)
+              {
+                continue;
+              }
+              for(size_t d = 0; d < 3; d++)
+              {
+                m_Directions[m_Count][d] = directions[d];
+              }
+              m_Offsets[m_Count++] = dx + dy * static_cast<int64_t>(dims[0]) + dz * static_cast<int64_t>(dims[0] * dims[1]);
+            }
+          }
+        }
+      }
+
+      //fills adjacent with the neighbors of index and returns how many there are
+      size_t operator()(size_t index, size_t* adjacent) const
+      {
+        const size_t coords[3] = {index % m_Dims[0], (index / m_Dims[0]) % m_Dims[1], index / (m_Dims[0] * m_Dims[1])};
+        bool interior = true;
+        for(size_t d = 0; d < 3; d++)
+        {
+          interior = interior && (1 == m_Dims[d] || (coords[d] > 0 && coords[d] + 1 < m_Dims[d]));
+        }
+
+        size_t count = 0;
+        for(size_t i = 0; i < m_Count; i++)
+        {
+          bool inside = interior;
+          if(!interior)
+          {
+            inside = true;
+            for(size_t d = 0; d < 3; d++)
+            {
+              inside = inside && !(m_Directions[i][d] < 0 && 0 == coords[d]) && !(m_Directions[i][d] > 0 && coords[d] + 1 >= m_Dims[d]);
+            }
+          }
+          if(inside)
+          {
+            adjacent[count++] = static_cast<size_t>(static_cast<int64_t>(index) + m_Offsets[i]);
+          }
+        }
+        return count;
+      }
+
+    private:
+      const size_t* m_Dims;
+      size_t m_Count;
+      int64_t m_Offsets[26];
+      int m_Directions[26][3];
+  };
+
+  //this class emulates imagej's "find maxima" algorithm: a regional maximum is a peak unless the region within
+  //noiseTolerance of it (face connected) also holds a higher value, equal maxima sharing a region form a single peak.
+  //maxima are visited from highest to lowest and every pixel is flooded at most once, a flood that runs into the
+  //area of an earlier (higher or already rejected) flood is rejected immediately
   template< class TInputImage >
   class LocalMaxima
   {
     public:
-      typedef itk::Image<uint8_t, TInputImage::ImageDimension> BinaryImageType;
-      typedef itk::RegionalMaximaImageFilter<TInputImage, BinaryImageType> MaximaType;
-      typedef itk::BinaryImageToLabelMapFilter<BinaryImageType> BinaryToLabelType;
-      typedef itk::BinaryThresholdImageFunction< TInputImage, double > ThresholdFunctionType;
-      typedef itk::FloodFilledImageFunctionConditionalIterator< TInputImage, ThresholdFunctionType > FloodingIterator;
+      typedef typename TInputImage::PixelType PixelType;
+      typedef typename TInputImage::IndexType IndexType;
 
-      typename std::vector<typename TInputImage::IndexType> static Find(typename TInputImage::Pointer inputImage, typename TInputImage::PixelType noiseTolerance, bool fullyConnected)
+      //a peak found by Find(): its (rounded) centroid, its value and the first of its regional maxima in raster order
+      struct FoundPeak
       {
-        //find local maxaima (any region of constant value surrounded by pixels of lower value)
-        typename MaximaType::Pointer maxima = MaximaType::New();
-        maxima->SetInput(inputImage);
-        maxima->SetBackgroundValue(0);
-        maxima->SetForegroundValue(255);
-        maxima->SetFullyConnected(fullyConnected);//4 vs 8 connected
-        //segment local maxima flag image
-        typename BinaryToLabelType::Pointer binaryLabel = BinaryToLabelType::New();
-        binaryLabel->SetInput(maxima->GetOutput());
-        binaryLabel->SetFullyConnected(fullyConnected);
-        binaryLabel->Update();
+        IndexType index;
+        PixelType value;
+        size_t maximum;
+      };
 
+      typename std::vector<IndexType> static Find(typename TInputImage::Pointer inputImage, PixelType noiseTolerance, bool fullyConnected)
+      {
+        std::vector<FoundPeak> peaks = FindPeaks(inputImage, noiseTolerance, fullyConnected);
+        std::vector<IndexType> peakLocations;
+        peakLocations.reserve(peaks.size());
+        for(size_t i = 0; i < peaks.size(); i++)
+        {
+          peakLocations.push_back(peaks[i].index);
+        }
+        return peakLocations;
+      }
 
+      //Find() with the value of each peak, optionally returning the peak each regional maximum (numbered as in
+      //Prominence()) was combined into, -1 for maxima that are not part of a peak
+      typename std::vector<FoundPeak> static FindPeaks(typename TInputImage::Pointer inputImage, PixelType noiseTolerance, bool fullyConnected, std::vector<int64_t>* peakOfMaximum = nullptr)
+      {
+        size_t dims[3] = {1, 1, 1};
+        const PixelType* data = Buffer(inputImage, dims);
+        const size_t numPixels = dims[0] * dims[1] * dims[2];
+        const Neighborhood faceNeighbors(dims, false);
+        size_t adjacent[26];
 
+        //find local maxima (any region of constant value surrounded by pixels of lower value)
+        std::vector<int32_t> maxima;
+        std::vector<size_t> members;
+        std::vector<size_t> memberStart;
+        LabelMaxima(data, dims, fullyConnected, maxima, members, memberStart);
+        const size_t numObjects = memberStart.size() - 1;
 
+        //visit maxima from highest to lowest (raster order for ties)
+        std::vector<size_t> order(numObjects);
+        for(size_t i = 0; i < numObjects; i++)
+        {
+          order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+          PixelType lhsValue = data[members[memberStart[lhs]]];
+          PixelType rhsValue = data[members[memberStart[rhs]]];
+          return lhsValue != rhsValue ? lhsValue > rhsValue : lhs < rhs;
+        });
 
-        //loop over all local maxima eliminating bad peaks
-        int numObjects = binaryLabel->GetOutput()->GetNumberOfLabelObjects();
-        std::vector<bool> goodPeak (numObjects, true);
-        for(int i=0; i<numObjects; i++)
+        //the flood (maximum id + 1) each pixel was reached by
+        std::vector<int32_t> flooded(numPixels, 0);
+        std::vector<bool> done(numObjects, false);
+        std::vector<int64_t> owner(numObjects, -1);
+        std::vector<FoundPeak> peaks;
+        std::vector<size_t> group;
+        std::vector<size_t> front;
+        for(size_t n = 0; n < numObjects; n++)
         {
-          //make sure we haven't already eliminated this peak
-          if(goodPeak[i])
+          const size_t object = order[n];
+          if(done[object])
           {
-            //get peak label object and height of peak
-            typename BinaryToLabelType::OutputImageType::LabelObjectType* labelObject = binaryLabel->GetOutput()->GetNthLabelObject(i);
+            continue;
+          }
+          const int32_t floodId = static_cast<int32_t>(object) + 1;
+          const PixelType peakValue = data[members[memberStart[object]]];
+          const double threshold = static_cast<double>(peakValue) - static_cast<double>(noiseTolerance);//flood fill through anything within tolerance
 
-            //create list of seed points (label member pixels)
-            typename std::vector<typename TInputImage::IndexType> seedList;
-            for(size_t j=0; j<labelObject->Size(); j++)
+          bool goodPeak = true;
+          group.assign(1, object);
+          done[object] = true;
+          front.clear();
+          for(size_t k = memberStart[object]; k < memberStart[object + 1]; k++)
+          {
+            if(0 != flooded[members[k]])
             {
-              seedList.push_back(labelObject->GetIndex(j));
+              goodPeak = false;//part of the plateau was reached from a higher peak
             }
+            flooded[members[k]] = floodId;
+            front.push_back(members[k]);
+          }
 
-            //get peak value (all pixels in label have same value)
-            typename TInputImage::PixelType peakValue = inputImage->GetPixel(seedList[0]);
-
-            //create threshold function to flood fill
-            typename ThresholdFunctionType::Pointer thresholdFunction = ThresholdFunctionType::New();
-            thresholdFunction->SetInputImage(inputImage);
-            thresholdFunction->ThresholdAbove(peakValue-noiseTolerance);//flood fill through anything within tolerance
-
-            //iterate over image, flood filling (only changes pixels in iterator list, not image values)
-            FloodingIterator it(inputImage, thresholdFunction, seedList);
-            it.GoToBegin();
-            while ( !it.IsAtEnd() )
+          while(goodPeak && !front.empty())
+          {
+            size_t index = front.back();
+            front.pop_back();
+            size_t count = faceNeighbors(index, adjacent);
+            for(size_t j = 0; j < count; j++)
             {
-              //another peak of higher intensity is within the watershed tolerance, this peak is bad
-              if(it.Get()>peakValue)
+              size_t other = adjacent[j];
+              if(floodId == flooded[other] || static_cast<double>(data[other]) < threshold)
               {
-                goodPeak[i]=false;
+                continue;
+              }
+
+              //another peak of higher intensity is within the tolerance (directly or through an earlier flood), this peak is bad
+              if(0 != flooded[other] || data[other] > peakValue)
+              {
+                goodPeak = false;
                 break;
               }
-              else if(it.Get()==peakValue)
+              flooded[other] = floodId;
+              front.push_back(other);
+
+              //there is another peak within tolerance that is the same intensity, merge it into this one
+              if(data[other] == peakValue && maxima[other] > 0 && !done[maxima[other] - 1])
               {
-                //check if index belongs to another object (not in this peak)
-                typename TInputImage::IndexType otherIndex = it.GetIndex();
-                if(!labelObject->HasIndex(otherIndex))
-                {
-                  //there is another peak within tolerance that is the same intensity, find the peak it belongs to
-                  //loop over other good objects to find peak id
-                  for(int j = i+1; j < numObjects; j++)
-                  {
-                    if(goodPeak[j])
-                    {
-                      if(binaryLabel->GetOutput()->GetNthLabelObject(j)->HasIndex(otherIndex))
-                      {
-                        //label j is the peak with the same value as i, merge labels
-                        goodPeak[j] = false;
-                        typename BinaryToLabelType::OutputImageType::LabelObjectType* otherLabelObject = binaryLabel->GetOutput()->GetNthLabelObject(j);
-                        for(size_t k=0; k<otherLabelObject->Size(); k++)
-                        {
-                          labelObject->AddIndex(otherLabelObject->GetIndex(k));
-                        }
-                        break;
-                      }
-                    }
-                  }
-                }
+                done[maxima[other] - 1] = true;
+                group.push_back(maxima[other] - 1);
               }
-              //increment
-              ++it;
             }
           }
+
+          if(goodPeak)
+          {
+            //consolidate the peak region to its (rounded) centroid
+            double sum[3] = {0.0, 0.0, 0.0};
+            size_t numVoxels = 0;
+            for(size_t g = 0; g < group.size(); g++)
+            {
+              AccumulateCoordinates(dims, members, memberStart[group[g]], memberStart[group[g] + 1], sum);
+              numVoxels += memberStart[group[g] + 1] - memberStart[group[g]];
+            }
+            const FoundPeak peak = {Centroid(sum, numVoxels), peakValue, *std::min_element(group.begin(), group.end())};
+            for(size_t g = 0; g < group.size(); g++)
+            {
+              owner[group[g]] = static_cast<int64_t>(peaks.size());
+            }
+            peaks.push_back(peak);
+          }
         }
 
-        //loop over all good peaks consolidating from a region->1 voxel
-        std::vector<typename TInputImage::IndexType> peakLocations;
-        for(int i=0; i<numObjects; i++)
+        //report peaks in order of their first maximum
+        std::vector<size_t> rank(peaks.size());
+        for(size_t i = 0; i < peaks.size(); i++)
+        {
+          rank[i] = i;
+        }
+        std::sort(rank.begin(), rank.end(), [&](size_t lhs, size_t rhs) { return peaks[lhs].maximum < peaks[rhs].maximum; });
+        std::vector<FoundPeak> sorted;
+        sorted.reserve(peaks.size());
+        std::vector<int64_t> position(peaks.size());
+        for(size_t i = 0; i < rank.size(); i++)
+        {
+          position[rank[i]] = static_cast<int64_t>(i);
+          sorted.push_back(peaks[rank[i]]);
+        }
+        if(nullptr != peakOfMaximum)
         {
-          if(goodPeak[i])
+          peakOfMaximum->assign(numObjects, -1);
+          for(size_t i = 0; i < numObjects; i++)
           {
-            //get label object and find size
-            typename BinaryToLabelType::OutputImageType::LabelObjectType* labelObject = binaryLabel->GetOutput()->GetNthLabelObject(i);
-            int numVoxels = labelObject->Size();
+            if(owner[i] >= 0)
+            {
+              (*peakOfMaximum)[i] = position[owner[i]];
+            }
+          }
+        }
+        return sorted;
+      }
+
+      //a regional maximum and the tolerance up to which it is reported as its own peak
+      struct Peak
+      {
+        IndexType index;//rounded centroid of the maximum's plateau
+        PixelType value;
+        double prominence;//depth below the maximum at which it meets a higher (or equal and earlier) maximum, infinite for the highest peak
+        int64_t parent;//equal valued maximum this one merges into once the tolerance reaches its prominence (-1 if none)
+        double sum[3];//coordinate sums and number of voxels of the plateau
+        size_t count;
+      };
+
+      //computes the prominence of every regional maximum in a single pass over the pixels in descending order
+      //(union-find over face neighbors), Cut() then gives the peaks for any tolerance
+      typename std::vector<Peak> static Prominence(typename TInputImage::Pointer inputImage, bool fullyConnected)
+      {
+        size_t dims[3] = {1, 1, 1};
+        const PixelType* data = Buffer(inputImage, dims);
+        const size_t numPixels = dims[0] * dims[1] * dims[2];
+        const Neighborhood faceNeighbors(dims, false);
+        size_t adjacent[26];
 
-            //find average location
-            typename TInputImage::IndexType peakIndex;
-            if(1==numVoxels)
+        std::vector<int32_t> maxima;
+        std::vector<size_t> members;
+        std::vector<size_t> memberStart;
+        LabelMaxima(data, dims, fullyConnected, maxima, members, memberStart);
+        const size_t numObjects = memberStart.size() - 1;
+
+        std::vector<Peak> peaks(numObjects);
+        for(size_t i = 0; i < numObjects; i++)
+        {
+          Peak& peak = peaks[i];
+          peak.value = data[members[memberStart[i]]];
+          peak.prominence = std::numeric_limits<double>::infinity();
+          peak.parent = -1;
+          peak.sum[0] = peak.sum[1] = peak.sum[2] = 0.0;
+          AccumulateCoordinates(dims, members, memberStart[i], memberStart[i + 1], peak.sum);
+          peak.count = memberStart[i + 1] - memberStart[i];
+          peak.index = Centroid(peak.sum, peak.count);
+        }
+
+        //higher value wins, earlier maximum wins ties
+        auto better = [&](int32_t lhs, int32_t rhs) { return peaks[lhs].value != peaks[rhs].value ? peaks[lhs].value > peaks[rhs].value : lhs < rhs; };
+
+        //pixels from highest to lowest (raster order for ties)
+        std::vector<size_t> order = DescendingOrder(data, numPixels);
+
+        //component of each added pixel. the root of a component is always its highest pixel, and the best maximum of a
+        //component is kept at its root in the maxima labels, which are not needed once a pixel is added (1 based, 0 or
+        //less for none). a component may reach a higher pixel than its best maximum when the pixel's higher neighbors are
+        //only edge / corner connected
+        const size_t notAdded = std::numeric_limits<size_t>::max();
+        std::vector<size_t> parent(numPixels, notAdded);
+        auto findRoot = [&](size_t i) {
+          while(parent[i] != i)
+          {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+          }
+          return i;
+        };
+        auto bestOf = [&](size_t root) { return maxima[root] > 0 ? maxima[root] - 1 : -1; };
+        //the best maximum of one component meets the other component at this level
+        auto meet = [&](int32_t maximum, size_t other, double level) {
+          const int32_t otherBest = bestOf(other);
+          if(maximum < 0 || maximum == otherBest || !std::isinf(peaks[maximum].prominence))
+          {
+            return;
+          }
+          bool equalAndBetter = otherBest >= 0 && data[other] == peaks[maximum].value && better(otherBest, maximum);
+          if(data[other] > peaks[maximum].value || equalAndBetter)
+          {
+            peaks[maximum].prominence = static_cast<double>(peaks[maximum].value) - level;
+            if(equalAndBetter)
             {
-              for(int k=0; k<TInputImage::ImageDimension; k++)
-              {
-                peakIndex[k] = labelObject->GetIndex(0)[k];
-              }
+              peaks[maximum].parent = otherBest;
             }
-            else
+          }
+        };
+        auto join = [&](size_t a, size_t b, double level) {
+          a = findRoot(a);
+          b = findRoot(b);
+          if(a == b)
+          {
+            return;
+          }
+          const int32_t bestA = bestOf(a);
+          const int32_t bestB = bestOf(b);
+          meet(bestA, b, level);
+          meet(bestB, a, level);
+          const int32_t merged = (bestB < 0 || (bestA >= 0 && better(bestA, bestB))) ? bestA : bestB;
+          //the higher root stays the root, on ties the new pixel's component is attached to the existing one
+          if(data[a] > data[b])
+          {
+            std::swap(a, b);
+          }
+          maxima[b] = merged + 1;
+          parent[a] = b;
+        };
+
+        for(size_t n = 0; n < numPixels; n++)
+        {
+          const size_t index = order[n];
+          parent[index] = index;
+          if(maxima[index] > 0)
+          {
+            //plateaus may only be connected through edges / corners, keep them whole
+            size_t anchor = members[memberStart[maxima[index] - 1]];
+            if(anchor != index)
+            {
+              join(anchor, index, static_cast<double>(data[index]));
+            }
+          }
+          size_t count = faceNeighbors(index, adjacent);
+          for(size_t j = 0; j < count; j++)
+          {
+            if(notAdded != parent[adjacent[j]])
+            {
+              join(index, adjacent[j], static_cast<double>(data[index]));
+            }
+          }
+        }
+        return peaks;
+      }
+
+      //peaks for a noise tolerance: maxima more prominent than the tolerance, each combined with the equal valued maxima
+      //that merge into it. this matches Find() except where equal valued plateaus only touch through edges / corners
+      //(Find() only merges the plateaus its own flood reaches, so the result there depends on the visiting order).
+      //the surviving maximum of each peak is optionally returned in representatives
+      typename std::vector<IndexType> static Cut(const std::vector<Peak>& peaks, double noiseTolerance, std::vector<size_t>* representatives = nullptr)
+      {
+        const size_t numObjects = peaks.size();
+        std::vector<double> sums(3 * numObjects, 0.0);
+        std::vector<size_t> counts(numObjects, 0);
+        for(size_t i = 0; i < numObjects; i++)
+        {
+          //follow equal valued merges below the tolerance to the surviving maximum
+          size_t root = i;
+          while(peaks[root].prominence <= noiseTolerance && peaks[root].parent >= 0)
+          {
+            root = static_cast<size_t>(peaks[root].parent);
+          }
+          if(peaks[root].prominence <= noiseTolerance)
+          {
+            continue;
+          }
+          for(size_t k = 0; k < 3; k++)
+          {
+            sums[3 * root + k] += peaks[i].sum[k];
+          }
+          counts[root] += peaks[i].count;
+        }
+
+        std::vector<IndexType> peakLocations;
+        for(size_t i = 0; i < numObjects; i++)
+        {
+          if(peaks[i].prominence > noiseTolerance)
+          {
+            peakLocations.push_back(Centroid(&sums[3 * i], counts[i]));
+            if(nullptr != representatives)
+            {
+              representatives->push_back(i);
+            }
+          }
+        }
+        return peakLocations;
+      }
+
+    private:
+      //pixel indices by descending value, ties in raster order. 8 and 16 bit images are bucketed by value in two passes,
+      //wider types are sorted
+      static std::vector<size_t> DescendingOrder(const PixelType* data, size_t numPixels)
+      {
+        std::vector<size_t> order(numPixels);
+        if(std::numeric_limits<PixelType>::is_integer && sizeof(PixelType) <= 2)
+        {
+          const int64_t lowest = static_cast<int64_t>(std::numeric_limits<PixelType>::lowest());
+          const int64_t highest = static_cast<int64_t>(std::numeric_limits<PixelType>::max());
+          std::vector<size_t> start(static_cast<size_t>(highest - lowest) + 2, 0);
+          for(size_t i = 0; i < numPixels; i++)
+          {
+            start[static_cast<size_t>(highest - static_cast<int64_t>(data[i])) + 1]++;
+          }
+          for(size_t v = 1; v < start.size(); v++)
+          {
+            start[v] += start[v - 1];
+          }
+          for(size_t i = 0; i < numPixels; i++)
+          {
+            order[start[static_cast<size_t>(highest - static_cast<int64_t>(data[i]))]++] = i;
+          }
+          return order;
+        }
+
+        for(size_t i = 0; i < numPixels; i++)
+        {
+          order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [data](size_t lhs, size_t rhs) { return data[lhs] != data[rhs] ? data[lhs] > data[rhs] : lhs < rhs; });
+        return order;
+      }
+
+      //size and buffer of an image (missing dimensions are 1)
+      static const PixelType* Buffer(typename TInputImage::Pointer inputImage, size_t dims[3])
+      {
+        inputImage->Update();
+        typename TInputImage::SizeType size = inputImage->GetLargestPossibleRegion().GetSize();
+        for(unsigned int k = 0; k < TInputImage::ImageDimension && k < 3; k++)
+        {
+          dims[k] = size[k];
+        }
+        return inputImage->GetBufferPointer();
+      }
+
+      //labels regional maxima (-1 for other pixels, maxima are numbered from 1 in raster order of their first pixel),
+      //the pixels of maximum i are members[memberStart[i]] to members[memberStart[i + 1] - 1]
+      static void LabelMaxima(const PixelType* data, const size_t dims[3], bool fullyConnected, std::vector<int32_t>& maxima, std::vector<size_t>& members, std::vector<size_t>& memberStart)
+      {
+        const size_t numPixels = dims[0] * dims[1] * dims[2];
+        const Neighborhood maximaNeighbors(dims, fullyConnected);
+        size_t adjacent[26];
+
+        //-1: has a higher neighbor, 0: candidate, >0: id of the maximum
+        maxima.assign(numPixels, 0);
+        members.clear();
+        memberStart.assign(1, 0);
+        for(size_t i = 0; i < numPixels; i++)
+        {
+          size_t count = maximaNeighbors(i, adjacent);
+          for(size_t j = 0; j < count; j++)
+          {
+            if(data[adjacent[j]] > data[i])
+            {
+              maxima[i] = -1;
+              break;
+            }
+          }
+        }
+
+        for(size_t i = 0; i < numPixels; i++)
+        {
+          if(0 != maxima[i])
+          {
+            continue;
+          }
+          const size_t first = members.size();
+          const int32_t label = static_cast<int32_t>(memberStart.size());
+          bool isMaximum = true;
+          members.push_back(i);
+          maxima[i] = label;
+          for(size_t k = first; k < members.size(); k++)
+          {
+            size_t count = maximaNeighbors(members[k], adjacent);
+            for(size_t j = 0; j < count; j++)
             {
-              typename std::vector<float> avgIndex(TInputImage::ImageDimension, 0);
-              for(int j=0; j<numVoxels; j++)
+              if(data[adjacent[j]] == data[i])
               {
-                for(int k=0; k<TInputImage::ImageDimension; k++)
+                if(0 == maxima[adjacent[j]])
                 {
-                  avgIndex[k] = avgIndex[k] + labelObject->GetIndex(j)[k];
+                  maxima[adjacent[j]] = label;
+                  members.push_back(adjacent[j]);
+                }
+                else if(-1 == maxima[adjacent[j]])
+                {
+                  isMaximum = false;//plateau drains to a higher pixel
                 }
               }
-              for(int k=0; k<TInputImage::ImageDimension; k++)
-              {
-                avgIndex[k] = avgIndex[k] / numVoxels;
-                peakIndex[k] = floor(avgIndex[k]);
-                if(avgIndex[k]-peakIndex[k]>=0.5) peakIndex[k]++;
-              }
             }
-            peakLocations.push_back(peakIndex);
+          }
+
+          if(isMaximum)
+          {
+            memberStart.push_back(members.size());
+          }
+          else
+          {
+            for(size_t k = first; k < members.size(); k++)
+            {
+              maxima[members[k]] = -1;
+            }
+            members.resize(first);
           }
         }
+      }
 
-        return peakLocations;
+      static void AccumulateCoordinates(const size_t dims[3], const std::vector<size_t>& members, size_t begin, size_t end, double sum[3])
+      {
+        for(size_t k = begin; k < end; k++)
+        {
+          sum[0] += static_cast<double>(members[k] % dims[0]);
+          sum[1] += static_cast<double>((members[k] / dims[0]) % dims[1]);
+          sum[2] += static_cast<double>(members[k] / (dims[0] * dims[1]));
+        }
+      }
+
+      //rounded average position
+      static IndexType Centroid(const double sum[3], size_t numVoxels)
+      {
+        IndexType peakIndex;
+        for(unsigned int k = 0; k < TInputImage::ImageDimension; k++)
+        {
+          double avg = k < 3 ? sum[k] / numVoxels : 0.0;
+          peakIndex[k] = static_cast<typename IndexType::IndexValueType>(std::floor(avg));
+          if(avg - std::floor(avg) >= 0.5)
+          {
+            peakIndex[k]++;
+          }
+        }
+        return peakIndex;
       }
   };
 
 
 
+  //priority-flood watershed of an elevation volume. every voxel joins the regional minimum it can be reached from over
+  //the lowest pass (the highest elevation along the path), ties are broken by the number of steps taken at that pass
+  //and then by the lower basin id. basins are numbered by the first voxel of their minimum, so the result is defined
+  //by the volume alone: the volume is split into slabs that are flooded in parallel and improvements are passed across
+  //the slab seams until nothing changes, which gives the same labels as flooding the whole volume at once. basins are
+  //then merged by depth (a basin merges into its neighbor when the saddle between them is no more than 'level' above
+  //the shallower minimum). labels are written straight into the caller's int32 buffer, the flood keeps the pass and the
+  //step count of every voxel next to it
+  template< typename TPixel >
+  class Watershed
+  {
+    public:
+      //adjacency between two basins and the lowest pass (saddle) between them
+      struct Edge
+      {
+        int32_t a;
+        int32_t b;
+        TPixel pass;
+      };
+
+      //join of two basins in the merge tree and the depth at which it happens
+      struct Merge
+      {
+        int32_t a;
+        int32_t b;
+        TPixel depth;
+      };
+
+      Watershed(const TPixel* elevation, const size_t dims[3], int32_t* labels) :
+        m_Elevation(elevation),
+        m_Labels(labels)
+      {
+        for(size_t i = 0; i < 3; i++)
+        {
+          m_Dims[i] = dims[i];
+        }
+        m_NumVoxels = m_Dims[0] * m_Dims[1] * m_Dims[2];
+
+        //slabs are stacked along the slowest varying axis that has more than 1 voxel so each is a contiguous index range.
+        //the partition only depends on the volume size (the labels don't depend on it at all)
+        m_Axis = m_Dims[2] > 1 ? 2 : (m_Dims[1] > 1 ? 1 : 0);
+        m_PlaneSize = 1;
+        for(size_t i = 0; i < m_Axis; i++)
+        {
+          m_PlaneSize *= m_Dims[i];
+        }
+        size_t numPlanes = m_Dims[m_Axis];
+        size_t numSlabs = std::min<size_t>(k_MaxSlabs, m_NumVoxels / k_MinSlabVoxels);
+        numSlabs = std::max<size_t>(1, std::min(numSlabs, numPlanes / 4));//at least 4 planes per slab
+        while((numPlanes + numSlabs - 1) / numSlabs * m_PlaneSize > std::numeric_limits<uint32_t>::max() && numSlabs < numPlanes)
+        {
+          numSlabs++;//slab offsets are stored as 32 bit values
+        }
+        m_SlabPlanes.resize(numSlabs + 1);
+        for(size_t i = 0; i <= numSlabs; i++)
+        {
+          m_SlabPlanes[i] = numPlanes * i / numSlabs;
+        }
+      }
+
+      //floods the volume from its regional minima, leaving basin ids (1 based) in the label buffer and collecting basin
+      //depths and adjacencies
+      void flood()
+      {
+        size_t numSlabs = m_SlabPlanes.size() - 1;
+        ParallelDataAlgorithm slabAlg;
+
+        //regional minima: pieces of candidate plateaus are found per slab and joined across the seams
+        m_SlabPieces.assign(numSlabs, std::vector<Piece>());
+        slabAlg.setRange(0, numSlabs);
+        slabAlg.execute(SlabTask(this, &Watershed::markDrains));
+        slabAlg.execute(SlabTask(this, &Watershed::findPieces));
+        numberMinima();
+        slabAlg.execute(SlabTask(this, &Watershed::labelMinima));
+        m_SlabPieces.clear();
+        m_PieceBasins = std::vector<int32_t>();
+
+        //the pass and step count of every voxel are found first, both only get lower so they settle to the same values
+        //whatever order the slabs are flooded in. each voxel then takes the lowest basin id of the neighbors it is
+        //reached from with that pass and step count (its predecessors, which all have a lower pass or fewer steps)
+        m_Pass.resize(m_NumVoxels);
+        m_Steps.resize(m_NumVoxels);
+        m_SeamSeeds.assign(2 * numSlabs, std::vector<Seed>());
+        settle(&Watershed::floodSlab, &Watershed::exchangeSeam, &Watershed::refloodSlab);
+        settle(&Watershed::spreadSlab, &Watershed::exchangeLabels, &Watershed::respreadSlab);
+        m_SeamSeeds.clear();
+        m_Pass = std::vector<TPixel>();
+        m_Steps = std::vector<uint32_t>();
+
+        //basins that touch are adjacent, the pass between them is the lowest of the higher voxel of each touching pair
+        m_SlabEdges.assign(numSlabs, EdgeMap());
+        slabAlg.setRange(0, numSlabs);
+        slabAlg.execute(SlabTask(this, &Watershed::collectEdges));
+        slabAlg.setRange(0, numSlabs - 1);
+        slabAlg.execute(SlabTask(this, &Watershed::stitchSeam));
+
+        EdgeMap allEdges;
+        for(size_t i = 0; i < numSlabs; i++)
+        {
+          for(typename EdgeMap::const_iterator iter = m_SlabEdges[i].begin(); iter != m_SlabEdges[i].end(); ++iter)
+          {
+            insertEdge(allEdges, iter->first, iter->second);
+          }
+          m_SlabEdges[i].clear();
+        }
+        m_Edges.clear();
+        m_Edges.reserve(allEdges.size());
+        for(typename EdgeMap::const_iterator iter = allEdges.begin(); iter != allEdges.end(); ++iter)
+        {
+          Edge edge = {static_cast<int32_t>(iter->first >> 32), static_cast<int32_t>(iter->first & 0xFFFFFFFF), iter->second};
+          m_Edges.push_back(edge);
+        }
+        std::sort(m_Edges.begin(), m_Edges.end(), [](const Edge& lhs, const Edge& rhs) { return lhs.a != rhs.a ? lhs.a < rhs.a : lhs.b < rhs.b; });
+      }
+
+      //merge tree over all levels: basins are joined by increasing saddle height and each join records how deep the
+      //shallower region is below the saddle, cutting the tree at a level gives the same regions as merging at that level
+      std::vector<Merge> mergeTree() const
+      {
+        //edges are sorted by (a, b), equal saddles keep that order
+        std::vector<Edge> edges = m_Edges;
+        std::stable_sort(edges.begin(), edges.end(), [](const Edge& lhs, const Edge& rhs) { return lhs.pass < rhs.pass; });
+
+        size_t numBasins = m_BasinMinima.size();
+        std::vector<int32_t> parent(numBasins + 1);
+        std::vector<TPixel> depth(numBasins + 1);
+        for(size_t i = 1; i <= numBasins; i++)
+        {
+          parent[i] = static_cast<int32_t>(i);
+          depth[i] = m_BasinMinima[i - 1];
+        }
+
+        std::vector<Merge> tree;
+        tree.reserve(numBasins > 0 ? numBasins - 1 : 0);
+        for(size_t i = 0; i < edges.size(); i++)
+        {
+          int32_t rootA = findRoot(parent, edges[i].a);
+          int32_t rootB = findRoot(parent, edges[i].b);
+          if(rootA == rootB)
+          {
+            continue;
+          }
+
+          //edges are visited in increasing pass order, so this is the saddle between the two regions
+          Merge merge = {edges[i].a, edges[i].b, static_cast<TPixel>(edges[i].pass - std::max(depth[rootA], depth[rootB]))};
+          tree.push_back(merge);
+          parent[rootB] = rootA;
+          depth[rootA] = std::min(depth[rootA], depth[rootB]);
+        }
+        return tree;
+      }
+
+      //features of a merge tree cut at level: the feature of each basin (index 0 is unused, features are numbered
+      //consecutively from 1)
+      static std::vector<int32_t> Cut(const std::vector<Merge>& tree, size_t numBasins, TPixel level)
+      {
+        std::vector<int32_t> parent(numBasins + 1);
+        for(size_t i = 0; i <= numBasins; i++)
+        {
+          parent[i] = static_cast<int32_t>(i);
+        }
+        for(size_t i = 0; i < tree.size(); i++)
+        {
+          if(tree[i].depth <= level)
+          {
+            parent[findRoot(parent, tree[i].b)] = findRoot(parent, tree[i].a);
+          }
+        }
+
+        std::vector<int32_t> features(numBasins + 1, 0);
+        int32_t numFeatures = 0;
+        for(size_t i = 1; i <= numBasins; i++)
+        {
+          int32_t root = findRoot(parent, static_cast<int32_t>(i));
+          if(0 == features[root])
+          {
+            features[root] = ++numFeatures;
+          }
+          features[i] = features[root];
+        }
+        return features;
+      }
+
+      //merges basins whose depth below the saddle to a neighbor is no more than level, returns the feature of each basin
+      std::vector<int32_t> merge(TPixel level) const
+      {
+        return Cut(mergeTree(), m_BasinMinima.size(), level);
+      }
+
+      //replaces each basin id in labels with its feature id
+      static void Relabel(int32_t* labels, size_t numVoxels, const std::vector<int32_t>& features)
+      {
+        ParallelDataAlgorithm dataAlg;
+        dataAlg.setRange(0, numVoxels);
+        dataAlg.execute(RelabelImpl(labels, features.data()));
+      }
+
+      //floods the volume, merges basins and writes the feature ids, returns the number of features
+      int32_t segment(TPixel level)
+      {
+        flood();
+        std::vector<int32_t> features = merge(level);
+        Relabel(m_Labels, m_NumVoxels, features);
+        return *std::max_element(features.begin(), features.end());
+      }
+
+      size_t getNumberOfBasins() const
+      {
+        return m_BasinMinima.size();
+      }
+
+      //minimum elevation of each basin (basin i is at index i - 1)
+      const std::vector<TPixel>& getBasinMinima() const
+      {
+        return m_BasinMinima;
+      }
+
+      //adjacent basins (a < b) sorted by a and then b
+      const std::vector<Edge>& getEdges() const
+      {
+        return m_Edges;
+      }
+
+    private:
+      typedef std::unordered_map<uint64_t, TPixel> EdgeMap;
+
+      //slabs hold at least this many voxels, and there are no more than k_MaxSlabs of them
+      static const size_t k_MinSlabVoxels = 1 << 18;
+      static const size_t k_MaxSlabs = 256;
+
+      //connected part of a candidate plateau inside one slab: its first voxel and whether it touches a draining voxel
+      struct Piece
+      {
+        size_t first;
+        bool drains;
+      };
+
+      //improvement of a voxel found across a seam
+      struct Seed
+      {
+        size_t index;
+        TPixel pass;
+        uint32_t steps;
+        int32_t label;
+      };
+
+      struct QueueEntry
+      {
+        TPixel pass;
+        uint32_t steps;
+        int32_t label;
+        uint32_t offset;
+        bool operator<(const QueueEntry& other) const
+        {
+          //std::priority_queue pops the largest entry: lowest pass, fewest steps and lowest label first
+          if(pass != other.pass)
+          {
+            return pass > other.pass;
+          }
+          if(steps != other.steps)
+          {
+            return steps > other.steps;
+          }
+          return label != other.label ? label > other.label : offset > other.offset;
+        }
+      };
+
+      //runs a member function for each slab (or seam) in a range
+      class SlabTask
+      {
+        public:
+          SlabTask(Watershed* watershed, void (Watershed::*task)(size_t)) : m_Watershed(watershed), m_Task(task) {}
+          void operator()(const SIMPLRange& range) const
+          {
+            for(size_t i = range.min(); i < range.max(); i++)
+            {
+              (m_Watershed->*m_Task)(i);
+            }
+          }
+        private:
+          Watershed* m_Watershed;
+          void (Watershed::*m_Task)(size_t);
+      };
+
+      class RelabelImpl
+      {
+        public:
+          RelabelImpl(int32_t* labels, const int32_t* features) : m_Labels(labels), m_Features(features) {}
+          void operator()(const SIMPLRange& range) const
+          {
+            for(size_t i = range.min(); i < range.max(); i++)
+            {
+              m_Labels[i] = m_Features[m_Labels[i]];
+            }
+          }
+        private:
+          int32_t* m_Labels;
+          const int32_t* m_Features;
+      };
+
+      static int32_t findRoot(std::vector<int32_t>& parent, int32_t i)
+      {
+        while(parent[i] != i)
+        {
+          parent[i] = parent[parent[i]];
+          i = parent[i];
+        }
+        return i;
+      }
+
+      static size_t findRoot(std::vector<size_t>& parent, size_t i)
+      {
+        while(parent[i] != i)
+        {
+          parent[i] = parent[parent[i]];
+          i = parent[i];
+        }
+        return i;
+      }
+
+      static void insertEdge(EdgeMap& edges, uint64_t key, TPixel pass)
+      {
+        std::pair<typename EdgeMap::iterator, bool> result = edges.insert(std::make_pair(key, pass));
+        if(!result.second && pass < result.first->second)
+        {
+          result.first->second = pass;
+        }
+      }
+
+      static void insertEdge(EdgeMap& edges, int32_t a, int32_t b, TPixel pass)
+      {
+        if(a > b)
+        {
+          std::swap(a, b);
+        }
+        insertEdge(edges, (static_cast<uint64_t>(a) << 32) | static_cast<uint64_t>(b), pass);
+      }
+
+      //collects the face neighbors of index that lie inside [begin, end)
+      size_t neighbors(size_t index, size_t begin, size_t end, size_t* adjacent) const
+      {
+        size_t count = 0;
+        size_t x = index % m_Dims[0];
+        size_t y = (index / m_Dims[0]) % m_Dims[1];
+        size_t sliceSize = m_Dims[0] * m_Dims[1];
+        if(x > 0) { adjacent[count++] = index - 1; }
+        if(x + 1 < m_Dims[0]) { adjacent[count++] = index + 1; }
+        if(y > 0) { adjacent[count++] = index - m_Dims[0]; }
+        if(y + 1 < m_Dims[1]) { adjacent[count++] = index + m_Dims[0]; }
+        if(index >= begin + sliceSize) { adjacent[count++] = index - sliceSize; }
+        if(index + sliceSize < end) { adjacent[count++] = index + sliceSize; }
+
+        //drop neighbors outside of the slab (only possible along the slab axis)
+        size_t kept = 0;
+        for(size_t i = 0; i < count; i++)
+        {
+          if(adjacent[i] >= begin && adjacent[i] < end)
+          {
+            adjacent[kept++] = adjacent[i];
+          }
+        }
+        return kept;
+      }
+
+      //true if reaching index with a pass and step count beats what it holds, unreached voxels are labeled -1
+      bool improves(size_t index, TPixel pass, uint32_t steps) const
+      {
+        if(m_Labels[index] < 0)
+        {
+          return true;
+        }
+        return pass != m_Pass[index] ? pass < m_Pass[index] : steps < m_Steps[index];
+      }
+
+      //pass and step count of a step from a reached voxel to one of its neighbors
+      void step(size_t from, size_t to, TPixel& pass, uint32_t& steps) const
+      {
+        if(m_Elevation[to] > m_Pass[from])
+        {
+          pass = m_Elevation[to];
+          steps = 0;
+        }
+        else
+        {
+          pass = m_Pass[from];
+          steps = m_Steps[from] + 1;
+        }
+      }
+
+      //-1: drains to a lower neighbor (in any slab), 0: candidate minimum
+      void markDrains(size_t slab)
+      {
+        const size_t begin = m_SlabPlanes[slab] * m_PlaneSize;
+        const size_t end = m_SlabPlanes[slab + 1] * m_PlaneSize;
+        size_t adjacent[6];
+        for(size_t i = begin; i < end; i++)
+        {
+          m_Labels[i] = 0;
+          size_t count = neighbors(i, 0, m_NumVoxels, adjacent);
+          for(size_t j = 0; j < count; j++)
+          {
+            if(m_Elevation[adjacent[j]] < m_Elevation[i])
+            {
+              m_Labels[i] = -1;
+              break;
+            }
+          }
+        }
+      }
+
+      //labels every piece of a candidate plateau inside the slab with -2 - its index in the slab. a piece touching an equal
+      //valued voxel that drains is not part of a minimum (pieces are joined across the seams later)
+      void findPieces(size_t slab)
+      {
+        const size_t begin = m_SlabPlanes[slab] * m_PlaneSize;
+        const size_t end = m_SlabPlanes[slab + 1] * m_PlaneSize;
+        size_t adjacent[6];
+        std::vector<Piece>& pieces = m_SlabPieces[slab];
+        std::vector<uint32_t> plateau;
+        for(size_t i = begin; i < end; i++)
+        {
+          if(0 != m_Labels[i])
+          {
+            continue;
+          }
+          TPixel value = m_Elevation[i];
+          const int32_t marker = -2 - static_cast<int32_t>(pieces.size());
+          Piece piece = {i, false};
+          plateau.clear();
+          plateau.push_back(static_cast<uint32_t>(i - begin));
+          m_Labels[i] = marker;
+          for(size_t k = 0; k < plateau.size(); k++)
+          {
+            size_t count = neighbors(begin + plateau[k], begin, end, adjacent);
+            for(size_t j = 0; j < count; j++)
+            {
+              if(m_Elevation[adjacent[j]] == value)
+              {
+                if(0 == m_Labels[adjacent[j]])
+                {
+                  m_Labels[adjacent[j]] = marker;
+                  plateau.push_back(static_cast<uint32_t>(adjacent[j] - begin));
+                }
+                else if(-1 == m_Labels[adjacent[j]])
+                {
+                  piece.drains = true;
+                }
+              }
+            }
+          }
+          pieces.push_back(piece);
+        }
+      }
+
+      //joins the pieces that touch across the seams, a plateau is a minimum if none of its pieces drains. minima are
+      //numbered in the order of their first voxel
+      void numberMinima()
+      {
+        size_t numSlabs = m_SlabPlanes.size() - 1;
+        m_PieceOffsets.assign(numSlabs + 1, 0);
+        for(size_t i = 0; i < numSlabs; i++)
+        {
+          m_PieceOffsets[i + 1] = m_PieceOffsets[i] + m_SlabPieces[i].size();
+        }
+        std::vector<size_t> parent(m_PieceOffsets[numSlabs]);
+        std::vector<uint8_t> drains(parent.size());
+        for(size_t i = 0; i < numSlabs; i++)
+        {
+          for(size_t p = 0; p < m_SlabPieces[i].size(); p++)
+          {
+            parent[m_PieceOffsets[i] + p] = m_PieceOffsets[i] + p;
+            drains[m_PieceOffsets[i] + p] = m_SlabPieces[i][p].drains ? 1 : 0;
+          }
+        }
+
+        for(size_t slab = 0; slab + 1 < numSlabs; slab++)
+        {
+          const size_t seam = m_SlabPlanes[slab + 1] * m_PlaneSize;
+          for(size_t i = seam - m_PlaneSize; i < seam; i++)
+          {
+            size_t j = i + m_PlaneSize;
+            if(m_Elevation[i] != m_Elevation[j] || (m_Labels[i] >= -1 && m_Labels[j] >= -1))
+            {
+              continue;
+            }
+            if(m_Labels[i] == -1)
+            {
+              drains[m_PieceOffsets[slab + 1] + static_cast<size_t>(-2 - m_Labels[j])] = 1;
+            }
+            else if(m_Labels[j] == -1)
+            {
+              drains[m_PieceOffsets[slab] + static_cast<size_t>(-2 - m_Labels[i])] = 1;
+            }
+            else
+            {
+              //the piece with the first voxel (the lower index) stays the root
+              size_t rootA = findRoot(parent, m_PieceOffsets[slab] + static_cast<size_t>(-2 - m_Labels[i]));
+              size_t rootB = findRoot(parent, m_PieceOffsets[slab + 1] + static_cast<size_t>(-2 - m_Labels[j]));
+              if(rootA != rootB)
+              {
+                parent[std::max(rootA, rootB)] = std::min(rootA, rootB);
+              }
+            }
+          }
+        }
+
+        for(size_t p = 0; p < parent.size(); p++)
+        {
+          size_t root = findRoot(parent, p);
+          drains[root] = drains[root] | drains[p];
+        }
+
+        //pieces are in the order of their first voxel, so a plateau's root comes before the rest of it
+        m_BasinMinima.clear();
+        m_PieceBasins.assign(parent.size(), -1);
+        size_t slab = 0;
+        for(size_t p = 0; p < parent.size(); p++)
+        {
+          while(p >= m_PieceOffsets[slab + 1])
+          {
+            slab++;
+          }
+          size_t root = findRoot(parent, p);
+          if(0 != drains[root])
+          {
+            continue;
+          }
+          if(root == p)
+          {
+            m_BasinMinima.push_back(m_Elevation[m_SlabPieces[slab][p - m_PieceOffsets[slab]].first]);
+            m_PieceBasins[p] = static_cast<int32_t>(m_BasinMinima.size());
+          }
+          else
+          {
+            m_PieceBasins[p] = m_PieceBasins[root];
+          }
+        }
+      }
+
+      //replaces the piece markers with basin ids (-1 for plateaus that drain)
+      void labelMinima(size_t slab)
+      {
+        const size_t begin = m_SlabPlanes[slab] * m_PlaneSize;
+        const size_t end = m_SlabPlanes[slab + 1] * m_PlaneSize;
+        const size_t offset = m_PieceOffsets[slab];
+        for(size_t i = begin; i < end; i++)
+        {
+          if(m_Labels[i] <= -2)
+          {
+            m_Labels[i] = m_PieceBasins[offset + static_cast<size_t>(-2 - m_Labels[i])];
+          }
+        }
+      }
+
+      //floods every slab with a task, then passes the improvements across the seams until there are none left
+      void settle(void (Watershed::*flood)(size_t), void (Watershed::*exchange)(size_t), void (Watershed::*reflood)(size_t))
+      {
+        size_t numSlabs = m_SlabPlanes.size() - 1;
+        ParallelDataAlgorithm slabAlg;
+        slabAlg.setRange(0, numSlabs);
+        slabAlg.execute(SlabTask(this, flood));
+        while(numSlabs > 1)
+        {
+          slabAlg.setRange(0, numSlabs - 1);
+          slabAlg.execute(SlabTask(this, exchange));
+          bool settled = true;
+          for(size_t i = 0; i < m_SeamSeeds.size() && settled; i++)
+          {
+            settled = m_SeamSeeds[i].empty();
+          }
+          if(settled)
+          {
+            break;
+          }
+          slabAlg.setRange(0, numSlabs);
+          slabAlg.execute(SlabTask(this, reflood));
+        }
+      }
+
+      //pops the queue until it is empty, lowering the pass and step count of every voxel of the slab a popped voxel
+      //improves (reached voxels that are not part of a minimum are labeled 0)
+      void run(size_t begin, size_t end, std::priority_queue<QueueEntry>& queue)
+      {
+        size_t adjacent[6];
+        while(!queue.empty())
+        {
+          QueueEntry top = queue.top();
+          queue.pop();
+          size_t index = begin + top.offset;
+          if(top.pass != m_Pass[index] || top.steps != m_Steps[index])
+          {
+            continue;//improved since it was queued
+          }
+          size_t count = neighbors(index, begin, end, adjacent);
+          for(size_t j = 0; j < count; j++)
+          {
+            TPixel pass;
+            uint32_t steps;
+            step(index, adjacent[j], pass, steps);
+            if(improves(adjacent[j], pass, steps))
+            {
+              m_Labels[adjacent[j]] = 0;
+              m_Pass[adjacent[j]] = pass;
+              m_Steps[adjacent[j]] = steps;
+              QueueEntry entry = {pass, steps, 0, static_cast<uint32_t>(adjacent[j] - begin)};
+              queue.push(entry);
+            }
+          }
+        }
+      }
+
+      //floods the slab from the minima inside it. only the rim of a minimum (voxels with an unreached neighbor) is
+      //queued, its interior could not improve anything, so a volume that is mostly one flat minimum keeps the queue small
+      void floodSlab(size_t slab)
+      {
+        const size_t begin = m_SlabPlanes[slab] * m_PlaneSize;
+        const size_t end = m_SlabPlanes[slab + 1] * m_PlaneSize;
+        size_t adjacent[6];
+        for(size_t i = begin; i < end; i++)
+        {
+          if(m_Labels[i] > 0)
+          {
+            m_Pass[i] = m_Elevation[i];
+            m_Steps[i] = 0;
+          }
+        }
+
+        std::priority_queue<QueueEntry> queue;
+        for(size_t i = begin; i < end; i++)
+        {
+          if(m_Labels[i] <= 0)
+          {
+            continue;
+          }
+          size_t count = neighbors(i, begin, end, adjacent);
+          for(size_t j = 0; j < count; j++)
+          {
+            if(m_Labels[adjacent[j]] < 0)
+            {
+              QueueEntry entry = {m_Pass[i], 0, 0, static_cast<uint32_t>(i - begin)};
+              queue.push(entry);
+              break;
+            }
+          }
+        }
+        run(begin, end, queue);
+      }
+
+      //collects the improvements the two planes of a seam offer each other, the seeds of slab s are at 2 * s (from the
+      //seam below it) and 2 * s + 1 (from the seam above it)
+      void exchangeSeam(size_t slab)
+      {
+        const size_t seam = m_SlabPlanes[slab + 1] * m_PlaneSize;
+        std::vector<Seed>& upper = m_SeamSeeds[2 * slab + 2];
+        std::vector<Seed>& lower = m_SeamSeeds[2 * slab + 1];
+        upper.clear();
+        lower.clear();
+        for(size_t i = seam - m_PlaneSize; i < seam; i++)
+        {
+          size_t j = i + m_PlaneSize;
+          Seed seed = {0, 0, 0, 0};
+          if(m_Labels[i] >= 0)
+          {
+            step(i, j, seed.pass, seed.steps);
+            if(improves(j, seed.pass, seed.steps))
+            {
+              seed.index = j;
+              upper.push_back(seed);
+            }
+          }
+          if(m_Labels[j] >= 0)
+          {
+            step(j, i, seed.pass, seed.steps);
+            if(improves(i, seed.pass, seed.steps))
+            {
+              seed.index = i;
+              lower.push_back(seed);
+            }
+          }
+        }
+      }
+
+      //applies the seeds of both seams of the slab and floods on from them
+      void refloodSlab(size_t slab)
+      {
+        const size_t begin = m_SlabPlanes[slab] * m_PlaneSize;
+        const size_t end = m_SlabPlanes[slab + 1] * m_PlaneSize;
+        std::priority_queue<QueueEntry> queue;
+        for(size_t side = 0; side < 2; side++)
+        {
+          std::vector<Seed>& seeds = m_SeamSeeds[2 * slab + side];
+          for(size_t i = 0; i < seeds.size(); i++)
+          {
+            const Seed& seed = seeds[i];
+            if(improves(seed.index, seed.pass, seed.steps))
+            {
+              m_Labels[seed.index] = 0;
+              m_Pass[seed.index] = seed.pass;
+              m_Steps[seed.index] = seed.steps;
+              QueueEntry entry = {seed.pass, seed.steps, 0, static_cast<uint32_t>(seed.index - begin)};
+              queue.push(entry);
+            }
+          }
+          seeds.clear();
+        }
+        run(begin, end, queue);
+      }
+
+      //true if from is a predecessor of to: stepping from it gives the pass and step count to settled on
+      bool precedes(size_t from, size_t to) const
+      {
+        TPixel pass;
+        uint32_t steps;
+        step(from, to, pass, steps);
+        return pass == m_Pass[to] && steps == m_Steps[to];
+      }
+
+      //pops the queue until it is empty, handing the label of every popped voxel to the successors in the slab that hold
+      //a higher one. voxels are popped in order of their pass and step count, so all predecessors of a voxel are
+      //popped before it
+      void runLabels(size_t begin, size_t end, std::priority_queue<QueueEntry>& queue)
+      {
+        size_t adjacent[6];
+        while(!queue.empty())
+        {
+          QueueEntry top = queue.top();
+          queue.pop();
+          size_t index = begin + top.offset;
+          if(top.label != m_Labels[index])
+          {
+            continue;//lowered since it was queued
+          }
+          size_t count = neighbors(index, begin, end, adjacent);
+          for(size_t j = 0; j < count; j++)
+          {
+            if(m_Labels[adjacent[j]] > top.label && precedes(index, adjacent[j]))
+            {
+              m_Labels[adjacent[j]] = top.label;
+              QueueEntry entry = {m_Pass[adjacent[j]], m_Steps[adjacent[j]], top.label, static_cast<uint32_t>(adjacent[j] - begin)};
+              queue.push(entry);
+            }
+          }
+        }
+      }
+
+      //spreads the basin ids of the minima through the slab
+      void spreadSlab(size_t slab)
+      {
+        const size_t begin = m_SlabPlanes[slab] * m_PlaneSize;
+        const size_t end = m_SlabPlanes[slab + 1] * m_PlaneSize;
+        size_t adjacent[6];
+        for(size_t i = begin; i < end; i++)
+        {
+          if(0 == m_Labels[i])
+          {
+            m_Labels[i] = std::numeric_limits<int32_t>::max();
+          }
+        }
+
+        std::priority_queue<QueueEntry> queue;
+        for(size_t i = begin; i < end; i++)
+        {
+          if(std::numeric_limits<int32_t>::max() == m_Labels[i])
+          {
+            continue;
+          }
+          size_t count = neighbors(i, begin, end, adjacent);
+          for(size_t j = 0; j < count; j++)
+          {
+            if(std::numeric_limits<int32_t>::max() == m_Labels[adjacent[j]])
+            {
+              QueueEntry entry = {m_Pass[i], 0, m_Labels[i], static_cast<uint32_t>(i - begin)};
+              queue.push(entry);
+              break;
+            }
+          }
+        }
+        runLabels(begin, end, queue);
+      }
+
+      //collects the lower labels the two planes of a seam hand each other
+      void exchangeLabels(size_t slab)
+      {
+        const size_t seam = m_SlabPlanes[slab + 1] * m_PlaneSize;
+        std::vector<Seed>& upper = m_SeamSeeds[2 * slab + 2];
+        std::vector<Seed>& lower = m_SeamSeeds[2 * slab + 1];
+        upper.clear();
+        lower.clear();
+        for(size_t i = seam - m_PlaneSize; i < seam; i++)
+        {
+          size_t j = i + m_PlaneSize;
+          if(m_Labels[i] < m_Labels[j] && precedes(i, j))
+          {
+            Seed seed = {j, m_Pass[j], m_Steps[j], m_Labels[i]};
+            upper.push_back(seed);
+          }
+          else if(m_Labels[j] < m_Labels[i] && precedes(j, i))
+          {
+            Seed seed = {i, m_Pass[i], m_Steps[i], m_Labels[j]};
+            lower.push_back(seed);
+          }
+        }
+      }
+
+      //applies the labels handed over both seams of the slab and spreads them on
+      void respreadSlab(size_t slab)
+      {
+        const size_t begin = m_SlabPlanes[slab] * m_PlaneSize;
+        const size_t end = m_SlabPlanes[slab + 1] * m_PlaneSize;
+        std::priority_queue<QueueEntry> queue;
+        for(size_t side = 0; side < 2; side++)
+        {
+          std::vector<Seed>& seeds = m_SeamSeeds[2 * slab + side];
+          for(size_t i = 0; i < seeds.size(); i++)
+          {
+            const Seed& seed = seeds[i];
+            if(seed.label < m_Labels[seed.index])
+            {
+              m_Labels[seed.index] = seed.label;
+              QueueEntry entry = {seed.pass, seed.steps, seed.label, static_cast<uint32_t>(seed.index - begin)};
+              queue.push(entry);
+            }
+          }
+          seeds.clear();
+        }
+        runLabels(begin, end, queue);
+      }
+
+      //records the adjacencies between the basins inside the slab
+      void collectEdges(size_t slab)
+      {
+        const size_t begin = m_SlabPlanes[slab] * m_PlaneSize;
+        const size_t end = m_SlabPlanes[slab + 1] * m_PlaneSize;
+        size_t adjacent[6];
+        EdgeMap& edges = m_SlabEdges[slab];
+        for(size_t i = begin; i < end; i++)
+        {
+          size_t count = neighbors(i, begin, end, adjacent);
+          for(size_t j = 0; j < count; j++)
+          {
+            if(adjacent[j] > i && m_Labels[adjacent[j]] != m_Labels[i])
+            {
+              insertEdge(edges, m_Labels[i], m_Labels[adjacent[j]], std::max(m_Elevation[i], m_Elevation[adjacent[j]]));
+            }
+          }
+        }
+      }
+
+      //records the adjacencies between the last plane of a slab and the first plane of the next one
+      void stitchSeam(size_t slab)
+      {
+        const size_t seam = m_SlabPlanes[slab + 1] * m_PlaneSize;
+        EdgeMap& edges = m_SlabEdges[slab];
+        for(size_t i = seam - m_PlaneSize; i < seam; i++)
+        {
+          size_t j = i + m_PlaneSize;
+          if(m_Labels[i] != m_Labels[j])
+          {
+            insertEdge(edges, m_Labels[i], m_Labels[j], std::max(m_Elevation[i], m_Elevation[j]));
+          }
+        }
+      }
+
+      const TPixel* m_Elevation;
+      int32_t* m_Labels;
+      size_t m_Dims[3];
+      size_t m_NumVoxels;
+      size_t m_Axis;
+      size_t m_PlaneSize;
+      std::vector<size_t> m_SlabPlanes;
+      std::vector<std::vector<Piece>> m_SlabPieces;
+      std::vector<size_t> m_PieceOffsets;
+      std::vector<int32_t> m_PieceBasins;
+      std::vector<TPixel> m_Pass;
+      std::vector<uint32_t> m_Steps;
+      std::vector<std::vector<Seed>> m_SeamSeeds;
+      std::vector<EdgeMap> m_SlabEdges;
+      std::vector<TPixel> m_BasinMinima;
+      std::vector<Edge> m_Edges;
+  };
+
+
+  //seeded watershed that splits the objects of a binary image along the valleys of their distance map. this is the fused
+  //form of signed maurer distance map -> invert -> watershed from markers -> mask: the distance map is computed once
+  //into the caller's buffer, the flood pops the highest distance first (instead of the lowest inverted distance) and
+  //only visits foreground voxels, writing labels straight into the caller's output
+  class BinaryWatershed
+  {
+    public:
+      BinaryWatershed(const bool* mask, const size_t dims[3], const float spacing[3]) :
+        m_Mask(mask)
+      {
+        for(size_t i = 0; i < 3; i++)
+        {
+          m_Dims[i] = dims[i];
+          m_Spacing[i] = spacing[i];
+        }
+        m_NumVoxels = m_Dims[0] * m_Dims[1] * m_Dims[2];
+      }
+
+      //euclidean distance (in physical units) from each foreground voxel to the nearest contour voxel (a foreground voxel
+      //with a background face neighbor). background voxels are set to the lowest float so that no noise tolerance lets
+      //a peak search flood from one object into another
+      void distanceMap(float* distance) const
+      {
+        ParallelDataAlgorithm dataAlg;
+        dataAlg.setRange(0, m_NumVoxels);
+        dataAlg.execute(ContourImpl(this, distance));
+
+        //exact squared distance transform, one axis at a time
+        for(size_t axis = 0; axis < 3; axis++)
+        {
+          if(m_Dims[axis] > 1)
+          {
+            dataAlg.setRange(0, m_NumVoxels / m_Dims[axis]);
+            dataAlg.execute(LineImpl(this, distance, axis));
+          }
+        }
+
+        dataAlg.setRange(0, m_NumVoxels);
+        dataAlg.execute(FinishImpl(this, distance));
+      }
+
+      //grows the seeds in labels (0 everywhere else) through the face connected foreground, highest distance first,
+      //voxels that are reached from a higher level are flooded at that level. background voxels are left untouched
+      void flood(const float* distance, uint32_t* labels) const
+      {
+        std::priority_queue<QueueEntry> queue;
+        uint64_t order = 0;
+        for(size_t i = 0; i < m_NumVoxels; i++)
+        {
+          if(0 != labels[i] && m_Mask[i])
+          {
+            queue.push({distance[i], order++, i});
+          }
+        }
+
+        Neighborhood faces(m_Dims, false);
+        size_t neighbors[26];
+        while(!queue.empty())
+        {
+          QueueEntry entry = queue.top();
+          queue.pop();
+          const uint32_t label = labels[entry.index];
+          const size_t numNeighbors = faces(entry.index, neighbors);
+          for(size_t j = 0; j < numNeighbors; j++)
+          {
+            const size_t neighbor = neighbors[j];
+            if(m_Mask[neighbor] && 0 == labels[neighbor])
+            {
+              labels[neighbor] = label;
+              queue.push({std::min(distance[neighbor], entry.value), order++, neighbor});
+            }
+          }
+        }
+      }
+
+      //tile parallel version of distanceMap() + peak search + flood: the volume is split into blocks of blockSize voxels
+      //per side that are segmented independently (and in parallel), each padded by 'halo' voxels on every side so the
+      //distance map and basins near its faces see the neighboring objects. every block writes only its own core voxels;
+      //a seed that a block found in its halo is then joined (union-find) to the basin that holds that voxel in the block
+      //owning it, which makes basins that cross a seam agree. the halo should be about the radius of the largest object.
+      //returns the number of labels
+      uint32_t floodBlocks(float noiseTolerance, size_t blockSize, size_t halo, uint32_t* labels)
+      {
+        size_t numBlocks = 1;
+        for(size_t i = 0; i < 3; i++)
+        {
+          m_Blocks[i] = (m_Dims[i] + blockSize - 1) / blockSize;
+          numBlocks *= m_Blocks[i];
+        }
+        m_BlockSize = blockSize;
+        m_Halo = halo;
+
+        //segment blocks, block local labels are written to the core voxels
+        std::vector<std::vector<size_t>> seeds(numBlocks);
+        ParallelDataAlgorithm blockAlg;
+        blockAlg.setRange(0, numBlocks);
+        blockAlg.execute(BlockImpl(this, noiseTolerance, labels, seeds.data(), nullptr));
+
+        //make labels unique across blocks
+        std::vector<uint32_t> offsets(numBlocks, 0);
+        for(size_t i = 1; i < numBlocks; i++)
+        {
+          offsets[i] = offsets[i - 1] + static_cast<uint32_t>(seeds[i - 1].size());
+        }
+        const uint32_t numSeeds = numBlocks > 0 ? offsets.back() + static_cast<uint32_t>(seeds.back().size()) : 0;
+        blockAlg.execute(BlockImpl(this, noiseTolerance, labels, seeds.data(), offsets.data()));
+
+        //join halo seeds to the basin holding them in their own block
+        std::vector<uint32_t> parent(numSeeds + 1);
+        for(uint32_t i = 0; i <= numSeeds; i++)
+        {
+          parent[i] = i;
+        }
+        for(size_t b = 0; b < numBlocks; b++)
+        {
+          size_t coreStart[3];
+          size_t coreEnd[3];
+          blockBounds(b, 0, coreStart, coreEnd);
+          for(size_t j = 0; j < seeds[b].size(); j++)
+          {
+            const size_t index = seeds[b][j];
+            const size_t coords[3] = {index % m_Dims[0], (index / m_Dims[0]) % m_Dims[1], index / (m_Dims[0] * m_Dims[1])};
+            bool core = true;
+            for(size_t d = 0; d < 3; d++)
+            {
+              core = core && coords[d] >= coreStart[d] && coords[d] < coreEnd[d];
+            }
+            if(!core && 0 != labels[index])
+            {
+              uint32_t a = findRoot(parent, offsets[b] + static_cast<uint32_t>(j) + 1);
+              uint32_t c = findRoot(parent, labels[index]);
+              parent[std::max(a, c)] = std::min(a, c);
+            }
+          }
+        }
+
+        //consecutive ids in order of the lowest seed of each basin
+        std::vector<uint32_t> features(numSeeds + 1, 0);
+        uint32_t numFeatures = 0;
+        for(uint32_t i = 1; i <= numSeeds; i++)
+        {
+          uint32_t root = findRoot(parent, i);
+          features[i] = root == i ? ++numFeatures : features[root];
+        }
+        ParallelDataAlgorithm dataAlg;
+        dataAlg.setRange(0, m_NumVoxels);
+        dataAlg.execute(RelabelImpl(labels, features.data()));
+        return numFeatures;
+      }
+
+    private:
+      struct QueueEntry
+      {
+        float value;
+        uint64_t order;
+        size_t index;
+        bool operator<(const QueueEntry& other) const
+        {
+          //std::priority_queue pops the largest entry: highest distance first, first in first out on plateaus
+          return value != other.value ? value < other.value : order > other.order;
+        }
+      };
+
+      //squared distance markers: 0 on the contour, 'infinite' everywhere else
+      class ContourImpl
+      {
+        public:
+          ContourImpl(const BinaryWatershed* watershed, float* distance) : m_Watershed(watershed), m_Distance(distance) {}
+          void operator()(const SIMPLRange& range) const
+          {
+            Neighborhood faces(m_Watershed->m_Dims, false);
+            size_t neighbors[26];
+            for(size_t i = range.min(); i < range.max(); i++)
+            {
+              bool contour = false;
+              if(m_Watershed->m_Mask[i])
+              {
+                const size_t numNeighbors = faces(i, neighbors);
+                for(size_t j = 0; j < numNeighbors && !contour; j++)
+                {
+                  contour = !m_Watershed->m_Mask[neighbors[j]];
+                }
+              }
+              m_Distance[i] = contour ? 0.0f : std::numeric_limits<float>::max();
+            }
+          }
+        private:
+          const BinaryWatershed* m_Watershed;
+          float* m_Distance;
+      };
+
+      //1D squared distance transform (lower envelope of parabolas, Felzenszwalb & Huttenlocher) of a range of lines along an axis
+      class LineImpl
+      {
+        public:
+          LineImpl(const BinaryWatershed* watershed, float* distance, size_t axis) : m_Watershed(watershed), m_Distance(distance), m_Axis(axis) {}
+          void operator()(const SIMPLRange& range) const
+          {
+            const size_t* dims = m_Watershed->m_Dims;
+            const size_t length = dims[m_Axis];
+            const size_t stride = 0 == m_Axis ? 1 : (1 == m_Axis ? dims[0] : dims[0] * dims[1]);
+            const double spacing = m_Watershed->m_Spacing[m_Axis];
+            const double infinity = std::numeric_limits<float>::max();
+            std::vector<double> line(length);
+            std::vector<size_t> vertices(length);
+            std::vector<double> bounds(length);
+            for(size_t l = range.min(); l < range.max(); l++)
+            {
+              size_t start = 0;
+              switch(m_Axis)
+              {
+                case 0: start = l * dims[0]; break;
+                case 1: start = (l % dims[0]) + (l / dims[0]) * dims[0] * dims[1]; break;
+                default: start = l; break;
+              }
+              for(size_t i = 0; i < length; i++)
+              {
+                line[i] = m_Distance[start + i * stride];
+              }
+
+              //lower envelope of the parabolas rooted at the finite samples
+              size_t count = 0;
+              for(size_t q = 0; q < length; q++)
+              {
+                if(line[q] >= infinity)
+                {
+                  continue;
+                }
+                const double position = q * spacing;
+                double bound = std::numeric_limits<double>::lowest();
+                while(count > 0)
+                {
+                  const double vertex = vertices[count - 1] * spacing;
+                  bound = ((line[q] + position * position) - (line[vertices[count - 1]] + vertex * vertex)) / (2.0 * (position - vertex));
+                  if(bound > bounds[count - 1])
+                  {
+                    break;
+                  }
+                  count--;
+                  bound = std::numeric_limits<double>::lowest();
+                }
+                vertices[count] = q;
+                bounds[count] = bound;
+                count++;
+              }
+              if(0 == count)
+              {
+                continue;
+              }
+
+              size_t k = 0;
+              for(size_t q = 0; q < length; q++)
+              {
+                const double position = q * spacing;
+                while(k + 1 < count && bounds[k + 1] < position)
+                {
+                  k++;
+                }
+                const double offset = position - vertices[k] * spacing;
+                m_Distance[start + q * stride] = static_cast<float>(std::min(infinity, offset * offset + line[vertices[k]]));
+              }
+            }
+          }
+        private:
+          const BinaryWatershed* m_Watershed;
+          float* m_Distance;
+          size_t m_Axis;
+      };
+
+      //segments a range of blocks, or (once offsets are known) shifts their core labels to be globally unique
+      class BlockImpl
+      {
+        public:
+          BlockImpl(const BinaryWatershed* watershed, float noiseTolerance, uint32_t* labels, std::vector<size_t>* seeds, const uint32_t* offsets) :
+            m_Watershed(watershed),
+            m_NoiseTolerance(noiseTolerance),
+            m_Labels(labels),
+            m_Seeds(seeds),
+            m_Offsets(offsets)
+          {
+          }
+
+          void operator()(const SIMPLRange& range) const
+          {
+            for(size_t b = range.min(); b < range.max(); b++)
+            {
+              if(nullptr == m_Offsets)
+              {
+                m_Watershed->floodBlock(b, m_NoiseTolerance, m_Labels, m_Seeds[b]);
+              }
+              else
+              {
+                m_Watershed->offsetBlock(b, m_Offsets[b], m_Labels);
+              }
+            }
+          }
+
+        private:
+          const BinaryWatershed* m_Watershed;
+          float m_NoiseTolerance;
+          uint32_t* m_Labels;
+          std::vector<size_t>* m_Seeds;
+          const uint32_t* m_Offsets;
+      };
+
+      class RelabelImpl
+      {
+        public:
+          RelabelImpl(uint32_t* labels, const uint32_t* features) : m_Labels(labels), m_Features(features) {}
+          void operator()(const SIMPLRange& range) const
+          {
+            for(size_t i = range.min(); i < range.max(); i++)
+            {
+              m_Labels[i] = m_Features[m_Labels[i]];
+            }
+          }
+        private:
+          uint32_t* m_Labels;
+          const uint32_t* m_Features;
+      };
+
+      static uint32_t findRoot(std::vector<uint32_t>& parent, uint32_t i)
+      {
+        while(parent[i] != i)
+        {
+          parent[i] = parent[parent[i]];
+          i = parent[i];
+        }
+        return i;
+      }
+
+      //voxel range [start, end) of a block grown by 'pad' voxels on every side (clipped to the volume)
+      void blockBounds(size_t block, size_t pad, size_t start[3], size_t end[3]) const
+      {
+        const size_t coords[3] = {block % m_Blocks[0], (block / m_Blocks[0]) % m_Blocks[1], block / (m_Blocks[0] * m_Blocks[1])};
+        for(size_t d = 0; d < 3; d++)
+        {
+          const size_t coreStart = coords[d] * m_BlockSize;
+          const size_t coreEnd = std::min(m_Dims[d], coreStart + m_BlockSize);
+          start[d] = coreStart > pad ? coreStart - pad : 0;
+          end[d] = std::min(m_Dims[d], coreEnd + pad);
+        }
+      }
+
+      //segments a padded block on its own, writes the labels of its core voxels and returns its seeds (as volume indices)
+      void floodBlock(size_t block, float noiseTolerance, uint32_t* labels, std::vector<size_t>& seeds) const
+      {
+        typedef itk::Image<float, 3> DistanceImageType;
+        size_t start[3];
+        size_t end[3];
+        size_t coreStart[3];
+        size_t coreEnd[3];
+        blockBounds(block, m_Halo, start, end);
+        blockBounds(block, 0, coreStart, coreEnd);
+        const size_t dims[3] = {end[0] - start[0], end[1] - start[1], end[2] - start[2]};
+        const size_t numVoxels = dims[0] * dims[1] * dims[2];
+
+        //copy out the padded mask
+        std::unique_ptr<bool[]> mask(new bool[numVoxels]);
+        for(size_t z = 0; z < dims[2]; z++)
+        {
+          for(size_t y = 0; y < dims[1]; y++)
+          {
+            const bool* row = m_Mask + ((z + start[2]) * m_Dims[1] + y + start[1]) * m_Dims[0] + start[0];
+            std::copy(row, row + dims[0], mask.get() + (z * dims[1] + y) * dims[0]);
+          }
+        }
+
+        //distance map straight into an itk image for the peak search
+        DistanceImageType::Pointer distance = DistanceImageType::New();
+        DistanceImageType::SizeType size;
+        for(size_t d = 0; d < 3; d++)
+        {
+          size[d] = dims[d];
+        }
+        DistanceImageType::RegionType region;
+        region.SetSize(size);
+        distance->SetRegions(region);
+        distance->Allocate();
+        BinaryWatershed watershed(mask.get(), dims, m_Spacing);
+        watershed.distanceMap(distance->GetBufferPointer());
+        std::vector<DistanceImageType::IndexType> peaks = LocalMaxima<DistanceImageType>::Find(distance, noiseTolerance, true);
+
+        std::vector<uint32_t> blockLabels(numVoxels, 0);
+        seeds.clear();
+        for(size_t i = 0; i < peaks.size(); i++)
+        {
+          const size_t coords[3] = {static_cast<size_t>(peaks[i][0]), static_cast<size_t>(peaks[i][1]), static_cast<size_t>(peaks[i][2])};
+          blockLabels[(coords[2] * dims[1] + coords[1]) * dims[0] + coords[0]] = static_cast<uint32_t>(i + 1);
+          seeds.push_back(((coords[2] + start[2]) * m_Dims[1] + coords[1] + start[1]) * m_Dims[0] + coords[0] + start[0]);
+        }
+        watershed.flood(distance->GetBufferPointer(), blockLabels.data());
+
+        for(size_t z = coreStart[2]; z < coreEnd[2]; z++)
+        {
+          for(size_t y = coreStart[1]; y < coreEnd[1]; y++)
+          {
+            const uint32_t* row = blockLabels.data() + ((z - start[2]) * dims[1] + y - start[1]) * dims[0] + coreStart[0] - start[0];
+            std::copy(row, row + coreEnd[0] - coreStart[0], labels + (z * m_Dims[1] + y) * m_Dims[0] + coreStart[0]);
+          }
+        }
+      }
+
+      void offsetBlock(size_t block, uint32_t offset, uint32_t* labels) const
+      {
+        size_t start[3];
+        size_t end[3];
+        blockBounds(block, 0, start, end);
+        for(size_t z = start[2]; z < end[2]; z++)
+        {
+          for(size_t y = start[1]; y < end[1]; y++)
+          {
+            uint32_t* row = labels + (z * m_Dims[1] + y) * m_Dims[0];
+            for(size_t x = start[0]; x < end[0]; x++)
+            {
+              if(0 != row[x])
+              {
+                row[x] += offset;
+              }
+            }
+          }
+        }
+      }
+
+      //squared distance -> distance in the foreground, lowest value in the background
+      class FinishImpl
+      {
+        public:
+          FinishImpl(const BinaryWatershed* watershed, float* distance) : m_Watershed(watershed), m_Distance(distance) {}
+          void operator()(const SIMPLRange& range) const
+          {
+            for(size_t i = range.min(); i < range.max(); i++)
+            {
+              m_Distance[i] = m_Watershed->m_Mask[i] ? std::sqrt(m_Distance[i]) : std::numeric_limits<float>::lowest();
+            }
+          }
+        private:
+          const BinaryWatershed* m_Watershed;
+          float* m_Distance;
+      };
+
+      const bool* m_Mask;
+      size_t m_Dims[3];
+      float m_Spacing[3];
+      size_t m_NumVoxels;
+      size_t m_Blocks[3] = {1, 1, 1};
+      size_t m_BlockSize = 0;
+      size_t m_Halo = 0;
+  };
+
+
+  //maps an array onto 0-255 through a parallel min / max reduction (and, when percentiles are requested, a histogram of
+  //the values between them) followed by a single multiply-add pass. the range is cut into 256 equal width intervals,
+  //values outside of it are clamped and non finite values are ignored by the search (NaN maps to 0)
+  template< typename T >
+  class ByteScaler
+  {
+    public:
+      ByteScaler(const T* data, size_t count, bool parallel = true) :
+        m_Data(data),
+        m_Count(count),
+        m_Parallel(parallel)
+      {
+        m_NumChunks = m_Parallel ? std::max<size_t>(1, 2 * std::thread::hardware_concurrency()) : 1;
+        m_NumChunks = std::min(m_NumChunks, std::max<size_t>(1, m_Count / 4096));//at least 4096 values per chunk
+      }
+
+      //finds the values at the lower and upper percentiles, 0 and 100 give the exact extrema without a histogram.
+      //returns false if the array holds no finite values
+      bool findRange(double lowerPercentile = 0.0, double upperPercentile = 100.0)
+      {
+        std::vector<double> chunkMin(m_NumChunks, std::numeric_limits<double>::max());
+        std::vector<double> chunkMax(m_NumChunks, std::numeric_limits<double>::lowest());
+        std::vector<size_t> chunkCount(m_NumChunks, 0);
+        ParallelDataAlgorithm dataAlg;
+        dataAlg.setParallelizationEnabled(m_Parallel);
+        dataAlg.setRange(0, m_NumChunks);
+        dataAlg.execute(MinMaxImpl(this, chunkMin.data(), chunkMax.data(), chunkCount.data()));
+
+        m_Lower = std::numeric_limits<double>::max();
+        m_Upper = std::numeric_limits<double>::lowest();
+        size_t numValid = 0;
+        for(size_t i = 0; i < m_NumChunks; i++)
+        {
+          m_Lower = std::min(m_Lower, chunkMin[i]);
+          m_Upper = std::max(m_Upper, chunkMax[i]);
+          numValid += chunkCount[i];
+        }
+        if(0 == numValid)
+        {
+          m_Lower = m_Upper = 0.0;
+          return false;
+        }
+        if((lowerPercentile <= 0.0 && upperPercentile >= 100.0) || m_Upper <= m_Lower)
+        {
+          return true;
+        }
+
+        //integer data with a small span gets one bin per value so its percentiles are exact
+        const double span = m_Upper - m_Lower;
+        const bool exact = std::numeric_limits<T>::is_integer && span < k_HistogramBins;
+        const size_t numBins = exact ? static_cast<size_t>(span) + 1 : k_HistogramBins;
+        const double binWidth = exact ? 1.0 : span / numBins;
+        std::vector<size_t> histograms(m_NumChunks * numBins, 0);
+        dataAlg.execute(HistogramImpl(this, numBins, 1.0 / binWidth, histograms.data()));
+        for(size_t i = 1; i < m_NumChunks; i++)
+        {
+          const size_t* chunkHistogram = histograms.data() + i * numBins;
+          for(size_t j = 0; j < numBins; j++)
+          {
+            histograms[j] += chunkHistogram[j];
+          }
+        }
+
+        //lower bound is the left edge of the bin holding the lower percentile, upper bound the right edge of the bin
+        //that completes the upper percentile
+        const double lowerCount = std::max(0.0, lowerPercentile) / 100.0 * numValid;
+        const double upperCount = std::min(100.0, upperPercentile) / 100.0 * numValid;
+        size_t lowerBin = 0;
+        size_t upperBin = numBins - 1;
+        size_t cumulative = 0;
+        bool lowerFound = false;
+        for(size_t j = 0; j < numBins; j++)
+        {
+          cumulative += histograms[j];
+          if(!lowerFound && cumulative > lowerCount)
+          {
+            lowerBin = j;
+            lowerFound = true;
+          }
+          if(cumulative >= upperCount)
+          {
+            upperBin = j;
+            break;
+          }
+        }
+        const double minimum = m_Lower;
+        m_Lower = minimum + lowerBin * binWidth;
+        m_Upper = exact ? minimum + upperBin : std::min(m_Upper, minimum + (upperBin + 1) * binWidth);
+        m_Upper = std::max(m_Upper, m_Lower);
+        return true;
+      }
+
+      //writes the scaled values, the range from findRange() is used unless one is set explicitly
+      void scale(uint8_t* output) const
+      {
+        ParallelDataAlgorithm dataAlg;
+        dataAlg.setParallelizationEnabled(m_Parallel);
+        dataAlg.setRange(0, m_Count);
+        dataAlg.execute(ScaleImpl(this, output));
+      }
+
+      void setRange(double lower, double upper)
+      {
+        m_Lower = lower;
+        m_Upper = upper;
+      }
+
+      double getLower() const
+      {
+        return m_Lower;
+      }
+
+      double getUpper() const
+      {
+        return m_Upper;
+      }
+
+    private:
+      static const size_t k_HistogramBins = 65536;
+
+      void chunkBounds(size_t chunk, size_t& start, size_t& end) const
+      {
+        start = m_Count * chunk / m_NumChunks;
+        end = m_Count * (chunk + 1) / m_NumChunks;
+      }
+
+      class MinMaxImpl
+      {
+        public:
+          MinMaxImpl(const ByteScaler* scaler, double* chunkMin, double* chunkMax, size_t* chunkCount) :
+            m_Scaler(scaler),
+            m_ChunkMin(chunkMin),
+            m_ChunkMax(chunkMax),
+            m_ChunkCount(chunkCount)
+          {
+          }
+          void operator()(const SIMPLRange& range) const
+          {
+            for(size_t chunk = range.min(); chunk < range.max(); chunk++)
+            {
+              size_t start = 0;
+              size_t end = 0;
+              m_Scaler->chunkBounds(chunk, start, end);
+              double minimum = std::numeric_limits<double>::max();
+              double maximum = std::numeric_limits<double>::lowest();
+              size_t count = 0;
+              for(size_t i = start; i < end; i++)
+              {
+                const double value = static_cast<double>(m_Scaler->m_Data[i]);
+                if(std::isfinite(value))
+                {
+                  minimum = std::min(minimum, value);
+                  maximum = std::max(maximum, value);
+                  count++;
+                }
+              }
+              m_ChunkMin[chunk] = minimum;
+              m_ChunkMax[chunk] = maximum;
+              m_ChunkCount[chunk] = count;
+            }
+          }
+        private:
+          const ByteScaler* m_Scaler;
+          double* m_ChunkMin;
+          double* m_ChunkMax;
+          size_t* m_ChunkCount;
+      };
+
+      class HistogramImpl
+      {
+        public:
+          HistogramImpl(const ByteScaler* scaler, size_t numBins, double binsPerUnit, size_t* histograms) :
+            m_Scaler(scaler),
+            m_NumBins(numBins),
+            m_BinsPerUnit(binsPerUnit),
+            m_Histograms(histograms)
+          {
+          }
+          void operator()(const SIMPLRange& range) const
+          {
+            const double minimum = m_Scaler->m_Lower;
+            const double maximum = m_Scaler->m_Upper;
+            for(size_t chunk = range.min(); chunk < range.max(); chunk++)
+            {
+              size_t start = 0;
+              size_t end = 0;
+              m_Scaler->chunkBounds(chunk, start, end);
+              size_t* histogram = m_Histograms + chunk * m_NumBins;
+              for(size_t i = start; i < end; i++)
+              {
+                const double value = static_cast<double>(m_Scaler->m_Data[i]);
+                if(value >= minimum && value <= maximum)//also rejects NaN, infinities are outside of the finite extrema
+                {
+                  histogram[std::min(m_NumBins - 1, static_cast<size_t>((value - minimum) * m_BinsPerUnit))]++;
+                }
+              }
+            }
+          }
+        private:
+          const ByteScaler* m_Scaler;
+          size_t m_NumBins;
+          double m_BinsPerUnit;
+          size_t* m_Histograms;
+      };
+
+      class ScaleImpl
+      {
+        public:
+          ScaleImpl(const ByteScaler* scaler, uint8_t* output) :
+            m_Scaler(scaler),
+            m_Output(output)
+          {
+          }
+          void operator()(const SIMPLRange& range) const
+          {
+            //the factor is rounded up so values on an interval boundary don't fall one short. an empty range becomes a
+            //threshold: (value - lower) * inf is -inf, NaN (0 * inf) or inf
+            const double lower = m_Scaler->m_Lower;
+            const double infinity = std::numeric_limits<double>::infinity();
+            const double factor = m_Scaler->m_Upper > lower ? std::nextafter(256.0 / (m_Scaler->m_Upper - lower), infinity) : infinity;
+            const T* data = m_Scaler->m_Data;
+            for(size_t i = range.min(); i < range.max(); i++)
+            {
+              const double scaled = (static_cast<double>(data[i]) - lower) * factor;
+              m_Output[i] = scaled >= 255.0 ? 255 : (scaled > 0.0 ? static_cast<uint8_t>(scaled) : 0);
+            }
+          }
+        private:
+          const ByteScaler* m_Scaler;
+          uint8_t* m_Output;
+      };
+
+      const T* m_Data;
+      size_t m_Count;
+      bool m_Parallel;
+      size_t m_NumChunks;
+      double m_Lower = 0.0;
+      double m_Upper = 0.0;
+  };
+
+
   namespace Functor
   {
     //gamma functor (doesn't seem to be implemented in itk)